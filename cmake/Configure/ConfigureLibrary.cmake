@@ -22,6 +22,9 @@ target_link_libraries(${LIBRARY_NAME} PUBLIC ${Libint2_LIBRARIES})
 # Include Spectra
 target_include_directories(${LIBRARY_NAME} PRIVATE ${Spectra_INCLUDE_DIRS})
 
+# Link the threading library
+target_link_libraries(${LIBRARY_NAME} PUBLIC ${CMAKE_THREAD_LIBS_INIT})
+
 # Include MKL
 if (USE_MKL)
     target_include_directories(${LIBRARY_NAME} PUBLIC ${MKL_INCLUDE_DIRS})
@@ -48,7 +48,9 @@ set(PROJECT_INCLUDE_FILES
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/Hubbard.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/SelectedCI.hpp
 
+        ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/AOIntegralCache.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/BaseHamiltonianParameters.hpp
+        ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/FCIDUMP.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/HamiltonianParameters.hpp
 
         ${PROJECT_INCLUDE_FOLDER}/Localization/BaseERLocalizer.hpp
@@ -60,9 +62,12 @@ set(PROJECT_INCLUDE_FILES
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/BaseMinimizer.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/BaseSystemOfEquationsSolver.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/DavidsonSolver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/math/optimization/DavidsonSubspace.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/DenseSolver.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/Eigenpair.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/EigenproblemSolverOptions.hpp
+        ${PROJECT_INCLUDE_FOLDER}/math/optimization/IterativeLinearSolver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/math/optimization/LimitedMemoryBFGS.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/NewtonMinimizer.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/NewtonSystemOfEquationsSolver.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/optimization/SparseSolver.hpp
@@ -75,8 +80,16 @@ set(PROJECT_INCLUDE_FILES
         ${PROJECT_INCLUDE_FOLDER}/math/SquareRankFourTensor.hpp
         ${PROJECT_INCLUDE_FOLDER}/math/Tensor.hpp
 
+        ${PROJECT_INCLUDE_FOLDER}/Observer/BaseIterationObserver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/Observer/IterationHistory.hpp
+        ${PROJECT_INCLUDE_FOLDER}/Observer/IterationRecord.hpp
+        ${PROJECT_INCLUDE_FOLDER}/Observer/JSONLinesObserver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/Observer/ObservableSolver.hpp
+
+        ${PROJECT_INCLUDE_FOLDER}/Operator/FactorizedTwoElectronOperator.hpp
         ${PROJECT_INCLUDE_FOLDER}/Operator/OneElectronOperator.hpp
         ${PROJECT_INCLUDE_FOLDER}/Operator/Operator.hpp
+        ${PROJECT_INCLUDE_FOLDER}/Operator/PackedTwoElectronOperator.hpp
         ${PROJECT_INCLUDE_FOLDER}/Operator/TwoElectronOperator.hpp
 
         ${PROJECT_INCLUDE_FOLDER}/properties/expectation_values.hpp
@@ -44,7 +44,9 @@ set(PROJECT_SOURCE_FILES
         ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/Hubbard.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/SelectedCI.cpp
 
+        ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/AOIntegralCache.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/BaseHamiltonianParameters.cpp
+        ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/FCIDUMP.cpp
 
         ${PROJECT_SOURCE_FOLDER}/Localization/BaseERLocalizer.cpp
         ${PROJECT_SOURCE_FOLDER}/Localization/ERJacobiLocalizer.cpp
@@ -55,13 +57,23 @@ set(PROJECT_SOURCE_FILES
         ${PROJECT_SOURCE_FOLDER}/math/optimization/BaseMinimizer.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/BaseSystemOfEquationsSolver.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/DavidsonSolver.cpp
+        ${PROJECT_SOURCE_FOLDER}/math/optimization/DavidsonSubspace.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/DenseSolver.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/Eigenpair.cpp
+        ${PROJECT_SOURCE_FOLDER}/math/optimization/IterativeLinearSolver.cpp
+        ${PROJECT_SOURCE_FOLDER}/math/optimization/LimitedMemoryBFGS.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/NewtonMinimizer.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/NewtonSystemOfEquationsSolver.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/SparseSolver.cpp
         ${PROJECT_SOURCE_FOLDER}/math/optimization/step.cpp
 
+        ${PROJECT_SOURCE_FOLDER}/Observer/IterationHistory.cpp
+        ${PROJECT_SOURCE_FOLDER}/Observer/JSONLinesObserver.cpp
+        ${PROJECT_SOURCE_FOLDER}/Observer/ObservableSolver.cpp
+
+        ${PROJECT_SOURCE_FOLDER}/Operator/FactorizedTwoElectronOperator.cpp
+        ${PROJECT_SOURCE_FOLDER}/Operator/PackedTwoElectronOperator.cpp
+
         ${PROJECT_SOURCE_FOLDER}/properties/expectation_values.cpp
         ${PROJECT_SOURCE_FOLDER}/properties/properties.cpp
 
@@ -42,17 +42,23 @@ set(PROJECT_TEST_SOURCE_FILES
         ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/Hubbard_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/SelectedCI_test.cpp
 
+        ${PROJECT_TESTS_FOLDER}/HamiltonianParameters/AOIntegralCache_test.cpp
+        ${PROJECT_TESTS_FOLDER}/HamiltonianParameters/FCIDUMP_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianParameters/HamiltonianParameters_test.cpp
 
         ${PROJECT_TESTS_FOLDER}/Localization/ERJacobiLocalizer_test.cpp
         ${PROJECT_TESTS_FOLDER}/Localization/ERNewtonLocalizer_test.cpp
 
         ${PROJECT_TESTS_FOLDER}/math/optimization/DavidsonSolver_test.cpp
+        ${PROJECT_TESTS_FOLDER}/math/optimization/DavidsonSubspace_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/optimization/DenseSolver_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/optimization/Eigenpair_test.cpp
+        ${PROJECT_TESTS_FOLDER}/math/optimization/IterativeLinearSolver_test.cpp
+        ${PROJECT_TESTS_FOLDER}/math/optimization/LimitedMemoryBFGS_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/optimization/NewtonMinimizer_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/optimization/NewtonSystemOfEquationsSolver_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/optimization/SparseSolver_test.cpp
+        ${PROJECT_TESTS_FOLDER}/math/optimization/step_test.cpp
 
         ${PROJECT_TESTS_FOLDER}/math/Matrix_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/ScalarFunction_test.cpp
@@ -60,7 +66,11 @@ set(PROJECT_TEST_SOURCE_FILES
         ${PROJECT_TESTS_FOLDER}/math/SquareRankFourTensor_test.cpp
         ${PROJECT_TESTS_FOLDER}/math/Tensor_test.cpp
 
+        ${PROJECT_TESTS_FOLDER}/Observer/JSONLinesObserver_test.cpp
+
+        ${PROJECT_TESTS_FOLDER}/Operator/FactorizedTwoElectronOperator_test.cpp
         ${PROJECT_TESTS_FOLDER}/Operator/OneElectronOperator_test.cpp
+        ${PROJECT_TESTS_FOLDER}/Operator/PackedTwoElectronOperator_test.cpp
         ${PROJECT_TESTS_FOLDER}/Operator/TwoElectronOperator_test.cpp
 
         ${PROJECT_TESTS_FOLDER}/properties/expectation_values_test.cpp
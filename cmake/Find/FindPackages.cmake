@@ -6,6 +6,7 @@ find_package(Boost REQUIRED COMPONENTS program_options)
 find_package(Eigen3 3.3.4 REQUIRED)
 find_package(Libint2 REQUIRED)
 find_package(Spectra REQUIRED)
+find_package(Threads REQUIRED)
 
 if (BUILD_DOCS)
     find_package(Doxygen REQUIRED dot)
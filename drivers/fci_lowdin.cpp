@@ -9,6 +9,7 @@
 #include <boost/program_options.hpp>
 
 
+#include "HamiltonianParameters/AOIntegralCache.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 #include "CISolver/CISolver.hpp"
 #include "HamiltonianBuilder/FCI.hpp"
@@ -24,6 +25,7 @@ int main (int argc, char** argv) {
     std::string basisset;
     size_t N_alpha;
     size_t N_beta;
+    std::string integral_cache_directory;
 
     namespace po = boost::program_options;
     po::variables_map variables_map;
@@ -34,7 +36,8 @@ int main (int argc, char** argv) {
         ("input,f", po::value<std::string>(&input_xyz_file)->required(), "filename of the .xyz-file")
         ("N_alpha,a", po::value<size_t>(&N_alpha)->required(), "number of alpha electrons")
         ("N_beta,b", po::value<size_t>(&N_beta)->required(), "number of beta electrons")
-        ("basis,s", po::value<std::string>(&basisset)->required(), "name of the basis set");
+        ("basis,s", po::value<std::string>(&basisset)->required(), "name of the basis set")
+        ("cache,c", po::value<std::string>(&integral_cache_directory), "a directory in which the AO integrals are stored, so that they are only calculated once for the same molecule and basis set");
 
 
         po::store(po::parse_command_line(argc, argv, desc), variables_map);
@@ -56,7 +59,7 @@ int main (int argc, char** argv) {
     // Actual calculations
     // Prepare molecular Hamiltonian parameters in the Löwdin basis
     auto molecule = GQCP::Molecule::Readxyz(input_xyz_file);
-    auto mol_ham_par = GQCP::HamiltonianParameters<double>::Molecular(molecule, basisset);  // in the AO basis
+    auto mol_ham_par = integral_cache_directory.empty() ? GQCP::HamiltonianParameters<double>::Molecular(molecule, basisset) : GQCP::AOIntegralCache(integral_cache_directory).molecularHamiltonianParameters(molecule, basisset);  // in the AO basis
     mol_ham_par.LowdinOrthonormalize();  // now in the Löwdin basis
 
 
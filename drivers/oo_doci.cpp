@@ -12,6 +12,7 @@
 #include <boost/program_options.hpp>
 
 
+#include "HamiltonianParameters/AOIntegralCache.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 #include "RHF/DIISRHFSCFSolver.hpp"
 #include "CISolver/CISolver.hpp"
@@ -30,6 +31,7 @@ int main (int argc, char** argv) {
     std::string basisset;
     bool user_wants_localization = false;
     bool user_wants_davidson = false;
+    std::string integral_cache_directory;
 
     namespace po = boost::program_options;
     po::variables_map variables_map;
@@ -40,7 +42,8 @@ int main (int argc, char** argv) {
         ("input,f", po::value<std::string>(&input_xyz_file)->required(), "filename of the .xyz-file")
         ("basis,b", po::value<std::string>(&basisset)->required(), "name of the basis set")
         ("solver,s", po::bool_switch(&user_wants_davidson)->required(), "if the Davidson diagonalization algorithm should be used")
-        ("localize,l", po::bool_switch(&user_wants_localization), "if the RHF orbitals should be localized using the ER-localization");
+        ("localize,l", po::bool_switch(&user_wants_localization), "if the RHF orbitals should be localized using the ER-localization")
+        ("cache,c", po::value<std::string>(&integral_cache_directory), "a directory in which the AO integrals are stored, so that they are only calculated once for the same molecule and basis set");
 
         po::store(po::parse_command_line(argc, argv, desc), variables_map);
 
@@ -76,7 +79,7 @@ int main (int argc, char** argv) {
 
 
     output_file << "Basisset: " << basisset << std::endl << std::endl;
-    auto ao_mol_ham_par = GQCP::HamiltonianParameters<double>::Molecular(molecule, basisset);
+    auto ao_mol_ham_par = integral_cache_directory.empty() ? GQCP::HamiltonianParameters<double>::Molecular(molecule, basisset) : GQCP::AOIntegralCache(integral_cache_directory).molecularHamiltonianParameters(molecule, basisset);
     size_t K = ao_mol_ham_par.get_K();
 
 
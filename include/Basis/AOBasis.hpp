@@ -20,20 +20,43 @@
 
 
 #include "Basis/ShellSet.hpp"
+#include "math/SquareMatrix.hpp"
+#include "Operator/FactorizedTwoElectronOperator.hpp"
 #include "Operator/OneElectronOperator.hpp"
+#include "Operator/PackedTwoElectronOperator.hpp"
 #include "Operator/TwoElectronOperator.hpp"
 
+#include <memory>
+
+
+namespace libint2 {
+struct BasisSet;
+}  // namespace libint2
+
 
 namespace GQCP {
 
 
 /**
  *  A class that represents an atomic orbital basis: it represents a collection of (scalar) atomic orbitals/basis functions
+ *
+ *  Note that an AO basis isn't thread-safe: its const methods fill the (mutable) caches below without any synchronization, so one AO basis shouldn't be used by several threads at the same time. The integral calculations themselves are parallelized internally.
  */
 class AOBasis {
 private:
     ShellSet shell_set;  // the underlying collection of shells
 
+    mutable SquareMatrix<double> schwarz_bounds;  // the Schwarz bounds for every pair of shells, calculated when they are first needed
+    mutable size_t number_of_skipped_quartets = 0;  // the number of shell quartets that were skipped by the screening in the last calculation of the two-electron integrals
+    mutable std::shared_ptr<const libint2::BasisSet> libint_basisset;  // the libint2 representation of the shell set, created when it is first needed
+
+
+    // PRIVATE METHODS
+    /**
+     *  @return the libint2 representation of the underlying shell set, which is only created once for this AO basis (and its copies)
+     */
+    const libint2::BasisSet& get_libint_basisset() const;
+
 
 public:
     // CONSTRUCTORS
@@ -55,6 +78,7 @@ public:
 
     // GETTERS
     const ShellSet& get_shell_set() const { return this->shell_set; }
+    size_t get_number_of_skipped_quartets() const { return this->number_of_skipped_quartets; }
 
 
     // PUBLIC METHODS
@@ -63,6 +87,11 @@ public:
      */
     size_t numberOfBasisFunctions() const;
 
+    /**
+     *  @return the (nsh x nsh)-matrix of the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells a and b, which are only calculated once for this AO basis
+     */
+    const SquareMatrix<double>& get_schwarz_bounds() const;
+
 
     // PUBLIC METHODS - INTEGRALS
     /**
@@ -88,9 +117,63 @@ public:
     std::array<OneElectronOperator<double>, 3> calculateDipoleIntegrals(const Vector<double, 3>& origin = Vector<double, 3>::Zero()) const;
 
     /**
+     *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+     *
+     *  @return the matrix representations of the overlap, kinetic energy and nuclear attraction operators in this AO basis (in that order), calculated in one sweep over the unique shell pairs
+     */
+    std::array<OneElectronOperator<double>, 3> calculateOneElectronIntegrals(size_t number_of_threads = 0) const;
+
+    /**
+     *  @param origin                   the origin of the dipole
+     *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+     *
+     *  @return the matrix representations of the overlap, kinetic energy and nuclear attraction operators and the Cartesian components of the electrical dipole operator in this AO basis (in that order), calculated in one sweep over the unique shell pairs
+     */
+    std::array<OneElectronOperator<double>, 6> calculateOneElectronAndDipoleIntegrals(const Vector<double, 3>& origin = Vector<double, 3>::Zero(), size_t number_of_threads = 0) const;
+
+    /**
+     *  @param screening_threshold      the threshold on the product of the Schwarz bounds of two shell pairs, below which their shell quartet isn't computed. A zero threshold (the default) disables the screening.
+     *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+     *
      *  @return the matrix representation of the Coulomb repulsion operator in this AO basis
+     *
+     *  The number of skipped shell quartets can be retrieved afterwards with get_number_of_skipped_quartets()
+     */
+    TwoElectronOperator<double> calculateCoulombRepulsionIntegrals(double screening_threshold = 0.0, size_t number_of_threads = 0) const;
+
+    /**
+     *  @param screening_threshold      the threshold on the product of the Schwarz bounds of two shell pairs, below which their shell quartet isn't computed. A zero threshold (the default) disables the screening.
+     *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+     *
+     *  @return the eight-fold packed representation of the Coulomb repulsion operator in this AO basis, which only takes an eighth of the memory of the dense representation
+     */
+    PackedTwoElectronOperator calculatePackedCoulombRepulsionIntegrals(double screening_threshold = 0.0, size_t number_of_threads = 0) const;
+
+    /**
+     *  @param auxiliary_basis          the auxiliary basis in which the orbital products are fitted, e.g. a (def2-universal-)JKFIT or RIFIT basis on the same molecule
+     *  @param eigenvalue_threshold     the threshold on the eigenvalues of the two-center integrals of the auxiliary basis below which the corresponding linear combinations of auxiliary functions are discarded
+     *
+     *  @return the density-fitted (resolution-of-the-identity) Coulomb repulsion operator in this AO basis, which only stores O(K^2 N_aux) values
+     */
+    FactorizedTwoElectronOperator calculateDensityFittedCoulombRepulsionIntegrals(const AOBasis& auxiliary_basis, double eigenvalue_threshold = 1.0e-10) const;
+
+    /**
+     *  @param tolerance        the tolerance on the largest remaining diagonal element of the decomposition, which bounds the error on every reconstructed integral
+     *
+     *  @return the pivoted Cholesky decomposition of the Coulomb repulsion operator in this AO basis, calculated from the diagonal shell quartets and the columns of the pivots, so that the full K^4 tensor is never formed
+     */
+    FactorizedTwoElectronOperator calculateCholeskyCoulombRepulsionIntegrals(double tolerance = 1.0e-08) const;
+
+    /**
+     *  @param D_AO                     the RHF density matrix in this AO basis
+     *  @param screening_threshold      the threshold on the product of the Schwarz bounds of two shell pairs and the largest density matrix element they are contracted with, below which their shell quartet isn't computed. A zero threshold (the default) disables the screening.
+     *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+     *
+     *  @return the two-electron part G = J - 1/2 K of the RHF Fock matrix, calculated integral-direct so that only O(K^2) memory is needed
+     *
+     *  The number of skipped shell quartets can be retrieved afterwards with get_number_of_skipped_quartets()
      */
-    TwoElectronOperator<double> calculateCoulombRepulsionIntegrals() const;
+    SquareMatrix<double> calculateDirectRHFTwoElectronMatrix(const SquareMatrix<double>& D_AO, double screening_threshold = 0.0, size_t number_of_threads = 0) const;
 };
 
 
@@ -20,8 +20,10 @@
 
 
 #include "Basis/AOBasis.hpp"
+#include "math/SquareMatrix.hpp"
 #include "Molecule.hpp"
 #include "Operator/OneElectronOperator.hpp"
+#include "Operator/PackedTwoElectronOperator.hpp"
 #include "Operator/TwoElectronOperator.hpp"
 
 #include <boost/preprocessor.hpp>  // include preprocessor before libint to fix libint-boost bug
@@ -50,6 +52,24 @@ private:
     ~LibintInterfacer();
 
 
+    // PRIVATE METHODS - INTEGRALS
+    /**
+     *  Calculate the canonical shell quartets (sh1 >= sh2, sh3 >= sh4, (sh1 sh2) >= (sh3 sh4)) of a two-electron operator on multiple threads
+     *
+     *  @param operator_type                    the name of the operator as specified by the enumeration
+     *  @param libint_basisset                  the libint2 basis set representing the AO basis
+     *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+     *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs, below which a shell quartet isn't computed
+     *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+     *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine
+     *  @param store_integral                   the callable (p, q, r, s, value) that stores an integral (pq|rs) together with its symmetry-related integrals
+     *
+     *  Every stored integral belongs to exactly one canonical shell quartet, so store_integral may be called concurrently as long as it doesn't write to the storage of other integrals
+     */
+    template <typename StoreIntegral>
+    void calculateCanonicalTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads, const StoreIntegral& store_integral) const;
+
+
     // PRIVATE STRUCTS
     typedef struct {} empty;  // empty_pod is a private typedef for libint2::Engine, so we copy it over
 
@@ -209,6 +229,18 @@ public:
     }
 
 
+    /**
+     *  Calculate the matrix representations of several one-electron operators in one sweep over the unique shell pairs sh1 >= sh2, so that the shell pair loop is shared by all the operators and the (sh2, sh1)-blocks are filled in by symmetry
+     *
+     *  @param operators            the names of the operators as specified by the enumeration, together with the parameters for their integral engines (as specified by libint2)
+     *  @param libint_basisset      the libint2 basis set representing the AO basis
+     *  @param number_of_threads    the number of threads that calculate the shell pairs, each with their own libint2 engines, or 0 to use all available hardware threads
+     *
+     *  @return the matrix representations of all the components of the given operators, in the order of the operators. Since only the unique shell pairs are calculated, the operators should be symmetric, like the overlap, kinetic, nuclear attraction and multipole operators.
+     */
+    std::vector<OneElectronOperator<double>> calculateSymmetricOneElectronIntegrals(const std::vector<std::pair<libint2::Operator, libint2::any>>& operators, const libint2::BasisSet& libint_basisset, size_t number_of_threads = 1) const;
+
+
     /**
      *  @param operator_type        the name of the operator as specified by the enumeration
      *  @param libint_basisset      the libint2 basis set representing the AO basis
@@ -216,6 +248,88 @@ public:
      *  @return the matrix representation of a two-electron operator in the given AO basis
      */
     TwoElectronOperator<double> calculateTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset) const;
+
+    /**
+     *  @param operator_type                    the name of the operator as specified by the enumeration
+     *  @param libint_basisset                  the libint2 basis set representing the AO basis
+     *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+     *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs, below which a shell quartet isn't computed
+     *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+     *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine
+     *
+     *  @return the matrix representation of a two-electron operator in the given AO basis, in which the integrals of the skipped shell quartets are set to zero
+     */
+    TwoElectronOperator<double> calculateTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads = 1) const;
+
+    /**
+     *  @param operator_type                    the name of the operator as specified by the enumeration
+     *  @param libint_basisset                  the libint2 basis set representing the AO basis
+     *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+     *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs, below which a shell quartet isn't computed
+     *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+     *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine
+     *
+     *  @return the eight-fold packed representation of a two-electron operator in the given AO basis, in which the integrals of the skipped shell quartets are set to zero
+     */
+    PackedTwoElectronOperator calculatePackedTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads = 1) const;
+
+    /**
+     *  Calculate the two-electron part G = J - 1/2 K of the RHF Fock matrix integral-direct, i.e. by contracting every calculated shell quartet with the density matrix and discarding it afterwards
+     *
+     *  @param operator_type                    the name of the operator as specified by the enumeration
+     *  @param libint_basisset                  the libint2 basis set representing the AO basis
+     *  @param D                                the (RHF) density matrix in the AO basis
+     *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+     *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs and the largest density matrix element that the shell quartet is contracted with, below which a shell quartet isn't computed
+     *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+     *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine and Fock matrix contribution
+     *
+     *  @return the two-electron part of the RHF Fock matrix G(p,q) = (pq|rs) D(s,r) - 1/2 (pr|sq) D(r,s)
+     */
+    SquareMatrix<double> calculateDirectRHFTwoElectronMatrix(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& D, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads = 1) const;
+
+    /**
+     *  @param operator_type        the name of the operator as specified by the enumeration
+     *  @param libint_basisset      the libint2 basis set representing the AO basis
+     *
+     *  @return the K^2 diagonal two-electron integrals (pq|pq), in which the compound index pq is p + K q, calculated from the diagonal shell quartets (12|12) only
+     */
+    VectorX<double> calculateTwoElectronDiagonal(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset) const;
+
+    /**
+     *  @param operator_type        the name of the operator as specified by the enumeration
+     *  @param libint_basisset      the libint2 basis set representing the AO basis
+     *  @param sh1                  the index of the first shell
+     *  @param sh2                  the index of the second shell
+     *
+     *  @return the (K^2 x n1 n2)-matrix of the two-electron integrals (rs|ab) for all functions a in shell 1 and b in shell 2, in which the row index is r + K s and the column index is (a - a0) + n1 (b - b0)
+     */
+    MatrixX<double> calculateTwoElectronColumns(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, size_t sh1, size_t sh2) const;
+
+    /**
+     *  @param operator_type                the name of the operator as specified by the enumeration
+     *  @param libint_basisset              the libint2 basis set representing the AO basis
+     *  @param libint_auxiliary_basisset    the libint2 basis set representing the auxiliary basis
+     *
+     *  @return the (K^2 x N_aux)-matrix of the three-center integrals (pq|P), in which the compound index pq is p + K q
+     */
+    MatrixX<double> calculateThreeCenterIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const libint2::BasisSet& libint_auxiliary_basisset) const;
+
+    /**
+     *  @param operator_type                the name of the operator as specified by the enumeration
+     *  @param libint_auxiliary_basisset    the libint2 basis set representing the auxiliary basis
+     *
+     *  @return the (N_aux x N_aux)-matrix of the two-center integrals (P|Q)
+     */
+    SquareMatrix<double> calculateTwoCenterIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_auxiliary_basisset) const;
+
+    /**
+     *  @param operator_type        the name of the operator as specified by the enumeration
+     *  @param libint_basisset      the libint2 basis set representing the AO basis
+     *
+     *  @return the (nsh x nsh)-matrix of the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells a and b, such that |(ab|cd)| <= bound(a,b) * bound(c,d)
+     */
+    SquareMatrix<double> calculateSchwarzBounds(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset) const;
 };
 
 
@@ -54,11 +54,30 @@ public:
     const Eigenpair& get_eigenpair(size_t index = 0) const { return this->eigenpairs[index]; }
 
 
+    // STATIC PUBLIC METHODS
+    /**
+     *  @param hamiltonian_builder          the HamiltonianBuilder whose Fock space spans the CI eigenvalue problem
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal basis
+     *  @param diagonal                     the diagonal of the Hamiltonian matrix, as calculated by the HamiltonianBuilder
+     *  @param number_of_guesses            the number of initial guesses that should be generated
+     *  @param block_dimension              the number of lowest-diagonal configurations that span the block that is diagonalized
+     *  @param degeneracy_threshold         the threshold on the diagonal values below which configurations are considered degenerate
+     *  @param spin_pairing                 if the spin-flipped partners of the selected configurations should be added to the block (only for Ms=0 product Fock spaces)
+     *
+     *  @return the lowest eigenvectors of the Hamiltonian matrix in the space of the configurations with the lowest diagonal values, as columns of a (dim x number_of_guesses)-matrix
+     *
+     *  Degenerate configurations are not split up: the block is extended with the configurations that are degenerate with the last selected one, up to twice the given block dimension
+     */
+    static MatrixX<double> calculateDiagonalGuess(const HamiltonianBuilder& hamiltonian_builder, const HamiltonianParameters<double>& hamiltonian_parameters, const VectorX<double>& diagonal, size_t number_of_guesses, size_t block_dimension = 20, double degeneracy_threshold = 1.0e-06, bool spin_pairing = true);
+
+
     // PUBLIC METHODS
     /**
      *  @param solver_options       specify a type of solver and its options
      *
      *  Solve the CI eigenvalue problem and set the eigenpairs internally
+     *
+     *  If the Davidson solver options don't contain any initial guesses, they are generated with calculateDiagonalGuess()
      */
     void solve(const BaseSolverOptions& solver_options);
 
@@ -20,6 +20,7 @@
 
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 #include "HamiltonianBuilder/DOCI.hpp"
+#include "Observer/ObservableSolver.hpp"
 #include "OrbitalOptimizationOptions.hpp"
 #include "WaveFunction/WaveFunction.hpp"
 
@@ -31,12 +32,12 @@ namespace GQCP {
 
 
 /**
- *  A class that performs gradient-and-Hessian-based orbital optimization for DOCI by sequentially
+ *  A class that performs gradient-and-(approximate-)Hessian-based orbital optimization for DOCI by sequentially
  *      - solving the DOCI eigenvalue problem
- *      - solving the Newton step to find the anti-Hermitian orbital rotation parameters
+ *      - solving the (quasi-)Newton step to find the anti-Hermitian orbital rotation parameters
  *      - rotating the underlying spatial orbital basis
  */
-class DOCINewtonOrbitalOptimizer {
+class DOCINewtonOrbitalOptimizer : public ObservableSolver {
 private:
     DOCI doci;  // the DOCI Hamiltonian builder
     HamiltonianParameters<double> ham_par;
@@ -64,6 +65,8 @@ public:
     /**
      *  Do the orbital optimization for DOCI
      *
+     *  After every iteration, the attached observers are notified with the norm of the orbital gradient, the DOCI energies and the time spent in the CI solver
+     *
      *  @param solver_options       solver options for the CI solver
      *  @param oo_options           options for the orbital optimization
      */
@@ -115,6 +115,14 @@ public:
      *  @param onv2s     the beta ONVs as string representations read from right to left
      */
     void addConfiguration(const std::vector<std::string>& onv1s, const std::vector<std::string>& onv2s);
+
+    /**
+     *  Add a configuration to this Fock space
+     *
+     *  @param onv_alpha    the alpha ONV
+     *  @param onv_beta     the beta ONV
+     */
+    void addConfiguration(const ONV& onv_alpha, const ONV& onv_beta);
 };
 
 
@@ -0,0 +1,122 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_AOINTEGRALCACHE_HPP
+#define GQCP_AOINTEGRALCACHE_HPP
+
+
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "Molecule.hpp"
+#include "Operator/OneElectronOperator.hpp"
+#include "Operator/PackedTwoElectronOperator.hpp"
+
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  The integrals over an AO basis that are stored in an AO integral cache
+ */
+struct AOIntegrals {
+    OneElectronOperator<double> S;  // the overlap integrals
+    OneElectronOperator<double> T;  // the kinetic integrals
+    OneElectronOperator<double> V;  // the nuclear attraction integrals
+    PackedTwoElectronOperator g;  // the (eight-fold packed) Coulomb repulsion integrals
+};
+
+
+
+/**
+ *  A persistent store of AO integrals in a directory, so that the integrals for the same molecule and basis set are only calculated once over several runs
+ *
+ *  Every set of integrals is stored in a compact binary file, whose name is a hash of the key that describes the molecular geometry, the basis set and the integral options. The full key is stored in the file as well, so that hash collisions are detected. Stored integrals are read back by memory-mapping their file.
+ */
+class AOIntegralCache {
+private:
+    std::string directory;  // the directory in which the integral files are stored
+    double tolerance;  // the spacing (in bohr) of the grid on which the coordinates of the atoms are rounded in the key
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param directory        the (existing) directory in which the integral files should be stored
+     *  @param tolerance        the spacing (in bohr) of the grid on which the coordinates of the atoms are rounded, so that geometries that only differ by numerical noise share their integrals
+     */
+    AOIntegralCache(const std::string& directory, double tolerance = Atom::tolerance_for_comparison);
+
+
+    // GETTERS
+    const std::string& get_directory() const { return this->directory; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param molecule                 the molecule on whose atoms the basis functions are centered
+     *  @param basisset_name            the name of the basis set, e.g. "STO-3G"
+     *  @param screening_threshold      the threshold for the Schwarz screening of the two-electron integrals, or 0 (the default) for exact integrals, as in HamiltonianParameters::Molecular()
+     *
+     *  @return the key that describes the AO integrals: the rounded geometry, the (case-insensitive) basis set name and the integral options. The charge of the molecule is irrelevant for the integrals, so it isn't part of the key
+     */
+    std::string key(const Molecule& molecule, const std::string& basisset_name, double screening_threshold = 0.0) const;
+
+    /**
+     *  @param key      the key that describes the AO integrals
+     *
+     *  @return the name of the file in which the AO integrals with the given key are (or would be) stored
+     */
+    std::string filename(const std::string& key) const;
+
+    /**
+     *  @param key      the key that describes the AO integrals
+     *
+     *  @return if integrals with the given key are stored in this cache
+     */
+    bool contains(const std::string& key) const;
+
+    /**
+     *  @param key      the key that describes the AO integrals
+     *
+     *  @return the AO integrals with the given key, read by memory-mapping their file
+     */
+    AOIntegrals read(const std::string& key) const;
+
+    /**
+     *  Store AO integrals in this cache. The file is written under a temporary name and then renamed, so that other runs never see a partially written file
+     *
+     *  @param key          the key that describes the AO integrals
+     *  @param integrals    the AO integrals that should be stored
+     */
+    void write(const std::string& key, const AOIntegrals& integrals) const;
+
+    /**
+     *  @param molecule                 the molecule for which the Hamiltonian parameters should be calculated
+     *  @param basisset_name            the name of the basis set corresponding to the AO basis
+     *  @param screening_threshold      the threshold for the Schwarz screening of the two-electron integrals, or 0 (the default) for exact integrals, as in HamiltonianParameters::Molecular()
+     *
+     *  @return the molecular Hamiltonian parameters in the AO basis (see HamiltonianParameters::Molecular()), whose integrals are read from this cache if possible and are calculated and stored otherwise
+     */
+    HamiltonianParameters<double> molecularHamiltonianParameters(const Molecule& molecule, const std::string& basisset_name, double screening_threshold = 0.0) const;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_AOINTEGRALCACHE_HPP
@@ -19,6 +19,7 @@
 #define GQCP_BASEHAMILTONIANPARAMETERS_HPP
 
 
+#include <atomic>
 #include <memory>
 
 #include "Basis/AOBasis.hpp"
@@ -35,6 +36,8 @@ protected:
     double scalar;  // a scalar interaction term
     std::shared_ptr<AOBasis> ao_basis;  // the initial atomic orbitals
 
+    static std::atomic<size_t> number_of_deep_copies;  // the number of times that two-electron integrals have been deep-copied by any Hamiltonian parameters
+
 public:
     // CONSTRUCTORS
     /**
@@ -53,6 +56,7 @@ public:
     // GETTERS
     const std::shared_ptr<AOBasis>& get_ao_basis() const { return this->ao_basis; }
     double get_scalar() const { return this->scalar; }
+    static size_t get_number_of_deep_copies() { return number_of_deep_copies; }
 };
 
 
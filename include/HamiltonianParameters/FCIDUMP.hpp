@@ -0,0 +1,98 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_FCIDUMP_HPP
+#define GQCP_FCIDUMP_HPP
+
+
+#include "Operator/OneElectronOperator.hpp"
+#include "Operator/PackedTwoElectronOperator.hpp"
+
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  The contents of an FCIDUMP file: the integrals over an orthonormal orbital basis
+ */
+struct FCIDUMPIntegrals {
+    double scalar = 0.0;  // the scalar interaction term, e.g. the internuclear repulsion
+    OneElectronOperator<double> h;  // the one-electron integrals
+    PackedTwoElectronOperator g;  // the (eight-fold packed) two-electron integrals in chemist's notation
+};
+
+
+/**
+ *  Parse a floating point number in C or Fortran notation, e.g. -1.5e-03 or 0.25D+01
+ *
+ *  @param position     the position at which parsing starts (leading blanks are skipped), which is moved past the number
+ *  @param end          the end of the text
+ *  @param value        the parsed number
+ *
+ *  @return if a number could be parsed
+ *
+ *  Numbers with a decimal exponent up to 22 in absolute value are converted with one integer-to-double conversion and one multiplication or division by an exact power of ten, so they are accurate to about one unit in the last place. Other numbers are handed to std::strtod
+ */
+bool parseFCIDUMPDouble(const char*& position, const char* end, double& value);
+
+/**
+ *  Parse an unsigned integer
+ *
+ *  @param position     the position at which parsing starts (leading blanks are skipped), which is moved past the number
+ *  @param end          the end of the text
+ *  @param value        the parsed number
+ *
+ *  @return if a number could be parsed
+ */
+bool parseFCIDUMPIndex(const char*& position, const char* end, size_t& value);
+
+/**
+ *  Read a (text) FCIDUMP file by memory-mapping it and parsing blocks of lines on several threads
+ *
+ *  @param fcidump_file             the name of the FCIDUMP file
+ *  @param number_of_threads        the number of threads that parse the file, or 0 to use all available hardware threads
+ *
+ *  @return the integrals in the FCIDUMP file
+ *
+ *  Every unique two-electron integral is stored in its own element of the packed storage, so the threads never write to the same element for a file that lists every unique integral once
+ */
+FCIDUMPIntegrals readFCIDUMP(const std::string& fcidump_file, size_t number_of_threads = 0);
+
+/**
+ *  Read a binary FCIDUMP file that was written by writeBinaryFCIDUMP()
+ *
+ *  @param filename         the name of the binary FCIDUMP file
+ *
+ *  @return the integrals in the binary FCIDUMP file
+ */
+FCIDUMPIntegrals readBinaryFCIDUMP(const std::string& filename);
+
+/**
+ *  Write integrals to a binary FCIDUMP file, which stores a small header followed by the one-electron integrals and the packed unique two-electron integrals, without any loss of precision
+ *
+ *  @param filename         the name of the binary FCIDUMP file
+ *  @param integrals        the integrals that should be written
+ */
+void writeBinaryFCIDUMP(const std::string& filename, const FCIDUMPIntegrals& integrals);
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_FCIDUMP_HPP
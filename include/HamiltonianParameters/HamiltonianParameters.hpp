@@ -19,14 +19,20 @@
 #define GQCP_HAMILTONIANPARAMETERS_HPP
 
 #include "HamiltonianParameters/BaseHamiltonianParameters.hpp"
+#include "HamiltonianParameters/FCIDUMP.hpp"
 #include "HoppingMatrix.hpp"
 #include "JacobiRotationParameters.hpp"
 #include "Molecule.hpp"
 #include "Operator/OneElectronOperator.hpp"
+#include "Operator/PackedTwoElectronOperator.hpp"
 #include "Operator/TwoElectronOperator.hpp"
 #include "RDM/TwoRDM.hpp"
 #include "RDM/OneRDM.hpp"
 #include "typedefs.hpp"
+#include "utilities/miscellaneous.hpp"
+
+#include <atomic>
+#include <utility>
 
 
 namespace GQCP {
@@ -47,10 +53,63 @@ private:
     OneElectronOperator<Scalar> S;  // overlap
 
     OneElectronOperator<Scalar> h;  // one-electron interactions (i.e. the core Hamiltonian)
-    TwoElectronOperator<Scalar> g;  // two-electron interactions
+    std::shared_ptr<TwoElectronOperator<Scalar>> g;  // two-electron interactions, which are shared between copies of these Hamiltonian parameters until one of them modifies them (copy-on-write)
 
     SquareMatrix<Scalar> T_total;  // total transformation matrix between the current (restricted) molecular orbitals and the atomic orbitals
 
+    // Quantities that are derived from the integrals are memoized in the current orbital basis, and are shared (read-only) between copies until they are invalidated
+    mutable std::shared_ptr<const OneElectronOperator<Scalar>> effective_one_electron_integrals;  // k(p,q) = h(p,q) - 1/2 (pr|rq)
+    mutable std::shared_ptr<const SquareMatrix<Scalar>> coulomb_diagonal;  // J(p,q) = (pp|qq)
+    mutable std::shared_ptr<const SquareMatrix<Scalar>> exchange_diagonal;  // K(p,q) = (pq|qp)
+    mutable std::shared_ptr<const std::pair<size_t, OneElectronOperator<Scalar>>> frozen_core_fock_matrix;  // the number of frozen orbitals, together with the corresponding core Fock matrix
+
+
+    /*
+     *  PRIVATE METHODS
+     */
+
+    /**
+     *  @param memo         the memoized quantity, which is (thread-safely) set if it wasn't calculated yet
+     *  @param calculate    a callable that calculates the quantity
+     *
+     *  @return the memoized quantity
+     */
+    template <typename Quantity, typename Calculation>
+    static std::shared_ptr<const Quantity> memoize(std::shared_ptr<const Quantity>& memo, const Calculation& calculate) {
+
+        auto quantity = std::atomic_load(&memo);
+        if (!quantity) {
+            quantity = std::make_shared<const Quantity>(calculate());
+            std::atomic_store(&memo, quantity);
+        }
+
+        return quantity;
+    }
+
+    /**
+     *  Forget all memoized quantities, since they no longer correspond to the current integrals
+     */
+    void invalidateDerivedQuantities() {
+
+        this->effective_one_electron_integrals.reset();
+        this->coulomb_diagonal.reset();
+        this->exchange_diagonal.reset();
+        this->frozen_core_fock_matrix.reset();
+    }
+
+    /**
+     *  @return a modifiable reference to the two-electron integrals, which are deep-copied first if they are shared with other Hamiltonian parameters
+     */
+    TwoElectronOperator<Scalar>& modifiable_g() {
+
+        if (this->g.use_count() > 1) {
+            this->g = std::make_shared<TwoElectronOperator<Scalar>>(*this->g);
+            BaseHamiltonianParameters::number_of_deep_copies++;
+        }
+
+        return *this->g;
+    }
+
 
 public:
 
@@ -62,16 +121,16 @@ public:
      *  @param ao_basis     the initial AO basis
      *  @param S            the overlap integrals
      *  @param h            the one-electron integrals H_core
-     *  @param g            the two-electron integrals
+     *  @param g            the two-electron integrals, which are moved into these Hamiltonian parameters
      *  @param C            a transformation matrix between the current molecular orbitals and the atomic orbitals
      *  @param scalar       the scalar interaction term
      */
-    HamiltonianParameters(std::shared_ptr<AOBasis> ao_basis, const OneElectronOperator<Scalar>& S, const OneElectronOperator<Scalar>& h, const TwoElectronOperator<Scalar>& g, const SquareMatrix<Scalar>& C, double scalar=0.0) :
+    HamiltonianParameters(std::shared_ptr<AOBasis> ao_basis, const OneElectronOperator<Scalar>& S, const OneElectronOperator<Scalar>& h, TwoElectronOperator<Scalar>&& g, const SquareMatrix<Scalar>& C, double scalar=0.0) :
         BaseHamiltonianParameters(std::move(ao_basis), scalar),
         K (S.get_dim()),
         S (S),
         h (h),
-        g (g),
+        g (std::make_shared<TwoElectronOperator<Scalar>>(std::move(g))),
         T_total (C)
     {
         // Check if the dimensions of all matrix representations are compatible
@@ -83,7 +142,7 @@ public:
             }
         }
 
-        if ((h.get_dim() != this->K) || (g.get_dim() != this->K) || (C.cols() != this->K) || (C.rows() != this->K)) {
+        if ((h.get_dim() != this->K) || (this->g->get_dim() != this->K) || (C.cols() != this->K) || (C.rows() != this->K)) {
             throw error;
         }
 
@@ -94,6 +153,21 @@ public:
     }
 
 
+    /**
+     *  @param ao_basis     the initial AO basis
+     *  @param S            the overlap integrals
+     *  @param h            the one-electron integrals H_core
+     *  @param g            the two-electron integrals, which are (deep-)copied into these Hamiltonian parameters
+     *  @param C            a transformation matrix between the current molecular orbitals and the atomic orbitals
+     *  @param scalar       the scalar interaction term
+     */
+    HamiltonianParameters(std::shared_ptr<AOBasis> ao_basis, const OneElectronOperator<Scalar>& S, const OneElectronOperator<Scalar>& h, const TwoElectronOperator<Scalar>& g, const SquareMatrix<Scalar>& C, double scalar=0.0) :
+        HamiltonianParameters(std::move(ao_basis), S, h, TwoElectronOperator<Scalar>(g), C, scalar)
+    {
+        BaseHamiltonianParameters::number_of_deep_copies++;
+    }
+
+
     /**
      *  A constructor that transforms the given Hamiltonian parameters with a transformation matrix
      *
@@ -101,7 +175,7 @@ public:
      *  @param C            the transformation matrix to be applied to the given Hamiltonian parameters
      */
     HamiltonianParameters(const HamiltonianParameters<Scalar>& ham_par, const SquareMatrix<Scalar>& C) :
-        HamiltonianParameters<Scalar>(ham_par.ao_basis, ham_par.S, ham_par.h, ham_par.g, ham_par.T_total, ham_par.scalar)
+        HamiltonianParameters<Scalar>(ham_par)
     {
         // We have now initialized the new Hamiltonian parameters to be a copy of the given Hamiltonian parameters, so now we will transform
         this->transform(C);
@@ -133,11 +207,10 @@ public:
     template<typename Z = Scalar>
     static enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> Molecular(std::shared_ptr<AOBasis> ao_basis, double scalar=0.0) {
 
-        // Calculate the integrals for the molecular Hamiltonian
-        const auto S = ao_basis->calculateOverlapIntegrals();
-        const auto T = ao_basis->calculateKineticIntegrals();
-        const auto V = ao_basis->calculateNuclearIntegrals();
-        OneElectronOperator<double> H = T + V;
+        // Calculate the integrals for the molecular Hamiltonian, the one-electron integrals in one sweep over the shell pairs
+        const auto one_electron_integrals = ao_basis->calculateOneElectronIntegrals();
+        const auto& S = one_electron_integrals[0];
+        OneElectronOperator<double> H = one_electron_integrals[1] + one_electron_integrals[2];
 
         auto g = ao_basis->calculateCoulombRepulsionIntegrals();
 
@@ -146,7 +219,7 @@ public:
         auto nbf = ao_basis->numberOfBasisFunctions();
         SquareMatrix<double> T_total = SquareMatrix<double>::Identity(nbf, nbf);
 
-        return HamiltonianParameters(ao_basis, S, H, g, T_total, scalar);
+        return HamiltonianParameters(ao_basis, S, H, std::move(g), T_total, scalar);
     }
 
 
@@ -215,19 +288,22 @@ public:
         std::uniform_real_distribution<double> double_distribution (-1.0, 1.0);
         double scalar = double_distribution(random_generator);
 
-        return HamiltonianParameters<double>(ao_basis, S, H, g, C, scalar);
+        return HamiltonianParameters<double>(ao_basis, S, H, std::move(g), C, scalar);
     }
 
 
     /**
-     *  @param fcidump_file     the name of the FCIDUMP file
+     *  @param fcidump_file             the name of the FCIDUMP file
+     *  @param number_of_threads        the number of threads that parse the file, or 0 to use all available hardware threads
      *
      *  @return Hamiltonian parameters corresponding to the contents of an FCIDUMP file
      *
+     *  The FCIDUMP file is memory-mapped and parsed in parallel blocks of lines, see readFCIDUMP()
+     *
      *  Note that this named constructor is only available for real matrix representations
      */
     template<typename Z = Scalar>
-    static enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> ReadFCIDUMP(const std::string& fcidump_file) {
+    static enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> ReadFCIDUMP(const std::string& fcidump_file, size_t number_of_threads = 0) {
 
         // Find the extension of the given path (https://stackoverflow.com/a/51992)
         std::string extension;
@@ -236,112 +312,47 @@ public:
         if (idx != std::string::npos) {
             extension = fcidump_file.substr(idx+1);
         } else {
-            throw std::runtime_error("HamiltonianParameters::ReadFCIDUMP(std::string): I did not find an extension in your given path.");
+            throw std::runtime_error("HamiltonianParameters::ReadFCIDUMP(std::string, size_t): I did not find an extension in your given path.");
         }
 
         if (!(extension == "FCIDUMP")) {
-            throw std::runtime_error("HamiltonianParameters::ReadFCIDUMP(std::string): You did not provide a .FCIDUMP file name");
-        }
-
-        // If the xyz_filename isn't properly converted into an input file stream, we assume the user supplied a wrong file
-        std::ifstream input_file_stream (fcidump_file);
-
-        if (!input_file_stream.good()) {
-            throw std::runtime_error("HamiltonianParameters::ReadFCIDUMP(std::string): The provided FCIDUMP file is illegible. Maybe you specified a wrong path?");
+            throw std::runtime_error("HamiltonianParameters::ReadFCIDUMP(std::string, size_t): You did not provide a .FCIDUMP file name");
         }
 
+        return HamiltonianParameters::FromFCIDUMPIntegrals(readFCIDUMP(fcidump_file, number_of_threads));
+    }
 
-        // Do the actual parsing
-
-        //  Get the number of orbitals to check if it's a valid FCIDUMP file
-        std::string start_line;  // first line contains orbitals and electron count
-        std::getline(input_file_stream, start_line);
-        std::stringstream linestream (start_line);
-
-        size_t K = 0;
-        char iter;
-
-        while (linestream >> iter) {
-            if (iter == '=') {
-                linestream >> K;  // right here we have the number of orbitals
-                break;  // we can finish reading the linestream after we found K
-            }
-        }
-
-        if (K == 0) {
-            throw std::invalid_argument("HamiltonianParameters::ReadFCIDUMP(std::string): The .FCIDUMP-file is invalid: could not read a number of orbitals.");
-        }
-
-
-        double scalar = 0.0;
-        OneElectronOperator<double> h_core = OneElectronOperator<double>::Zero(K, K);
-        TwoElectronOperator<double> g (K);
-        g.setZero();
-
-        //  Skip 3 lines
-        for (size_t counter = 0; counter < 3; counter++) {
-            std::getline(input_file_stream, start_line);
-        }
-
-
-        //  Start reading in the one- and two-electron integrals
-        double x;
-        size_t i, j, a, b;
-
-        std::string line;
-        while (std::getline(input_file_stream, line)) {
-            std::istringstream iss (line);
-
-            // Based on what the values of the indices are, we can read one-electron integrals, two-electron integrals and the internuclear repulsion energy
-            //  See also (http://hande.readthedocs.io/en/latest/manual/integrals.html)
-            //  I think the documentation is a bit unclear for the two-electron integrals, but we can rest assured that FCIDUMP files give the two-electron integrals in CHEMIST's notation.
-            iss >> x >> i >> a >> j >> b;
-
-            //  Internuclear repulsion energy
-            if ((i == 0) && (j == 0) && (a == 0) && (b == 0)) {
-                scalar = x;
-            }
-
-            //  Single-particle eigenvalues (skipped)
-            else if ((a == 0) && (j == 0) && (b == 0)) {}
-
-            //  One-electron integrals (h_core)
-            else if ((j == 0) && (b == 0)) {
-                size_t p = i - 1;
-                size_t q = a - 1;
-                h_core(p,q) = x;
 
-                // Apply the permutational symmetry for real orbitals
-                h_core(q,p) = x;
-            }
+    /**
+     *  @param filename     the name of a binary FCIDUMP file, as written by writeBinaryFCIDUMP()
+     *
+     *  @return Hamiltonian parameters corresponding to the contents of the binary FCIDUMP file
+     *
+     *  Note that this named constructor is only available for real matrix representations
+     */
+    template<typename Z = Scalar>
+    static enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> ReadBinaryFCIDUMP(const std::string& filename) {
+        return HamiltonianParameters::FromFCIDUMPIntegrals(readBinaryFCIDUMP(filename));
+    }
 
-            //  Two-electron integrals are given in CHEMIST'S NOTATION, so just copy them over
-            else if ((i > 0) && (a > 0) && (j > 0) && (b > 0)) {
-                size_t p = i - 1;
-                size_t q = a - 1;
-                size_t r = j - 1;
-                size_t s = b - 1;
-                g(p,q,r,s) = x;
-
-                // Apply the permutational symmetries for real orbitals
-                g(p,q,s,r) = x;
-                g(q,p,r,s) = x;
-                g(q,p,s,r) = x;
-
-                g(r,s,p,q) = x;
-                g(s,r,p,q) = x;
-                g(r,s,q,p) = x;
-                g(s,r,q,p) = x;
-            }
-        }  // while loop
 
+    /**
+     *  @param integrals        the integrals over an orthonormal orbital basis
+     *
+     *  @return Hamiltonian parameters corresponding to the given FCIDUMP integrals
+     *
+     *  Note that this named constructor is only available for real matrix representations
+     */
+    template<typename Z = Scalar>
+    static enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> FromFCIDUMPIntegrals(const FCIDUMPIntegrals& integrals) {
 
         // Make the ingredients to construct HamiltonianParameters
+        const auto K = integrals.g.get_K();
         std::shared_ptr<AOBasis> ao_basis;  // nullptr
-        OneElectronOperator<Scalar> S = OneElectronOperator<double>::Identity(K, K);
+        OneElectronOperator<double> S = OneElectronOperator<double>::Identity(K, K);
         SquareMatrix<double> C = SquareMatrix<double>::Identity(K, K);
 
-        return HamiltonianParameters(ao_basis, S, h_core, g, C, scalar);
+        return HamiltonianParameters(ao_basis, S, integrals.h, integrals.g.toDense(), C, integrals.scalar);  // the orbital transformations need the dense integrals
     }
 
 
@@ -379,7 +390,7 @@ public:
         OneElectronOperator<double> S = OneElectronOperator<double>::Identity(K, K);
         SquareMatrix<double> C = SquareMatrix<double>::Identity(K, K);
 
-        return HamiltonianParameters(ao_basis, S, h, g, C);  // no scalar term
+        return HamiltonianParameters(ao_basis, S, h, std::move(g), C);  // no scalar term
     }
 
 
@@ -397,7 +408,7 @@ public:
 
     const OneElectronOperator<Scalar>& get_S() const { return this->S; }
     const OneElectronOperator<Scalar>& get_h() const { return this->h; }
-    const TwoElectronOperator<Scalar>& get_g() const { return this->g; }
+    const TwoElectronOperator<Scalar>& get_g() const { return *this->g; }
     const SquareMatrix<Scalar>& get_T_total() const { return this->T_total; }
     size_t get_K() const { return this->K; }
 
@@ -414,6 +425,29 @@ public:
     }
 
 
+    /**
+     *  Write these Hamiltonian parameters to a binary FCIDUMP file, which can be read back (much faster than a text FCIDUMP file) with ReadBinaryFCIDUMP()
+     *
+     *  @param filename     the name of the binary FCIDUMP file
+     *
+     *  Note that this method is only available for real matrix representations in an orthonormal orbital basis
+     */
+    template<typename Z = Scalar>
+    enable_if_t<std::is_same<Z, double>::value> writeBinaryFCIDUMP(const std::string& filename) const {
+
+        if (!this->areOrbitalsOrthonormal()) {
+            throw std::invalid_argument("HamiltonianParameters::writeBinaryFCIDUMP(std::string): An FCIDUMP file can only represent Hamiltonian parameters in an orthonormal orbital basis.");
+        }
+
+        FCIDUMPIntegrals integrals;
+        integrals.scalar = this->scalar;
+        integrals.h = this->h;
+        integrals.g = PackedTwoElectronOperator::FromDense(*this->g, PackedSymmetry::EIGHTFOLD);
+
+        GQCP::writeBinaryFCIDUMP(filename, integrals);
+    }
+
+
     /**
      *  In-place transform the matrix representations of Hamiltonian parameters
      *
@@ -431,9 +465,11 @@ public:
         this->S.transform(T);
 
         this->h.transform(T);
-        this->g.transform(T);
+        this->modifiable_g().transform(T);
 
         this->T_total = this->T_total * T;  // use the correct transformation formula for subsequent transformations
+
+        this->invalidateDerivedQuantities();
     }
 
 
@@ -454,14 +490,15 @@ public:
 
         this->S.rotate(jacobi_rotation_parameters);
         this->h.rotate(jacobi_rotation_parameters);
-        this->g.rotate(jacobi_rotation_parameters);
+        this->modifiable_g().rotate(jacobi_rotation_parameters);
 
 
-        // Create a Jacobi rotation matrix to transform the coefficient matrix with
-        size_t K = this->h.get_dim();  // number of spatial orbitals
-        auto J = SquareMatrix<double>::FromJacobi(jacobi_rotation_parameters, K);
-        this->T_total = this->T_total * J;
+        // Update the total transformation matrix in place, since only the columns p and q change (cfr. T_total * J)
+        double c = std::cos(jacobi_rotation_parameters.get_angle());
+        double s = std::sin(jacobi_rotation_parameters.get_angle());
+        this->T_total.applyOnTheRight(jacobi_rotation_parameters.get_p(), jacobi_rotation_parameters.get_q(), Eigen::JacobiRotation<double> (c, s));
 
+        this->invalidateDerivedQuantities();
     }
 
 
@@ -505,58 +542,72 @@ public:
     template<typename Z = Scalar>
     enable_if_t<std::is_same<Z, double>::value, double> calculateEdmistonRuedenbergLocalizationIndex(size_t N_P) const {
 
-        double localization_index = 0.0;
+        return this->calculateCoulombDiagonal().diagonal().head(N_P).sum();
+    }
+
+    /**
+     *  @return the Coulomb pair diagonal J(p,q) = (pp|qq), which is memoized in the current orbital basis
+     */
+    SquareMatrix<Scalar> calculateCoulombDiagonal() const {
 
-        // TODO: when Eigen releases TensorTrace, use it here
-        for (size_t i = 0; i < N_P; i++) {
-            localization_index += this->g(i,i,i,i);
-        }
+        return *memoize(this->coulomb_diagonal, [this] () {
+            SquareMatrix<Scalar> J = SquareMatrix<Scalar>::Zero(this->K, this->K);
+            for (size_t p = 0; p < this->K; p++) {
+                for (size_t q = 0; q < this->K; q++) {
+                    J(p,q) = (*this->g)(p,p,q,q);
+                }
+            }
+            return J;
+        });
+    }
+
+    /**
+     *  @return the exchange pair diagonal K(p,q) = (pq|qp), which is memoized in the current orbital basis
+     */
+    SquareMatrix<Scalar> calculateExchangeDiagonal() const {
 
-        return localization_index;
+        return *memoize(this->exchange_diagonal, [this] () {
+            SquareMatrix<Scalar> K = SquareMatrix<Scalar>::Zero(this->K, this->K);
+            for (size_t p = 0; p < this->K; p++) {
+                for (size_t q = 0; q < this->K; q++) {
+                    K(p,q) = (*this->g)(p,q,q,p);
+                }
+            }
+            return K;
+        });
     }
 
 
     // PUBLIC METHODS - CALCULATIONS OF ONE-ELECTRON OPERATORS
     /**
-     *  @param D      the 1-RDM
-     *  @param d      the 2-RDM
+     *  @param D                    the 1-RDM
+     *  @param d                    the 2-RDM
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
      *
-     *  @return the generalized Fock matrix
+     *  @return the generalized Fock matrix F(p,q) = h(q,r) D(p,r) + (qr|st) d(pr|st)
      */
-    OneElectronOperator<Scalar> calculateGeneralizedFockMatrix(const OneRDM<double>& D, const TwoRDM<double>& d) const {
+    OneElectronOperator<Scalar> calculateGeneralizedFockMatrix(const OneRDM<double>& D, const TwoRDM<double>& d, size_t number_of_threads = 0) const {
 
         // Check if dimensions are compatible
         if (D.cols() != this->K) {
-            throw std::invalid_argument("HamiltonianParameters::calculateGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>): The 1-RDM is not compatible with the HamiltonianParameters.");
+            throw std::invalid_argument("HamiltonianParameters::calculateGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>, size_t): The 1-RDM is not compatible with the HamiltonianParameters.");
         }
 
         if (d.dimension(0) != this->K) {
-            throw std::invalid_argument("HamiltonianParameters::calculateGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>): The 2-RDM is not compatible with the HamiltonianParameters.");
+            throw std::invalid_argument("HamiltonianParameters::calculateGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>, size_t): The 2-RDM is not compatible with the HamiltonianParameters.");
         }
 
 
-        // A KISS implementation of the calculation of the generalized Fock matrix F
-        OneElectronOperator<Scalar> F = OneElectronOperator<Scalar>::Zero(this->K, this->K);
-        for (size_t p = 0; p < this->K; p++) {
-            for (size_t q = 0; q < this->K; q++) {
-
-                // One-electron part
-                for (size_t r = 0; r < this->K; r++) {
-                    F(p,q) += h(q,r) * D(p,r);
-                }
-
-                // Two-electron part
-                for (size_t r = 0; r < this->K; r++) {
-                    for (size_t s = 0; s < this->K; s++) {
-                        for (size_t t = 0; t < this->K; t++) {
-                            F(p,q) += g(q,r,s,t) * d(p,r,s,t);
-                        }
-                    }
-                }  // two-electron part
-
-            }
-        }  // F elements loop
+        // Since the tensors are stored column-major, they can be viewed (without copying) as (K x K^3)-matrices g(q, rst) and d(p, rst), so that the two-electron part is the matrix-matrix product d g^T
+        const auto K = this->K;
+        Eigen::Map<const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>> g_q_rst (this->g->data(), K, K*K*K);
+        Eigen::Map<const Eigen::MatrixXd> d_p_rst (d.data(), K, K*K*K);
 
+        OneElectronOperator<Scalar> F = OneElectronOperator<Scalar>::Zero(K, K);
+        parallelFor(K, number_of_threads, [this, &D, &g_q_rst, &d_p_rst, &F] (size_t start, size_t end) {
+            F.middleRows(start, end - start).noalias() = D.middleRows(start, end - start).template cast<Scalar>() * this->h.transpose();
+            F.middleRows(start, end - start).noalias() += d_p_rst.middleRows(start, end - start).template cast<Scalar>() * g_q_rst.transpose();
+        });
 
         return F;
     }
@@ -600,78 +651,272 @@ public:
     }
 
     /**
-     *  @return the effective one-electron integrals
+     *  @return the effective one-electron integrals, which are memoized in the current orbital basis
      */
     OneElectronOperator<Scalar> calculateEffectiveOneElectronIntegrals() const {
 
-        auto k = this->h;
+        return *memoize(this->effective_one_electron_integrals, [this] () {
+            auto k = this->h;
+
+            for (size_t p = 0; p < this->K; p++) {
+                for (size_t q = 0; q < this->K; q++) {
+                    for (size_t r = 0; r < this->K; r++) {
+                        k(p,q) -= 0.5 * (*this->g)(p,r,r,q);
+                    }
+                }
+            }
+
+            return k;
+        });
+    }
+
+    /**
+     *  @param X        the number of frozen (core) orbitals, which are the first X orbitals
+     *
+     *  @return the core Fock matrix in the active orbitals, i.e. the active one-electron integrals that include the interactions with the frozen orbitals. It is memoized in the current orbital basis for the last requested number of frozen orbitals
+     */
+    OneElectronOperator<Scalar> calculateFrozenCoreFockMatrix(size_t X) const {
+
+        if (X > this->K) {
+            throw std::invalid_argument("HamiltonianParameters::calculateFrozenCoreFockMatrix(size_t): The number of frozen orbitals cannot be larger than the number of orbitals.");
+        }
+
+        auto memo = std::atomic_load(&this->frozen_core_fock_matrix);
+        if (!memo || (memo->first != X)) {
+
+            const size_t K_active = this->K - X;
+            OneElectronOperator<Scalar> F (this->h.block(X, X, K_active, K_active));
 
-        for (size_t p = 0; p < this->K; p++) {
-            for (size_t q = 0; q < this->K; q++) {
-                for (size_t r = 0; r < this->K; r++) {
-                    k(p,q) -= 0.5 * this->g(p,r,r,q);
+            for (size_t i = 0; i < K_active; i++) {
+                for (size_t j = 0; j < K_active; j++) {
+
+                    size_t p = i + X;  // map the active orbital indices to the total orbital indices
+                    size_t q = j + X;
+
+                    for (size_t l = 0; l < X; l++) {  // iterate over the frozen orbitals
+                        F(i,j) += (*this->g)(p,q,l,l) + (*this->g)(l,l,p,q) - (*this->g)(p,l,l,q)/2 - (*this->g)(l,q,p,l)/2;
+                    }
                 }
             }
+
+            memo = std::make_shared<const std::pair<size_t, OneElectronOperator<Scalar>>>(X, std::move(F));
+            std::atomic_store(&this->frozen_core_fock_matrix, memo);
         }
 
-        return k;
+        return memo->second;
     }
 
 
     // PUBLIC METHODS - CALCULATIONS OF TWO-ELECTRON OPERATORS
     /**
-     *  @param D      the 1-RDM
-     *  @param d      the 2-RDM
+     *  @param D                    the 1-RDM
+     *  @param d                    the 2-RDM
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
      *
-     *  @return the super-generalized Fock matrix
+     *  @return the super-generalized Fock matrix W(p,q,r,s) = delta_rq F(p,s) - h(s,p) D(r,q) + (st|qu) d(rt|pu) - (st|up) d(rt|uq) - (sp|tu) d(rq|tu)
      */
-    TwoElectronOperator<Scalar> calculateSuperGeneralizedFockMatrix(const OneRDM<double>& D, const TwoRDM<double>& d) const {
+    TwoElectronOperator<Scalar> calculateSuperGeneralizedFockMatrix(const OneRDM<double>& D, const TwoRDM<double>& d, size_t number_of_threads = 0) const {
 
         // Check if dimensions are compatible
         if (D.cols() != this->K) {
-            throw std::invalid_argument("HamiltonianParameters::calculateGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>): The 1-RDM is not compatible with the HamiltonianParameters.");
+            throw std::invalid_argument("HamiltonianParameters::calculateSuperGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>, size_t): The 1-RDM is not compatible with the HamiltonianParameters.");
         }
 
         if (d.dimension(0) != this->K) {
-            throw std::invalid_argument("HamiltonianParameters::calculateGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>): The 2-RDM is not compatible with the HamiltonianParameters.");
+            throw std::invalid_argument("HamiltonianParameters::calculateSuperGeneralizedFockMatrix(OneRDM<double>, TwoRDM<double>, size_t): The 2-RDM is not compatible with the HamiltonianParameters.");
         }
 
 
         // We have to calculate the generalized Fock matrix F first
-        OneElectronOperator<Scalar> F = this->calculateGeneralizedFockMatrix(D, d);
+        OneElectronOperator<Scalar> F = this->calculateGeneralizedFockMatrix(D, d, number_of_threads);
+
+
+        // Every two-electron term is a matrix product over the compound index tu, once the 2-RDM and the integrals are reordered (if necessary) so that t and u are their last indices
+        // In column-major storage, such a reordered 2-RDM x(a,b,t,u) is a (K^2 x K^2)-matrix x(ab, tu). Only the 2-RDM is reordered as a whole, in one scratch tensor that is reused for both terms: the integrals are gathered for one index s at a time in a (K x K^2)-slice g_s(b, tu), so that the products d(ra, tu) g_s(b, tu)^T are (K^2 x K)-matrices that can be distributed over the rows ra
+        using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+        const auto K = this->K;
+        const auto multiply = [number_of_threads, K] (const double* d_data, const Matrix& g_slice, Matrix& result) {
+            Eigen::Map<const Eigen::MatrixXd> d_matrix (d_data, K*K, K*K);
+
+            parallelFor(K*K, number_of_threads, [&d_matrix, &g_slice, &result] (size_t start, size_t end) {
+                result.middleRows(start, end - start).noalias() += d_matrix.middleRows(start, end - start).template cast<Scalar>() * g_slice.transpose();
+            });
+        };
+
+        Eigen::Tensor<double, 4> d_shuffled (K, K, K, K);
+        Matrix g_slice (K, K*K);
+        Matrix product (K*K, K);
+
+
+        // The one-electron parts and the term (st|qu) d(rt|pu) = A_s(rp, q)
+        TwoElectronOperator<Scalar> W (K);
+        d_shuffled = d.Eigen().shuffle(Eigen::array<int, 4> {0, 2, 1, 3});  // d(r,t,p,u) -> d(r,p,t,u)
+        for (size_t s = 0; s < K; s++) {
+            for (size_t u = 0; u < K; u++) {
+                for (size_t t = 0; t < K; t++) {
+                    for (size_t q = 0; q < K; q++) {
+                        g_slice(q, t + K*u) = (*this->g)(s,t,q,u);
+                    }
+                }
+            }
+
+            product.setZero();
+            multiply(d_shuffled.data(), g_slice, product);
 
-        // A KISS implementation of the calculation of the super generalized Fock matrix W
-        TwoElectronOperator<Scalar> W (this->K);
-        W.setZero();
-        for (size_t p = 0; p < this->K; p++) {
-            for (size_t q = 0; q < this->K; q++) {
-                for (size_t r = 0; r < this->K; r++) {
-                    for (size_t s = 0; s < this->K; s++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t q = 0; q < K; q++) {
+                    for (size_t p = 0; p < K; p++) {
+                        W(p,q,r,s) = product(r + K*p, q) - this->h(s,p) * D(r,q);
 
-                        // Generalized Fock matrix part
                         if (r == q) {
                             W(p,q,r,s) += F(p,s);
                         }
+                    }
+                }
+            }
+        }
 
-                        // One-electron part
-                        W(p,q,r,s) -= this->h(s,p) * D(r,q);
 
-                        // Two-electron part
-                        for (size_t t = 0; t < this->K; t++) {
-                            for (size_t u = 0; u < this->K; u++) {
-                                W(p,q,r,s) += this->g(s,t,q,u) * d(r,t,p,u) - this->g(s,t,u,p) * d(r,t,u,q) - this->g(s,p,t,u) * d(r,q,t,u);
-                            }
-                        }  // two-electron part
+        // The terms (st|up) d(rt|uq) + (sp|tu) d(rq|tu) = B_s(rq, p)
+        d_shuffled = d.Eigen().shuffle(Eigen::array<int, 4> {0, 3, 1, 2});  // d(r,t,u,q) -> d(r,q,t,u)
+        for (size_t s = 0; s < K; s++) {
+            product.setZero();
+
+            for (size_t u = 0; u < K; u++) {
+                for (size_t t = 0; t < K; t++) {
+                    for (size_t p = 0; p < K; p++) {
+                        g_slice(p, t + K*u) = (*this->g)(s,t,u,p);
                     }
                 }
             }
-        }  // W elements loop
+            multiply(d_shuffled.data(), g_slice, product);
+
+            for (size_t u = 0; u < K; u++) {
+                for (size_t t = 0; t < K; t++) {
+                    for (size_t p = 0; p < K; p++) {
+                        g_slice(p, t + K*u) = (*this->g)(s,p,t,u);
+                    }
+                }
+            }
+            multiply(d.data(), g_slice, product);  // the 2-RDM d(rq|tu) already has t and u as its last indices
+
+            for (size_t r = 0; r < K; r++) {
+                for (size_t q = 0; q < K; q++) {
+                    for (size_t p = 0; p < K; p++) {
+                        W(p,q,r,s) -= product(r + K*q, p);
+                    }
+                }
+            }
+        }
 
 
         return W;
     }
 
 
+    // PUBLIC METHODS - CALCULATIONS OF ORBITAL HESSIAN-VECTOR PRODUCTS AND DIAGONALS
+    /**
+     *  @param D                    the 1-RDM
+     *  @param d                    the 2-RDM
+     *  @param F                    the generalized Fock matrix that belongs to D and d
+     *  @param kappa                the anti-Hermitian (anti-symmetric) matrix of orbital rotation parameters, as used in the rotation U = exp(-kappa)
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the product of the orbital Hessian (at kappa = 0) with the free orbital rotation parameters, as an anti-symmetric matrix whose strict lower triangle corresponds to the strict lower triangle of kappa. Note that this function is only available for real (double) matrix representations
+     *
+     *  The product is calculated from the first-order change of the generalized Fock matrix under the rotation, without building the super-generalized Fock matrix or the Hessian: with the RDMs D_kappa(p,a) = kappa(a,r) D(p,r) and d_kappa(p,a,b,c) = kappa(a,r) d(p,r,b,c) + kappa(b,s) d(p,a,s,c) + kappa(c,t) d(p,a,b,t), and
+     *      M = F kappa + kappa F + 2 F(D_kappa, d_kappa) ,
+     *  the product is M^T - M. Its cost is O(K^5), compared to the O(K^6) of the super-generalized Fock matrix
+     */
+    template<typename Z = Scalar>
+    enable_if_t<std::is_same<Z, double>::value, SquareMatrix<double>> calculateOrbitalHessianVectorProduct(const OneRDM<double>& D, const TwoRDM<double>& d, const OneElectronOperator<double>& F, const SquareMatrix<double>& kappa, size_t number_of_threads = 0) const {
+
+        const auto K = this->K;
+        if ((D.cols() != K) || (d.dimension(0) != K) || (F.cols() != K) || (kappa.cols() != K)) {
+            throw std::invalid_argument("HamiltonianParameters::calculateOrbitalHessianVectorProduct(OneRDM<double>, TwoRDM<double>, OneElectronOperator<double>, SquareMatrix<double>, size_t): The given matrices and tensors are not compatible with the HamiltonianParameters.");
+        }
+
+
+        // Since the 2-RDM is stored column-major, its second, third and fourth index are the column index of a (K x K)-, (K^2 x K)- and (K^3 x K)-matrix view, so every term of d_kappa is a matrix-matrix product with kappa^T
+        using Matrix = Eigen::MatrixXd;
+        const Matrix kappa_transpose = kappa.transpose();
+
+        OneRDM<double> D_kappa = D * kappa_transpose;
+        TwoRDM<double> d_kappa (K);
+
+        parallelFor(K*K, number_of_threads, [&d, &d_kappa, &kappa_transpose, K] (size_t start, size_t end) {  // kappa(a,r) d(p,r,b,c) for every (b,c)
+            for (size_t bc = start; bc < end; bc++) {
+                Eigen::Map<const Matrix> d_p_r (d.data() + bc*K*K, K, K);
+                Eigen::Map<Matrix> d_kappa_p_a (d_kappa.data() + bc*K*K, K, K);
+                d_kappa_p_a.noalias() = d_p_r * kappa_transpose;
+            }
+        });
+
+        parallelFor(K, number_of_threads, [&d, &d_kappa, &kappa_transpose, K] (size_t start, size_t end) {  // kappa(b,s) d(p,a,s,c) for every c
+            for (size_t c = start; c < end; c++) {
+                Eigen::Map<const Matrix> d_pa_s (d.data() + c*K*K*K, K*K, K);
+                Eigen::Map<Matrix> d_kappa_pa_b (d_kappa.data() + c*K*K*K, K*K, K);
+                d_kappa_pa_b.noalias() += d_pa_s * kappa_transpose;
+            }
+        });
+
+        Eigen::Map<const Matrix> d_pab_t (d.data(), K*K*K, K);
+        Eigen::Map<Matrix> d_kappa_pab_c (d_kappa.data(), K*K*K, K);
+        parallelFor(K*K*K, number_of_threads, [&d_pab_t, &d_kappa_pab_c, &kappa_transpose] (size_t start, size_t end) {  // kappa(c,t) d(p,a,b,t)
+            d_kappa_pab_c.middleRows(start, end - start).noalias() += d_pab_t.middleRows(start, end - start) * kappa_transpose;
+        });
+
+
+        SquareMatrix<double> M = F * kappa + kappa * F + 2 * this->calculateGeneralizedFockMatrix(D_kappa, d_kappa, number_of_threads);
+        return M.transpose() - M;
+    }
+
+    /**
+     *  @param D                    the 1-RDM
+     *  @param d                    the 2-RDM
+     *  @param F                    the generalized Fock matrix that belongs to D and d
+     *
+     *  @return the diagonal of the orbital Hessian (at kappa = 0), in the order of the free orbital rotation parameters (i.e. as in SquareMatrix::strictLowerTriangle()). Note that this function is only available for real (double) matrix representations
+     *
+     *  Only the elements W(p,q,p,q), W(p,q,q,p), W(q,p,q,p) and W(q,p,p,q) of the super-generalized Fock matrix are needed, so that the cost is O(K^4) instead of O(K^6)
+     */
+    template<typename Z = Scalar>
+    enable_if_t<std::is_same<Z, double>::value, VectorX<double>> calculateOrbitalHessianDiagonal(const OneRDM<double>& D, const TwoRDM<double>& d, const OneElectronOperator<double>& F) const {
+
+        const auto K = this->K;
+        if ((D.cols() != K) || (d.dimension(0) != K) || (F.cols() != K)) {
+            throw std::invalid_argument("HamiltonianParameters::calculateOrbitalHessianDiagonal(OneRDM<double>, TwoRDM<double>, OneElectronOperator<double>): The given matrices and tensors are not compatible with the HamiltonianParameters.");
+        }
+
+        const auto& g = *this->g;
+        const auto W = [this, &D, &d, &F, &g, K] (size_t p, size_t q, size_t r, size_t s) {  // an element of the super-generalized Fock matrix
+            double value = - this->h(s,p) * D(r,q);
+            if (r == q) {
+                value += F(p,s);
+            }
+
+            for (size_t t = 0; t < K; t++) {
+                for (size_t u = 0; u < K; u++) {
+                    value += g(s,t,q,u) * d(r,t,p,u) - g(s,t,u,p) * d(r,t,u,q) - g(s,p,t,u) * d(r,q,t,u);
+                }
+            }
+            return value;
+        };
+
+
+        VectorX<double> diagonal = VectorX<double>::Zero(K*(K-1)/2);
+        size_t vector_index = 0;
+        for (size_t q = 0; q < K; q++) {  // use the same ordering as SquareMatrix::strictLowerTriangle()
+            for (size_t p = q+1; p < K; p++) {
+                diagonal(vector_index) = 2 * (W(p,q,p,q) - W(p,q,q,p) + W(q,p,q,p) - W(q,p,p,q));
+                vector_index++;
+            }
+        }
+
+        return diagonal;
+    }
+
+
     // PUBLIC METHODS - CONSTRAINTS
     /**
      *  Constrain the Hamiltonian parameters according to the convention: - lambda * constraint
@@ -688,9 +933,9 @@ public:
     enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> constrain(const OneElectronOperator<double>& one_op, const TwoElectronOperator<double>& two_op, double lambda) const {
 
         OneElectronOperator<double> h_constrained (this->h - lambda*one_op);
-        TwoElectronOperator<double> g_constrained (this->g - lambda*two_op);
+        TwoElectronOperator<double> g_constrained (*this->g - lambda*two_op);
 
-        return HamiltonianParameters(this->ao_basis, this->S, h_constrained, g_constrained, this->T_total);
+        return HamiltonianParameters(this->ao_basis, this->S, h_constrained, std::move(g_constrained), this->T_total);
     }
 
     /**
@@ -706,9 +951,13 @@ public:
     template<typename Z = Scalar>
     enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> constrain(const OneElectronOperator<double>& one_op, double lambda) const {
 
-        OneElectronOperator<double> h_constrained (this->h - lambda*one_op);
+        // The constrained Hamiltonian parameters share the two-electron integrals with these, but have no scalar term (like the other constrained Hamiltonian parameters)
+        auto constrained_ham_par = *this;
+        constrained_ham_par.h = this->h - lambda*one_op;
+        constrained_ham_par.scalar = 0.0;
+        constrained_ham_par.invalidateDerivedQuantities();
 
-        return HamiltonianParameters(this->ao_basis, this->S, h_constrained, this->g, this->T_total);
+        return constrained_ham_par;
     }
 
     /**
@@ -724,9 +973,9 @@ public:
     template<typename Z = Scalar>
     enable_if_t<std::is_same<Z, double>::value, HamiltonianParameters<double>> constrain(const TwoElectronOperator<double>& two_op, double lambda) const {
 
-        TwoElectronOperator<double> g_constrained (this->g - lambda*two_op);
+        TwoElectronOperator<double> g_constrained (*this->g - lambda*two_op);
 
-        return HamiltonianParameters(this->ao_basis, this->S, this->h, g_constrained, this->T_total);
+        return HamiltonianParameters(this->ao_basis, this->S, this->h, std::move(g_constrained), this->T_total);
     }
 };
 
@@ -0,0 +1,48 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_BASEITERATIONOBSERVER_HPP
+#define GQCP_BASEITERATIONOBSERVER_HPP
+
+
+#include "Observer/IterationRecord.hpp"
+
+
+namespace GQCP {
+
+
+/**
+ *  A base class for observers that get notified after every iteration of an iterative solver
+ */
+class BaseIterationObserver {
+public:
+    // DESTRUCTOR
+    virtual ~BaseIterationObserver() = default;
+
+
+    // PUBLIC PURE VIRTUAL METHODS
+    /**
+     *  @param record       the diagnostics of the iteration that just finished
+     */
+    virtual void update(const IterationRecord& record) = 0;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_BASEITERATIONOBSERVER_HPP
@@ -0,0 +1,54 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_ITERATIONHISTORY_HPP
+#define GQCP_ITERATIONHISTORY_HPP
+
+
+#include "Observer/BaseIterationObserver.hpp"
+
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  An observer that keeps all iteration records in memory
+ */
+class IterationHistory : public BaseIterationObserver {
+private:
+    std::vector<IterationRecord> records;
+
+
+public:
+    // GETTERS
+    const std::vector<IterationRecord>& get_records() const { return this->records; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param record       the diagnostics of the iteration that just finished
+     */
+    void update(const IterationRecord& record) override;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_ITERATIONHISTORY_HPP
@@ -0,0 +1,59 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_ITERATIONRECORD_HPP
+#define GQCP_ITERATIONRECORD_HPP
+
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A struct that holds the diagnostics of one iteration of an iterative solver
+ *
+ *  Quantities that don't apply to a solver are left at their default value
+ */
+struct IterationRecord {
+    std::string solver;  // the name of the solver that produced this record
+    size_t iteration = 0;  // the index of the iteration, starting at 0
+
+    std::vector<double> residual_norms;  // the convergence measure(s) that are compared to the threshold, e.g. one residual norm per root
+    std::vector<double> eigenvalues;  // the current eigenvalue (or energy) estimate(s)
+
+    size_t subspace_dimension = 0;  // the dimension of the subspace at the start of the iteration
+    bool collapsed = false;  // if the subspace was collapsed during the iteration
+
+    size_t number_of_matvecs = 0;  // the number of expensive operator applications (matrix-vector products, Fock builds, CI solves)
+    double matvec_time = 0.0;  // the wall time (in seconds) spent in those operator applications
+    double subspace_time = 0.0;  // the wall time (in seconds) spent in the remaining (subspace) algebra
+
+    size_t allocated_bytes = 0;  // the number of bytes allocated for the solver's main work arrays
+
+    size_t number_of_computed_quartets = 0;  // the number of shell quartets that were calculated, for integral-direct Fock matrix builds
+    size_t number_of_skipped_quartets = 0;  // the number of shell quartets that were skipped by the screening, for integral-direct Fock matrix builds
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_ITERATIONRECORD_HPP
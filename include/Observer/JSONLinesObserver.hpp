@@ -0,0 +1,74 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_JSONLINESOBSERVER_HPP
+#define GQCP_JSONLINESOBSERVER_HPP
+
+
+#include "Observer/BaseIterationObserver.hpp"
+
+#include <fstream>
+#include <ostream>
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  An observer that writes every iteration record as one JSON object per line (JSON Lines)
+ */
+class JSONLinesObserver : public BaseIterationObserver {
+private:
+    std::ofstream file;  // only open if this observer writes to a file
+    std::ostream& output;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param output       the stream to which the records are written, which should outlive this observer
+     */
+    explicit JSONLinesObserver(std::ostream& output);
+
+    /**
+     *  @param filename     the name of the file to which the records are appended
+     */
+    explicit JSONLinesObserver(const std::string& filename);
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param record       the diagnostics of the iteration that just finished
+     */
+    void update(const IterationRecord& record) override;
+
+
+    // PUBLIC STATIC METHODS
+    /**
+     *  @param record       an iteration record
+     *
+     *  @return the record as a single-line JSON object
+     */
+    static std::string toJSON(const IterationRecord& record);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_JSONLINESOBSERVER_HPP
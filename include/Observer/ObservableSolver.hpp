@@ -0,0 +1,80 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_OBSERVABLESOLVER_HPP
+#define GQCP_OBSERVABLESOLVER_HPP
+
+
+#include "Observer/BaseIterationObserver.hpp"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A base class for iterative solvers that report their progress to attached observers
+ *
+ *  Since the observers are notified during the iterations, their diagnostics survive a solver that throws because it did not converge
+ */
+class ObservableSolver {
+private:
+    std::vector<std::shared_ptr<BaseIterationObserver>> observers;
+
+
+protected:
+    // PROTECTED METHODS
+    /**
+     *  Notify all attached observers
+     *
+     *  @param record       the diagnostics of the iteration that just finished
+     */
+    void notify(const IterationRecord& record) const;
+
+    /**
+     *  Set the time spent in the subspace algebra, i.e. the wall time since the start of the iteration that wasn't spent in the expensive operator applications, and notify all attached observers
+     *
+     *  @param record       the diagnostics of the iteration that just finished
+     *  @param start        the time at which the iteration started
+     */
+    void finishIteration(IterationRecord& record, const std::chrono::steady_clock::time_point& start) const;
+
+
+public:
+    // DESTRUCTOR
+    virtual ~ObservableSolver() = default;
+
+
+    // GETTERS
+    const std::vector<std::shared_ptr<BaseIterationObserver>>& get_observers() const { return this->observers; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param observer     an observer that should be notified after every iteration
+     */
+    void attach(const std::shared_ptr<BaseIterationObserver>& observer);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_OBSERVABLESOLVER_HPP
@@ -0,0 +1,167 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_FACTORIZEDTWOELECTRONOPERATOR_HPP
+#define GQCP_FACTORIZEDTWOELECTRONOPERATOR_HPP
+
+
+#include "JacobiRotationParameters.hpp"
+#include "math/Matrix.hpp"
+#include "math/SquareMatrix.hpp"
+#include "Operator/OneElectronOperator.hpp"
+#include "Operator/Operator.hpp"
+#include "Operator/TwoElectronOperator.hpp"
+
+#include <functional>
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that represents (real) two-electron integrals in chemist's notation through a factorization
+ *
+ *      (pq|rs) ~ sum_P B_P(p,q) B_P(r,s)
+ *
+ *  so that only O(K^2 N) values are stored for N factor matrices B_P instead of K^4. The factor matrices can come from density fitting (resolution of the identity) or from a Cholesky decomposition
+ */
+class FactorizedTwoElectronOperator : public Operator<FactorizedTwoElectronOperator> {
+private:
+    size_t K;  // the number of orbitals
+    MatrixX<double> B;  // the (K^2 x N)-matrix whose P-th column holds the factor matrix B_P in column-major order, i.e. B(p + K q, P) = B_P(p,q)
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param K        the number of orbitals
+     *  @param B        the (K^2 x N)-matrix whose P-th column holds the factor matrix B_P in column-major order
+     */
+    FactorizedTwoElectronOperator(size_t K, const MatrixX<double>& B);
+
+
+    // NAMED CONSTRUCTORS
+    /**
+     *  @param three_center_integrals       the (K^2 x N_aux)-matrix of the three-center integrals (pq|Q), in which the compound index pq is p + K q
+     *  @param two_center_integrals         the (N_aux x N_aux)-matrix of the two-center integrals (P|Q) of the auxiliary basis
+     *  @param eigenvalue_threshold         the threshold on the eigenvalues of the two-center integrals below which the corresponding linear combinations of auxiliary functions are discarded
+     *
+     *  @return the density-fitted two-electron integrals (pq|rs) ~ (pq|P) [(P|Q)^-1] (Q|rs), factorized with the inverse square root of the two-center integrals
+     */
+    static FactorizedTwoElectronOperator DensityFitted(const MatrixX<double>& three_center_integrals, const SquareMatrix<double>& two_center_integrals, double eigenvalue_threshold = 1.0e-10);
+
+    /**
+     *  @param diagonal             the K^2 diagonal integrals (pq|pq), in which the compound index pq is p + K q
+     *  @param calculateColumn      a function that calculates the K^2 integrals (rs|pq) for a given compound index pq
+     *  @param tolerance            the tolerance on the largest remaining diagonal element, which bounds the error on every reconstructed integral
+     *  @param maximum_rank         the maximum number of Cholesky vectors, or 0 for no limit
+     *
+     *  @return the pivoted (incomplete) Cholesky decomposition of the two-electron integrals (pq|rs) ~ sum_J L_J(p,q) L_J(r,s), which only needs one column of integrals per Cholesky vector
+     */
+    static FactorizedTwoElectronOperator PivotedCholesky(const VectorX<double>& diagonal, const std::function<VectorX<double>(size_t)>& calculateColumn, double tolerance = 1.0e-08, size_t maximum_rank = 0);
+
+
+    // OPERATORS
+    /**
+     *  @return the (reconstructed) integral (pq|rs)
+     */
+    double operator()(size_t p, size_t q, size_t r, size_t s) const { return this->B.row(p + this->K * q).dot(this->B.row(r + this->K * s)); }
+
+
+    // GETTERS
+    size_t get_K() const { return this->K; }
+    size_t get_number_of_vectors() const { return this->B.cols(); }
+    const MatrixX<double>& get_B() const { return this->B; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param P        the index of the factor matrix
+     *
+     *  @return a read-only view on the factor matrix B_P
+     */
+    Eigen::Map<const Eigen::MatrixXd> factor(size_t P) const { return Eigen::Map<const Eigen::MatrixXd>(this->B.col(P).data(), this->K, this->K); }
+
+    /**
+     *  In-place transform the factor matrices to another orbital basis, i.e. B_P -> T^T B_P T, which takes O(K^3 N) operations instead of the O(K^5) of a transformation of the dense integrals
+     *
+     *  @param T    the transformation matrix between the old and the new orbital basis, it is used as (current orbitals) T = (new orbitals)
+     */
+    void transform(const SquareMatrix<double>& T);
+
+    using Operator<FactorizedTwoElectronOperator>::rotate;  // bring over rotate() from the base class
+
+    /**
+     *  In-place rotate the factor matrices using a Jacobi rotation, which only changes two rows and columns of every factor matrix
+     *
+     *  @param jacobi_rotation_parameters       the Jacobi rotation parameters (p, q, angle) that are used to specify a Jacobi rotation: we use the (cos, sin, -sin, cos) definition for the Jacobi rotation matrix
+     */
+    void rotate(const JacobiRotationParameters& jacobi_rotation_parameters);
+
+    /**
+     *  @return the dense representation of these two-electron integrals
+     */
+    TwoElectronOperator<double> toDense() const;
+
+    /**
+     *  @param r        the third orbital index
+     *  @param s        the fourth orbital index
+     *
+     *  @return the Coulomb slice M(p,q) = (pq|rs)
+     */
+    SquareMatrix<double> coulombSlice(size_t r, size_t s) const;
+
+    /**
+     *  @param q        the second orbital index
+     *  @param s        the fourth orbital index
+     *
+     *  @return the exchange slice M(p,r) = (pq|rs)
+     */
+    SquareMatrix<double> exchangeSlice(size_t q, size_t s) const;
+
+    /**
+     *  @param D        a (density) matrix
+     *
+     *  @return the Coulomb matrix J(p,q) = (pq|rs) D(s,r), calculated in O(K^2 N) operations
+     */
+    SquareMatrix<double> calculateCoulomb(const SquareMatrix<double>& D) const;
+
+    /**
+     *  @param D        a (density) matrix
+     *
+     *  @return the exchange matrix K(p,q) = (pr|sq) D(r,s), calculated in O(K^3 N) operations
+     */
+    SquareMatrix<double> calculateExchange(const SquareMatrix<double>& D) const;
+
+    /**
+     *  Write these two-electron integrals together with the given one-electron integrals to an FCIDUMP file, reconstructing every unique integral (pq|rs) on the fly
+     *
+     *  @param fcidump_file     the name of the FCIDUMP file
+     *  @param h                the one-electron integrals
+     *  @param scalar           the scalar interaction term
+     *  @param N                the number of electrons
+     *  @param threshold        the threshold below which integrals aren't written
+     */
+    void writeFCIDUMP(const std::string& fcidump_file, const OneElectronOperator<double>& h, double scalar, size_t N, double threshold = 1.0e-12) const;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_FACTORIZEDTWOELECTRONOPERATOR_HPP
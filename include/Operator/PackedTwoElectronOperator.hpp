@@ -0,0 +1,186 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_PACKEDTWOELECTRONOPERATOR_HPP
+#define GQCP_PACKEDTWOELECTRONOPERATOR_HPP
+
+
+#include "math/SquareMatrix.hpp"
+#include "Operator/TwoElectronOperator.hpp"
+
+#include <utility>
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  An enum class for the permutational symmetries that are exploited in the packed storage of two-electron integrals
+ */
+enum class PackedSymmetry {
+    EIGHTFOLD,  // (pq|rs) = (qp|rs) = (pq|sr) = (qp|sr) = (rs|pq) = (sr|pq) = (rs|qp) = (sr|qp), i.e. real orbitals
+    FOURFOLD  // (pq|rs) = (qp|rs) = (pq|sr) = (qp|sr), e.g. for integrals in which the bra and ket pairs are treated differently
+};
+
+
+
+/**
+ *  A class that represents the (real) two-electron integrals (pq|rs) in chemist's notation, in which only the permutationally unique integrals are stored
+ *
+ *  Every compound pair index pq (p >= q) is mapped to p(p+1)/2 + q. For eight-fold symmetry, the compound pair indices are themselves packed in the same triangular way, so that (K^4)/8 integrals are stored instead of K^4
+ */
+class PackedTwoElectronOperator {
+private:
+    size_t K;  // the number of orbitals
+    size_t number_of_pairs;  // the number of compound pair indices pq with p >= q
+    PackedSymmetry symmetry;
+
+    std::vector<double> data;  // the unique integrals
+
+
+    // PRIVATE METHODS
+    /**
+     *  @param p        the first orbital index
+     *  @param q        the second orbital index
+     *
+     *  @return the compound pair index of p and q
+     */
+    static size_t pairIndex(size_t p, size_t q) { return (p >= q) ? p * (p + 1) / 2 + q : q * (q + 1) / 2 + p; }
+
+    /**
+     *  @return the position of (pq|rs) in the packed storage
+     */
+    size_t index(size_t p, size_t q, size_t r, size_t s) const {
+        const auto pq = pairIndex(p, q);
+        const auto rs = pairIndex(r, s);
+
+        if (this->symmetry == PackedSymmetry::FOURFOLD) {
+            return pq * this->number_of_pairs + rs;
+        }
+        return pairIndex(pq, rs);
+    }
+
+    /**
+     *  @return the orbital indices (p, q) with p >= q of every compound pair index
+     */
+    std::vector<std::pair<size_t, size_t>> orbitalPairs() const;
+
+    /**
+     *  @param i        an index in the range [0, number_of_pairs)
+     *
+     *  @return the compound pair index that is handled at position i, in an order in which short and long rows of the eight-fold packed storage alternate
+     */
+    size_t balancedPairIndex(size_t i) const;
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  Initialize all integrals to zero
+     *
+     *  @param K            the number of orbitals
+     *  @param symmetry     the permutational symmetry that should be exploited
+     */
+    explicit PackedTwoElectronOperator(size_t K = 0, PackedSymmetry symmetry = PackedSymmetry::EIGHTFOLD);
+
+    /**
+     *  @param K                    the number of orbitals
+     *  @param symmetry             the permutational symmetry that should be exploited
+     *  @param unique_integrals     the unique integrals in their packed order (i.e. as returned by get_data()), which are copied
+     */
+    PackedTwoElectronOperator(size_t K, PackedSymmetry symmetry, const double* unique_integrals);
+
+
+    // NAMED CONSTRUCTORS
+    /**
+     *  @param g            the dense two-electron integrals, which should have the given permutational symmetry
+     *  @param symmetry     the permutational symmetry that should be exploited
+     *
+     *  @return the packed two-electron integrals, in which the symmetry-related elements of g are represented by the one with the canonical (largest) indices
+     */
+    static PackedTwoElectronOperator FromDense(const TwoElectronOperator<double>& g, PackedSymmetry symmetry = PackedSymmetry::EIGHTFOLD);
+
+
+    // OPERATORS
+    /**
+     *  @return a reference to (pq|rs), which is shared with all its symmetry-related integrals
+     */
+    double& operator()(size_t p, size_t q, size_t r, size_t s) { return this->data[this->index(p, q, r, s)]; }
+    double operator()(size_t p, size_t q, size_t r, size_t s) const { return this->data[this->index(p, q, r, s)]; }
+
+
+    // GETTERS
+    size_t get_K() const { return this->K; }
+    PackedSymmetry get_symmetry() const { return this->symmetry; }
+    size_t size() const { return this->data.size(); }
+    const std::vector<double>& get_data() const { return this->data; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return the dense representation of these two-electron integrals
+     */
+    TwoElectronOperator<double> toDense() const;
+
+    /**
+     *  @param r        the third orbital index
+     *  @param s        the fourth orbital index
+     *
+     *  @return the Coulomb slice M(p,q) = (pq|rs)
+     */
+    SquareMatrix<double> coulombSlice(size_t r, size_t s) const;
+
+    /**
+     *  @param q        the second orbital index
+     *  @param s        the fourth orbital index
+     *
+     *  @return the exchange slice M(p,r) = (pq|rs)
+     */
+    SquareMatrix<double> exchangeSlice(size_t q, size_t s) const;
+
+    /**
+     *  @return the Coulomb pair diagonal J(p,q) = (pp|qq)
+     */
+    SquareMatrix<double> coulombDiagonal() const;
+
+    /**
+     *  @return the exchange pair diagonal K(p,q) = (pq|qp)
+     */
+    SquareMatrix<double> exchangeDiagonal() const;
+
+    /**
+     *  @param D                    a (density) matrix
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the Coulomb matrix J(p,q) = (pq|rs) D(s,r), calculated in one pass over the unique integrals
+     */
+    SquareMatrix<double> calculateCoulomb(const SquareMatrix<double>& D, size_t number_of_threads = 0) const;
+
+    /**
+     *  @param D                    a (density) matrix
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the exchange matrix K(p,q) = (pr|sq) D(r,s), calculated in one pass over the unique integrals
+     */
+    SquareMatrix<double> calculateExchange(const SquareMatrix<double>& D, size_t number_of_threads = 0) const;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_PACKEDTWOELECTRONOPERATOR_HPP
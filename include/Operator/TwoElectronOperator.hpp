@@ -24,6 +24,9 @@
 #include "Operator/Operator.hpp"
 #include "utilities/miscellaneous.hpp"
 
+#include <algorithm>
+#include <vector>
+
 
 namespace GQCP {
 
@@ -43,6 +46,76 @@ public:
     using Self = TwoElectronOperator<Scalar>;
 
 
+private:
+
+    /*
+     *  PRIVATE METHODS
+     */
+
+    /**
+     *  @param A                    a (K^2 x K^2)-matrix whose columns are viewed as (K x K)-blocks A_rs
+     *  @param T                    the (K x K) transformation matrix
+     *  @param symmetric            if the blocks A_rs and A_sr are equal, so that only the blocks with r >= s have to be transformed
+     *  @param B                    the (K^2 x K^2)-matrix in which the transformed blocks T^T A_rs T are stored
+     *  @param number_of_threads    the number of threads over which the blocks are distributed, or 0 to use all available hardware threads
+     */
+    static void transformBlocks(const Eigen::Map<Eigen::MatrixXd>& A, const SquareMatrix<double>& T, bool symmetric, Eigen::MatrixXd& B, size_t number_of_threads) {
+
+        const auto K = static_cast<size_t>(T.rows());
+
+        std::vector<size_t> blocks;  // the compound indices r + K s of the blocks that are transformed
+        blocks.reserve(K*K);
+        for (size_t s = 0; s < K; s++) {
+            for (size_t r = symmetric ? s : 0; r < K; r++) {
+                blocks.push_back(r + K*s);
+            }
+        }
+
+        parallelFor(blocks.size(), number_of_threads, [&A, &T, symmetric, &B, K, &blocks] (size_t start, size_t end) {
+            Eigen::MatrixXd TA (K, K);
+            for (size_t i = start; i < end; i++) {
+                const auto rs = blocks[i];
+
+                Eigen::Map<const Eigen::MatrixXd> A_rs (A.col(rs).data(), K, K);
+                Eigen::Map<Eigen::MatrixXd> B_rs (B.col(rs).data(), K, K);
+                TA.noalias() = T.transpose() * A_rs;
+                B_rs.noalias() = TA * T;
+
+                const auto r = rs % K;
+                const auto s = rs / K;
+                if (symmetric && (r != s)) {
+                    B.col(s + K*r) = B.col(rs);
+                }
+            }
+        });
+    }
+
+
+    /**
+     *  @param A                    a square matrix
+     *  @param B                    the matrix in which the transpose of A is stored
+     *  @param number_of_threads    the number of threads over which the tiles are distributed, or 0 to use all available hardware threads
+     *
+     *  The transposition is done in square tiles that fit in the cache, so that A and B are both accessed (mostly) contiguously
+     */
+    static void transposeInTiles(const Eigen::MatrixXd& A, Eigen::Map<Eigen::MatrixXd>& B, size_t number_of_threads) {
+
+        const auto n = static_cast<size_t>(A.rows());
+        const size_t tile_size = 64;
+        const auto number_of_tiles = (n + tile_size - 1) / tile_size;  // in one dimension
+
+        parallelFor(number_of_tiles, number_of_threads, [&A, &B, n, tile_size, number_of_tiles] (size_t start, size_t end) {
+            for (size_t j = start; j < end; j++) {  // every thread fills in its own rows of tiles of B
+                const auto cols = std::min(tile_size, n - j*tile_size);
+                for (size_t i = 0; i < number_of_tiles; i++) {
+                    const auto rows = std::min(tile_size, n - i*tile_size);
+                    B.block(j*tile_size, i*tile_size, cols, rows) = A.block(i*tile_size, j*tile_size, rows, cols).transpose();
+                }
+            }
+        });
+    }
+
+
 public:
 
     /*
@@ -69,7 +142,7 @@ public:
      *  Note that in order to use these transformation formulas, the multiplication between TransformationScalar and Scalar should be 'enabled'. See LinearCombination.hpp for an example
      */
     template <typename TransformationScalar = Scalar>
-    void transform(const SquareMatrix<TransformationScalar>& T) {
+    enable_if_t<!(std::is_same<Scalar, double>::value && std::is_same<TransformationScalar, double>::value)> transform(const SquareMatrix<TransformationScalar>& T) {
 
         // Since we're only getting T as a matrix, we should make the appropriate tensor to perform contractions
         // For the const argument, we need the const in the template
@@ -106,6 +179,252 @@ public:
     }
 
 
+    /**
+     *  In-place transform the matrix representation of the two-electron operator. Note that this function is only available for real (double) matrix representations and transformation matrices
+     *
+     *  @tparam TransformationScalar        the type of scalar used for the transformation matrix
+
+     *  @param T    the transformation matrix between the old and the new orbital basis, it is used as
+     *      b' = b T ,
+     *   in which the basis functions are collected as elements of a row vector b
+     *
+     *  The transformation is done as two half-transformations, which each transform the (K x K)-blocks g_rs(p,q) = (pq|rs) to T^T g_rs T with matrix-matrix products on contiguous memory, with a transposition of the (K^2 x K^2)-matrix g(pq,rs) in between. If the integrals are symmetric in p and q (or r and s), only half of the blocks are transformed in the corresponding half-transformation. Apart from the integrals themselves, only one (K^2 x K^2) scratch matrix is needed
+     */
+    template <typename TransformationScalar = Scalar>
+    enable_if_t<std::is_same<Scalar, double>::value && std::is_same<TransformationScalar, double>::value> transform(const SquareMatrix<TransformationScalar>& T) {
+
+        using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+        const auto K = static_cast<size_t>(this->dimension(0));
+        if (T.cols() != K) {
+            throw std::invalid_argument("TwoElectronOperator::transform(SquareMatrix<double>): The given transformation matrix is not compatible with these two-electron integrals.");
+        }
+
+        // When the matrix-matrix products are done by a threaded BLAS (i.e. MKL), the blocks are transformed one after the other
+#ifdef EIGEN_USE_MKL_ALL
+        const size_t number_of_threads = 1;
+#else
+        const size_t number_of_threads = 0;
+#endif
+
+
+        // Since the tensor is stored column-major, it can be viewed (without copying) as a (K^2 x K^2)-matrix g(pq,rs), whose columns are the (K x K)-blocks g_rs
+        Eigen::Map<Matrix> g_matrix (this->data(), K*K, K*K);
+
+        bool symmetric_pq = true;  // if (pq|rs) = (qp|rs)
+        for (size_t rs = 0; (rs < K*K) && symmetric_pq; rs++) {
+            Eigen::Map<const Matrix> g_rs (g_matrix.col(rs).data(), K, K);
+            symmetric_pq = (g_rs == g_rs.transpose());
+        }
+
+        bool symmetric_rs = true;  // if (pq|rs) = (pq|sr)
+        for (size_t r = 0; (r < K) && symmetric_rs; r++) {
+            for (size_t s = 0; (s < r) && symmetric_rs; s++) {
+                symmetric_rs = (g_matrix.col(r + K*s) == g_matrix.col(s + K*r));
+            }
+        }
+
+
+        // Transform the first index pair to get (PQ|rs), and transpose to (rs|PQ), which is still symmetric in r and s if the integrals were symmetric in p and q
+        // Then, transform the index pair rs in the same way, and transpose back to get (PQ|RS)
+        Matrix scratch (K*K, K*K);
+        transformBlocks(g_matrix, T, symmetric_rs, scratch, number_of_threads);
+        transposeInTiles(scratch, g_matrix, number_of_threads);
+
+        transformBlocks(g_matrix, T, symmetric_pq, scratch, number_of_threads);
+        transposeInTiles(scratch, g_matrix, number_of_threads);
+    }
+
+
+    /**
+     *  @param C1                   the (K x n1)-coefficient matrix whose columns are the orbitals of the first index, expanded in the current orbital basis
+     *  @param C2                   the (K x n2)-coefficient matrix whose columns are the orbitals of the second index, expanded in the current orbital basis
+     *  @param C3                   the (K x n3)-coefficient matrix whose columns are the orbitals of the third index, expanded in the current orbital basis
+     *  @param C4                   the (K x n4)-coefficient matrix whose columns are the orbitals of the fourth index, expanded in the current orbital basis
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the (n1 x n2 x n3 x n4)-block of transformed integrals (ab|cd) = C1(p,a) C2(q,b) C3(r,c) C4(s,d) (pq|rs), e.g. (ia|jb) for occupied and virtual orbitals. Note that this function is only available for real (double) matrix representations
+     *
+     *  The block is calculated by four quarter-transformations, which are all matrix-matrix products on contiguous memory. The first one transforms the outer index (the first or the fourth) with the smallest block, so that the cost is O(min(n1, n4) K^4) instead of the O(K^5) of a full transformation
+     */
+    template<typename Z = Scalar>
+    enable_if_t<std::is_same<Z, double>::value, Tensor<double, 4>> calculateTransformedBlock(const MatrixX<double>& C1, const MatrixX<double>& C2, const MatrixX<double>& C3, const MatrixX<double>& C4, size_t number_of_threads = 0) const {
+
+        using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+        const auto K = static_cast<size_t>(this->dimension(0));
+        if ((C1.rows() != K) || (C2.rows() != K) || (C3.rows() != K) || (C4.rows() != K)) {
+            throw std::invalid_argument("TwoElectronOperator::calculateTransformedBlock(MatrixX<double>, MatrixX<double>, MatrixX<double>, MatrixX<double>, size_t): The given coefficient matrices are not compatible with these two-electron integrals.");
+        }
+
+        const auto n1 = static_cast<size_t>(C1.cols());
+        const auto n2 = static_cast<size_t>(C2.cols());
+        const auto n3 = static_cast<size_t>(C3.cols());
+        const auto n4 = static_cast<size_t>(C4.cols());
+
+
+        // Since the tensor is stored column-major, (pq|rs) can be found at position p + K q + K^2 r + K^3 s, so the transformations of the first and the fourth index are matrix-matrix products with a (K x K^3)- or (K^3 x K)-view on the integrals
+        // After both, X2(a + n1 q + n1 K r, d) holds the half-transformed integrals (aq|rd)
+        Matrix X2 (n1*K*K, n4);
+        if (n1 <= n4) {
+            // (pq|rs) -> (aq|rs)
+            Eigen::Map<const Matrix> g_p_qrs (this->data(), K, K*K*K);
+            Matrix X1 (n1, K*K*K);
+            parallelFor(K*K*K, number_of_threads, [&C1, &g_p_qrs, &X1] (size_t start, size_t end) {
+                X1.middleCols(start, end - start).noalias() = C1.transpose() * g_p_qrs.middleCols(start, end - start);
+            });
+
+            // (aq|rs) -> (aq|rd)
+            Eigen::Map<const Matrix> X1_aqr_s (X1.data(), n1*K*K, K);
+            parallelFor(n1*K*K, number_of_threads, [&C4, &X1_aqr_s, &X2] (size_t start, size_t end) {
+                X2.middleRows(start, end - start).noalias() = X1_aqr_s.middleRows(start, end - start) * C4;
+            });
+
+        } else {
+            // (pq|rs) -> (pq|rd)
+            Eigen::Map<const Matrix> g_pqr_s (this->data(), K*K*K, K);
+            Matrix X1 (K*K*K, n4);
+            parallelFor(K*K*K, number_of_threads, [&C4, &g_pqr_s, &X1] (size_t start, size_t end) {
+                X1.middleRows(start, end - start).noalias() = g_pqr_s.middleRows(start, end - start) * C4;
+            });
+
+            // (pq|rd) -> (aq|rd)
+            Eigen::Map<const Matrix> X1_p_qrd (X1.data(), K, K*K*n4);
+            Eigen::Map<Matrix> X2_a_qrd (X2.data(), n1, K*K*n4);
+            parallelFor(K*K*n4, number_of_threads, [&C1, &X1_p_qrd, &X2_a_qrd] (size_t start, size_t end) {
+                X2_a_qrd.middleCols(start, end - start).noalias() = C1.transpose() * X1_p_qrd.middleCols(start, end - start);
+            });
+        }
+
+
+        // (aq|rd) -> (aq|cd): for every d, the integrals form an (n1 K x K)-matrix (aq, r)
+        Matrix X3 (n1*K*n3, n4);  // X3(a + n1 q + n1 K c, d) = (aq|cd)
+        parallelFor(n4, number_of_threads, [&C3, &X2, &X3, n1, n3, K] (size_t start, size_t end) {
+            for (size_t d = start; d < end; d++) {
+                Eigen::Map<const Matrix> X2_aq_r (X2.col(d).data(), n1*K, K);
+                Eigen::Map<Matrix> X3_aq_c (X3.col(d).data(), n1*K, n3);
+                X3_aq_c.noalias() = X2_aq_r * C3;
+            }
+        });
+
+
+        // (aq|cd) -> (ab|cd): for every c and d, the integrals form an (n1 x K)-matrix (a, q)
+        Tensor<double, 4> block (n1, n2, n3, n4);
+        parallelFor(n3*n4, number_of_threads, [&C2, &X3, &block, n1, n2, K] (size_t start, size_t end) {
+            for (size_t cd = start; cd < end; cd++) {
+                Eigen::Map<const Matrix> X3_a_q (X3.data() + cd*n1*K, n1, K);
+                Eigen::Map<Matrix> block_a_b (block.data() + cd*n1*n2, n1, n2);
+                block_a_b.noalias() = X3_a_q * C2;
+            }
+        });
+
+        return block;
+    }
+
+
+    /**
+     *  @param D                    the (density) matrices
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the Coulomb matrices J(p,q) = (pq|rs) D(s,r) for every given matrix D
+     *
+     *  The two-electron integrals are viewed (without copying) as a (K^2 x K^2)-matrix g(pq,rs), so that all Coulomb matrices are calculated in one matrix-matrix product with the vectorized matrices D, which is distributed over the threads in blocks of rows
+     */
+    std::vector<SquareMatrix<Scalar>> calculateCoulomb(const std::vector<SquareMatrix<Scalar>>& D, size_t number_of_threads = 0) const {
+
+        using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+        const auto K = static_cast<size_t>(this->dimension(0));
+        const auto number_of_matrices = D.size();
+
+        // Gather the vectorized transposed matrices vec(D^T)(r + K s) = D(s,r) in the columns of one matrix
+        Matrix D_vectors (K*K, number_of_matrices);
+        for (size_t i = 0; i < number_of_matrices; i++) {
+            if (D[i].cols() != K) {
+                throw std::invalid_argument("TwoElectronOperator::calculateCoulomb(std::vector<SquareMatrix<Scalar>>, size_t): One of the given matrices is not compatible with these two-electron integrals.");
+            }
+            Eigen::Map<Matrix> (D_vectors.col(i).data(), K, K) = D[i].transpose();
+        }
+
+
+        // Since the tensor is stored column-major, (pq|rs) can be found at position (p + K q) + K^2 (r + K s)
+        Eigen::Map<const Matrix> g_matrix (this->data(), K*K, K*K);
+        Matrix J_vectors (K*K, number_of_matrices);
+        parallelFor(K*K, number_of_threads, [&g_matrix, &D_vectors, &J_vectors] (size_t start, size_t end) {
+            J_vectors.middleRows(start, end - start).noalias() = g_matrix.middleRows(start, end - start) * D_vectors;
+        });
+
+
+        std::vector<SquareMatrix<Scalar>> J;
+        J.reserve(number_of_matrices);
+        for (size_t i = 0; i < number_of_matrices; i++) {
+            J.emplace_back(Matrix(Eigen::Map<const Matrix>(J_vectors.col(i).data(), K, K)));
+        }
+        return J;
+    }
+
+    /**
+     *  @param D                    a (density) matrix
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the Coulomb matrix J(p,q) = (pq|rs) D(s,r)
+     */
+    SquareMatrix<Scalar> calculateCoulomb(const SquareMatrix<Scalar>& D, size_t number_of_threads = 0) const {
+        return this->calculateCoulomb(std::vector<SquareMatrix<Scalar>> {D}, number_of_threads).front();
+    }
+
+    /**
+     *  @param D                    the (density) matrices
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the exchange matrices K(p,q) = (pr|sq) D(r,s) for every given matrix D
+     *
+     *  For every q, the integrals (pr|sq) are a contiguous block of the tensor that is viewed (without copying) as a (K x K^2)-matrix, so that the columns q of all exchange matrices are calculated in one matrix-matrix product with the vectorized matrices D. The columns q are distributed over the threads
+     */
+    std::vector<SquareMatrix<Scalar>> calculateExchange(const std::vector<SquareMatrix<Scalar>>& D, size_t number_of_threads = 0) const {
+
+        using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+        const auto K = static_cast<size_t>(this->dimension(0));
+        const auto number_of_matrices = D.size();
+
+        // Gather the vectorized matrices vec(D)(r + K s) = D(r,s) in the columns of one matrix
+        Matrix D_vectors (K*K, number_of_matrices);
+        for (size_t i = 0; i < number_of_matrices; i++) {
+            if (D[i].cols() != K) {
+                throw std::invalid_argument("TwoElectronOperator::calculateExchange(std::vector<SquareMatrix<Scalar>>, size_t): One of the given matrices is not compatible with these two-electron integrals.");
+            }
+            Eigen::Map<Matrix> (D_vectors.col(i).data(), K, K) = D[i];
+        }
+
+
+        std::vector<SquareMatrix<Scalar>> K_matrices (number_of_matrices, SquareMatrix<Scalar>::Zero(K, K));
+        parallelFor(K, number_of_threads, [this, K, number_of_matrices, &D_vectors, &K_matrices] (size_t start, size_t end) {
+            Matrix K_columns (K, number_of_matrices);
+            for (size_t q = start; q < end; q++) {
+                Eigen::Map<const Matrix> g_slice (this->data() + q*K*K*K, K, K*K);  // g_slice(p, r + K s) = (pr|sq)
+                K_columns.noalias() = g_slice * D_vectors;
+
+                for (size_t i = 0; i < number_of_matrices; i++) {
+                    K_matrices[i].col(q) = K_columns.col(i);
+                }
+            }
+        });
+
+        return K_matrices;
+    }
+
+    /**
+     *  @param D                    a (density) matrix
+     *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+     *
+     *  @return the exchange matrix K(p,q) = (pr|sq) D(r,s)
+     */
+    SquareMatrix<Scalar> calculateExchange(const SquareMatrix<Scalar>& D, size_t number_of_threads = 0) const {
+        return this->calculateExchange(std::vector<SquareMatrix<Scalar>> {D}, number_of_threads).front();
+    }
+
+
     using Operator<TwoElectronOperator<Scalar>>::rotate;  // bring over rotate() from the base class
 
 
@@ -117,14 +436,39 @@ public:
     template<typename Z = Scalar>
     enable_if_t<std::is_same<Z, double>::value> rotate(const JacobiRotationParameters& jacobi_rotation_parameters) {
 
-        /**
-         *  While waiting for an analogous Eigen::Tensor Jacobi module, we implement this rotation by constructing a Jacobi rotation matrix and then doing a rotation with it
-         */
+        using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+        const auto K = static_cast<size_t>(this->dimension(0));
+        const auto p = jacobi_rotation_parameters.get_p();
+        const auto q = jacobi_rotation_parameters.get_q();
+
+        const double c = std::cos(jacobi_rotation_parameters.get_angle());
+        const double s = std::sin(jacobi_rotation_parameters.get_angle());
+        Eigen::JacobiRotation<double> jacobi (c, s);
+
+
+        // A Jacobi rotation only mixes the orbitals p and q, so we can use Eigen's Jacobi module to apply it to every index of the tensor in place, which only touches O(K^3) integrals
+        // Since the tensor is stored column-major, (ab|cd) can be found at position a + K b + K^2 c + K^3 d
+
+        // Rotate the fourth index: view the tensor as a (K^3 x K)-matrix
+        Eigen::Map<Matrix> g_abc_d (this->data(), K*K*K, K);
+        g_abc_d.applyOnTheRight(p, q, jacobi);
+
+        // Rotate the third index: for every d, view the integrals as a (K^2 x K)-matrix
+        for (size_t d = 0; d < K; d++) {
+            Eigen::Map<Matrix> g_ab_c (this->data() + d*K*K*K, K*K, K);
+            g_ab_c.applyOnTheRight(p, q, jacobi);
+        }
 
-        auto dim = static_cast<size_t>(this->dimension(0));  // .dimension() returns a long
-        auto J = SquareMatrix<double>::FromJacobi(jacobi_rotation_parameters, dim);  // this is sure to return a unitary matrix
+        // Rotate the second index: for every c and d, view the integrals as a (K x K)-matrix
+        for (size_t cd = 0; cd < K*K; cd++) {
+            Eigen::Map<Matrix> g_a_b (this->data() + cd*K*K, K, K);
+            g_a_b.applyOnTheRight(p, q, jacobi);
+        }
 
-        this->rotate(J);
+        // Rotate the first index: view the tensor as a (K x K^3)-matrix (cfr. T.adjoint() * M)
+        Eigen::Map<Matrix> g_a_bcd (this->data(), K, K*K*K);
+        g_a_bcd.applyOnTheLeft(p, q, jacobi.adjoint());
     }
 };
 
@@ -25,12 +25,28 @@
 namespace GQCP {
 
 
+/**
+ *  An enum class for the ways in which an orbital rotation step is calculated from the orbital gradient and Hessian
+ */
+enum class OrbitalOptimizationStep {
+    NEWTON,  // a Newton step, for which the dense orbital Hessian is built and diagonalized in every iteration
+    TRUST_REGION_NEWTON,  // a truncated conjugate gradient (Steihaug) step within a trust region, for which only orbital Hessian-vector products are needed
+    DIAGONAL_HESSIAN,  // a quasi-Newton step with the (exact) diagonal of the orbital Hessian
+    L_BFGS  // a quasi-Newton step with the limited-memory BFGS update of the diagonal of the orbital Hessian, which is built from the orbital gradients of the previous iterations
+};
+
+
 /**
  *  A struct that holds options for orbital optimization
  */
 struct OrbitalOptimizationOptions {
     double convergence_threshold = 1.0e-08;
     size_t maximum_number_of_iterations = 128;
+
+    OrbitalOptimizationStep step_type = OrbitalOptimizationStep::NEWTON;
+    double trust_region_radius = 0.5;  // the initial radius of the trust region (i.e. the maximum norm of a step), for all but NEWTON steps
+    double maximum_trust_region_radius = 2.0;  // the radius up to which the trust region can grow, for all but NEWTON steps
+    size_t maximum_history_size = 8;  // the number of previous steps and gradients that is used in the L_BFGS update
 };
 
 
@@ -48,6 +48,19 @@ public:
      *  @param maximum_number_of_iterations     the maximum number of iterations for the SCF procedure
      */
     PlainRHFSCFSolver(const HamiltonianParameters<double>& ham_par, const Molecule& molecule, double threshold=1.0e-08, size_t maximum_number_of_iterations=128);
+
+    /**
+     *  Set up an integral-direct SCF calculation, which only needs O(K^2) memory
+     *
+     *  @param ao_basis                         the AO basis in which the SCF calculation is done
+     *  @param molecule                         the molecule used for the SCF calculation
+     *  @param threshold                        the convergence treshold on the Frobenius norm on the AO density matrix
+     *  @param maximum_number_of_iterations     the maximum number of iterations for the SCF procedure
+     *  @param screening_threshold              the threshold on the product of the Schwarz bounds of two shell pairs and the largest density matrix element they are contracted with, below which their shell quartet isn't computed
+     *  @param number_of_threads                the number of threads that calculate the shell quartets, or 0 to use all available hardware threads
+     *  @param maximum_incremental_builds       the maximum number of consecutive incremental (difference-density) Fock matrix builds before the Fock matrix is rebuilt from the full density matrix, or 0 to always do full builds
+     */
+    PlainRHFSCFSolver(std::shared_ptr<AOBasis> ao_basis, const Molecule& molecule, double threshold=1.0e-08, size_t maximum_number_of_iterations=128, double screening_threshold=1.0e-12, size_t number_of_threads=0, size_t maximum_incremental_builds=8);
 };
 
 
@@ -20,6 +20,7 @@
 
 
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "Operator/FactorizedTwoElectronOperator.hpp"
 #include "RDM/OneRDM.hpp"
 
 
@@ -83,12 +84,24 @@ OneRDM<double> calculateRHFAO1RDM(const SquareMatrix<double>& C, size_t N);
 /**
  *  Calculate the RHF Fock matrix F = H_core + G, in which G is a contraction of the density matrix and the two-electron integrals
  *
- *  @param D_AO     the RHF density matrix in AO basis
- *  @param ham_par  The Hamiltonian parameters in AO basis
+ *  @param D_AO                 the RHF density matrix in AO basis
+ *  @param ham_par              The Hamiltonian parameters in AO basis
+ *  @param number_of_threads    the number of threads for the contractions, or 0 to use all available hardware threads
  *
  *  @return the RHF Fock matrix expressed in the AO basis
  */
-OneElectronOperator<double> calculateRHFAOFockMatrix(const OneRDM<double>& D_AO, const HamiltonianParameters<double>& ham_par);
+OneElectronOperator<double> calculateRHFAOFockMatrix(const OneRDM<double>& D_AO, const HamiltonianParameters<double>& ham_par, size_t number_of_threads = 0);
+
+/**
+ *  Calculate the RHF Fock matrix F = H_core + G from factorized (density-fitted or Cholesky-decomposed) two-electron integrals
+ *
+ *  @param D_AO         the RHF density matrix in AO basis
+ *  @param H_core_AO    the core Hamiltonian parameters in AO basis
+ *  @param g_AO         the factorized two-electron integrals in AO basis
+ *
+ *  @return the RHF Fock matrix expressed in the AO basis
+ */
+OneElectronOperator<double> calculateRHFAOFockMatrix(const OneRDM<double>& D_AO, const OneElectronOperator<double>& H_core_AO, const FactorizedTwoElectronOperator& g_AO);
 
 /**
  *  @param D_AO         the RHF density matrix in AO basis
@@ -19,9 +19,13 @@
 #define RHFSCFSolver_hpp
 
 
+#include "Basis/AOBasis.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 #include "RHF.hpp"
 #include "Molecule.hpp"
+#include "Observer/ObservableSolver.hpp"
+
+#include <memory>
 
 
 namespace GQCP {
@@ -31,14 +35,30 @@ namespace GQCP {
  *  Base class for RHF SCF solvers. This class contains the solve()-method, which does the RHF SCF procedure.
  *
  *  Derived classes should implement the pure virtual function calculateNewFockMatrix().
+ *
+ *  The two-electron part of the Fock matrix is either contracted from the in-core two-electron integrals of the given Hamiltonian parameters, or calculated integral-direct from an AO basis: then the shell quartets are recalculated in every iteration and the AO two-electron integrals are never stored.
+ *
+ *  Integral-direct Fock matrices are built incrementally: F(D_k) = F(D_{k-1}) + G(D_k - D_{k-1}), in which the density screening drops most of the shell quartets once the density matrix changes little. To control the accumulation of screening errors, the Fock matrix is periodically rebuilt from the full density matrix.
  */
-class RHFSCFSolver {
+class RHFSCFSolver : public ObservableSolver {
 protected:
     size_t maximum_number_of_iterations;
     double threshold;
     bool is_converged = false;
 
-    HamiltonianParameters<double> ham_par;  // Hamiltonian parameters expressed in an AO basis
+    OneElectronOperator<double> S;  // the overlap integrals in AO basis
+    OneElectronOperator<double> H_core;  // the core Hamiltonian in AO basis
+    std::shared_ptr<const HamiltonianParameters<double>> ham_par;  // Hamiltonian parameters expressed in an AO basis, nullptr for an integral-direct calculation
+    std::shared_ptr<AOBasis> ao_basis;  // the AO basis whose shell quartets are recalculated in every iteration of an integral-direct calculation
+    double screening_threshold = 0.0;  // the threshold for the Schwarz and density screening of the shell quartets in an integral-direct calculation
+    size_t number_of_threads = 0;  // the number of threads for an integral-direct calculation, 0 meaning all available hardware threads
+    size_t maximum_incremental_builds = 0;  // the maximum number of consecutive incremental Fock matrix builds before a full rebuild, 0 meaning that every build is a full one
+
+    size_t number_of_incremental_builds = 0;  // the number of incremental Fock matrix builds since the last full one
+    OneRDM<double> D_AO_last_build;  // the density matrix of the last integral-direct Fock matrix build
+    OneElectronOperator<double> F_AO_last_build;  // the Fock matrix of the last integral-direct build
+    size_t number_of_computed_quartets = 0;  // the number of (canonical) shell quartets that were calculated in the last Fock matrix build
+    size_t number_of_skipped_quartets = 0;  // the number of (canonical) shell quartets that were skipped in the last Fock matrix build
     Molecule molecule;
 
     RHF solution;
@@ -54,6 +74,13 @@ protected:
      */
     virtual OneElectronOperator<double> calculateNewFockMatrix(const OneRDM<double>& D_AO) = 0;
 
+    /**
+     *  @param D_AO     the RHF density matrix in AO basis
+     *
+     *  @return the RHF Fock matrix F = H_core + G (expressed in AO basis), in which G is calculated (incrementally) integral-direct if no in-core Hamiltonian parameters were given
+     */
+    OneElectronOperator<double> calculateFockMatrix(const OneRDM<double>& D_AO);
+
 public:
     // CONSTRUCTORS
     /**
@@ -64,11 +91,26 @@ public:
      */
     RHFSCFSolver(const HamiltonianParameters<double>& ham_par, const Molecule& molecule, double threshold=1.0e-08, size_t maximum_number_of_iterations=128);
 
+    /**
+     *  Set up an integral-direct SCF calculation, which only needs O(K^2) memory
+     *
+     *  @param ao_basis                         the AO basis in which the SCF calculation is done
+     *  @param molecule                         the molecule used for the SCF calculation
+     *  @param threshold                        the convergence treshold on the Frobenius norm on the AO density matrix
+     *  @param maximum_number_of_iterations     the maximum number of iterations for the SCF procedure
+     *  @param screening_threshold              the threshold on the product of the Schwarz bounds of two shell pairs and the largest density matrix element they are contracted with, below which their shell quartet isn't computed
+     *  @param number_of_threads                the number of threads that calculate the shell quartets, or 0 to use all available hardware threads
+     *  @param maximum_incremental_builds       the maximum number of consecutive incremental (difference-density) Fock matrix builds before the Fock matrix is rebuilt from the full density matrix, or 0 to always do full builds
+     */
+    RHFSCFSolver(std::shared_ptr<AOBasis> ao_basis, const Molecule& molecule, double threshold=1.0e-08, size_t maximum_number_of_iterations=128, double screening_threshold=1.0e-12, size_t number_of_threads=0, size_t maximum_incremental_builds=8);
+
     // GETTERS
     const RHF& get_solution() const { return this->solution; }
 
     /**
      *  Solve the RHF SCF equations
+     *
+     *  After every iteration, the attached observers are notified with the change in the density matrix, the electronic energy and the time spent in the Fock matrix build
      */
     void solve();
 };
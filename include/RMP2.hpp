@@ -35,6 +35,15 @@ namespace GQCP {
  */
 double calculateRMP2EnergyCorrection(const HamiltonianParameters<double>& ham_par, const Molecule& molecule, const RHF& rhf);
 
+/**
+ *  @param g            the two-electron integrals in the (AO) basis in which the RHF SCF equations were solved
+ *  @param molecule     the molecule for which the energy correction should be calculated
+ *  @param rhf          the converged solution to the RHF SCF equations
+ *
+ *  @return the RMP2 energy correction, for which only the integrals (ia|jb) are transformed to the RHF MO basis
+ */
+double calculateRMP2EnergyCorrection(const TwoElectronOperator<double>& g, const Molecule& molecule, const RHF& rhf);
+
 
 }  // namespace GQCP
 
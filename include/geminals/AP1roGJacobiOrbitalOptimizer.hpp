@@ -20,6 +20,7 @@
 
 
 #include "geminals/BaseAP1roGSolver.hpp"
+#include "Observer/ObservableSolver.hpp"
 
 
 namespace GQCP {
@@ -30,7 +31,7 @@ namespace GQCP {
  *
  *  By using analytical Jacobi rotations, and subsequently re-solving the AP1roG PSEs, a new orbital basis is found that (hopefully) results in a lower AP1roG energy.
  */
-class AP1roGJacobiOrbitalOptimizer : public BaseAP1roGSolver {
+class AP1roGJacobiOrbitalOptimizer : public BaseAP1roGSolver, public ObservableSolver {
 private:
     // PRIVATE STRUCTS
     /**
@@ -125,6 +126,8 @@ public:
      *  Optimize the AP1roG energy by consequently
      *      - solving the AP1roG equations
      *      - finding the optimal Jacobi transformation (i.e. the one that yields the lowest energy)
+     *
+     *  After every iteration, the attached observers are notified with the energy change, the AP1roG energy and the time spent in the PSE solver
      */
     void solve() override;
 };
@@ -60,15 +60,25 @@
 #include "HamiltonianBuilder/Hubbard.hpp"
 #include "HamiltonianBuilder/SelectedCI.hpp"
 
+#include "HamiltonianParameters/AOIntegralCache.hpp"
 #include "HamiltonianParameters/BaseHamiltonianParameters.hpp"
+#include "HamiltonianParameters/FCIDUMP.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 
 #include "Localization/BaseERLocalizer.hpp"
 #include "Localization/ERJacobiLocalizer.hpp"
 #include "Localization/ERNewtonLocalizer.hpp"
 
+#include "Observer/BaseIterationObserver.hpp"
+#include "Observer/IterationHistory.hpp"
+#include "Observer/IterationRecord.hpp"
+#include "Observer/JSONLinesObserver.hpp"
+#include "Observer/ObservableSolver.hpp"
+
+#include "Operator/FactorizedTwoElectronOperator.hpp"
 #include "Operator/OneElectronOperator.hpp"
 #include "Operator/Operator.hpp"
+#include "Operator/PackedTwoElectronOperator.hpp"
 #include "Operator/TwoElectronOperator.hpp"
 
 #include "math/optimization/BaseEigenproblemSolver.hpp"
@@ -76,8 +86,11 @@
 #include "math/optimization/BaseMinimizer.hpp"
 #include "math/optimization/BaseSystemOfEquationsSolver.hpp"
 #include "math/optimization/DavidsonSolver.hpp"
+#include "math/optimization/DavidsonSubspace.hpp"
 #include "math/optimization/Eigenpair.hpp"
 #include "math/optimization/EigenproblemSolverOptions.hpp"
+#include "math/optimization/IterativeLinearSolver.hpp"
+#include "math/optimization/LimitedMemoryBFGS.hpp"
 #include "math/optimization/NewtonMinimizer.hpp"
 #include "math/optimization/NewtonSystemOfEquationsSolver.hpp"
 #include "math/optimization/SparseSolver.hpp"
@@ -23,9 +23,12 @@
 #include "math/optimization/EigenproblemSolverOptions.hpp"
 
 #include "math/SquareMatrix.hpp"
+#include "Observer/ObservableSolver.hpp"
 
 #include "typedefs.hpp"
 
+#include <chrono>
+
 
 
 namespace GQCP {
@@ -34,7 +37,7 @@ namespace GQCP {
  *  A class that implements the Davidson algorithm for finding the lowest eigenpair of a (possibly large) diagonally-
  *  dominant symmetric matrix
  */
-class DavidsonSolver : public BaseEigenproblemSolver {
+class DavidsonSolver : public BaseEigenproblemSolver, public ObservableSolver {
 private:
     double convergence_threshold;  // the tolerance on the norm of the residual vector
     double correction_threshold;  // the threshold used in solving the (approximated) residue correction equation
@@ -43,10 +46,79 @@ private:
     size_t maximum_number_of_iterations;
     size_t number_of_iterations = 0;
 
+    SubspacePrecision subspace_precision;  // the precision in which the subspace vectors are stored
+    double refinement_threshold;  // the residual norm at which single-precision iterations hand over to the double-precision refinement
+
+    SubspaceStorage subspace_storage;  // where the (double-precision) subspace vectors are stored
+    std::string scratch_directory;  // the directory for the scratch files of a memory-mapped subspace
+
     VectorFunction matrixVectorProduct;
     VectorX<double> diagonal;  // the diagonal of the matrix in question
     MatrixX<double> V_0;  // the set of initial guesses (every column is an initial guess)
 
+    static constexpr size_t block_size = 4096;  // the number of rows that is converted to double precision at once in the single-precision kernels
+
+
+    // PRIVATE METHODS
+    /**
+     *  @param r            a residual vector
+     *  @param lambda       the corresponding eigenvalue estimate
+     *
+     *  @return the normalized correction vector, i.e. the solution of the (diagonally approximated) residue correction equation
+     */
+    VectorX<double> calculateCorrectionVector(const VectorX<double>& r, double lambda) const;
+
+    /**
+     *  @param x            the vector that should be multiplied
+     *  @param record       the record of the current iteration, in which the cost of the matrix-vector product is accumulated
+     *
+     *  @return the (expensive) matrix-vector product of the matrix with x
+     */
+    VectorX<double> calculateMatrixVectorProduct(const VectorX<double>& x, IterationRecord& record) const;
+
+    /**
+     *  Finish the record of the current iteration, notify the attached observers and prepare the record and start time for the next iteration
+     *
+     *  @param record       the record of the current iteration
+     *  @param start        the time at which the current iteration started
+     */
+    void notifyIteration(IterationRecord& record, std::chrono::steady_clock::time_point& start) const;
+
+    /**
+     *  Do Davidson iterations with the subspace vectors and their matrix-vector products stored in single precision, until all residual norms drop below the refinement threshold
+     *
+     *  @return the (dim x number_of_requested_eigenpairs)-matrix of Ritz vectors, which serve as initial guesses for the double-precision refinement
+     */
+    MatrixX<double> iterateInSinglePrecision();
+
+
+    // PRIVATE STATIC METHODS - SINGLE-PRECISION KERNELS
+    /**
+     *  @param V        a (dim x m)-matrix stored in single precision
+     *  @param Z        a (m x n)-matrix
+     *
+     *  @return the product V * Z, accumulated in double precision over blocks of rows of V
+     */
+    template <typename Derived>
+    static MatrixX<double> multiply(const MatrixX<float>& V, const Eigen::MatrixBase<Derived>& Z);
+
+    /**
+     *  @param V        a (dim x m)-matrix stored in single precision
+     *  @param W        a (dim x n)-matrix
+     *
+     *  @return the product V^T * W, accumulated in double precision over blocks of rows of V and W
+     */
+    template <typename Derived>
+    static MatrixX<double> transposeMultiply(const MatrixX<float>& V, const Eigen::MatrixBase<Derived>& W);
+
+    /**
+     *  @param V        a (dim x m)-matrix stored in single precision
+     *  @param Y        a (m x c)-matrix whose columns define the collapsed subspace
+     *
+     *  @return the collapsed (dim x c)-matrix V * Y in single precision, calculated without a full double-precision intermediate
+     */
+    static MatrixX<float> collapse(const MatrixX<float>& V, const MatrixX<double>& Y);
+
 
 public:
     // CONSTRUCTORS
@@ -60,8 +132,12 @@ public:
      *  @param maximum_subspace_dimension           the maximum dimension of the Davidson subspace before collapsing
      *  @param collapsed_subspace_dimension         the dimension of the subspace after collapse
      *  @param maximum_number_of_iterations         the maximum number of Davidson iterations
+     *  @param subspace_precision                   the precision in which the subspace vectors are stored
+     *  @param refinement_threshold                 the residual norm at which single-precision iterations hand over to the double-precision refinement
+     *  @param subspace_storage                     where the (double-precision) subspace vectors are stored
+     *  @param scratch_directory                    the directory for the scratch files of a memory-mapped subspace
      */
-    DavidsonSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs = 1, double convergence_threshold = 1.0e-08, double correction_threshold = 1.0e-12, size_t maximum_subspace_dimension = 15, size_t collapsed_subspace_dimension = 2, size_t maximum_number_of_iterations = 128);
+    DavidsonSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs = 1, double convergence_threshold = 1.0e-08, double correction_threshold = 1.0e-12, size_t maximum_subspace_dimension = 15, size_t collapsed_subspace_dimension = 2, size_t maximum_number_of_iterations = 128, SubspacePrecision subspace_precision = SubspacePrecision::DOUBLE, double refinement_threshold = 1.0e-04, SubspaceStorage subspace_storage = SubspaceStorage::IN_CORE, const std::string& scratch_directory = "/tmp");
 
     /**
      *  @param A                                    the matrix to be diagonalized
@@ -72,8 +148,12 @@ public:
      *  @param maximum_subspace_dimension           the maximum dimension of the Davidson subspace before collapsing
      *  @param collapsed_subspace_dimension         the dimension of the subspace after collapse
      *  @param maximum_number_of_iterations         the maximum number of Davidson iterations
+     *  @param subspace_precision                   the precision in which the subspace vectors are stored
+     *  @param refinement_threshold                 the residual norm at which single-precision iterations hand over to the double-precision refinement
+     *  @param subspace_storage                     where the (double-precision) subspace vectors are stored
+     *  @param scratch_directory                    the directory for the scratch files of a memory-mapped subspace
      */
-    DavidsonSolver(const SquareMatrix<double>& A, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs = 1, double convergence_threshold = 1.0e-08, double correction_threshold = 1.0e-12, size_t maximum_subspace_dimension = 15, size_t collapsed_subspace_dimension = 2, size_t maximum_number_of_iterations = 128);
+    DavidsonSolver(const SquareMatrix<double>& A, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs = 1, double convergence_threshold = 1.0e-08, double correction_threshold = 1.0e-12, size_t maximum_subspace_dimension = 15, size_t collapsed_subspace_dimension = 2, size_t maximum_number_of_iterations = 128, SubspacePrecision subspace_precision = SubspacePrecision::DOUBLE, double refinement_threshold = 1.0e-04, SubspaceStorage subspace_storage = SubspaceStorage::IN_CORE, const std::string& scratch_directory = "/tmp");
 
     /**
      *  @param matrixVectorProduct          a vector function that returns the matrix-vector product (i.e. the matrix-vector product representation of the matrix)
@@ -105,6 +185,11 @@ public:
      *  If successful, it sets
      *      - _is_solved to true
      *      - the number of requested eigenpairs
+     *
+     *  If the subspace precision is single, the double-precision iterations start from the Ritz vectors of the single-precision iterations
+     *  If the subspace storage is memory-mapped, the double-precision subspace vectors and their matrix-vector products are kept in scratch files
+     *
+     *  After every iteration, the attached observers are notified with the diagnostics of that iteration
      */
     void solve() override;
 };
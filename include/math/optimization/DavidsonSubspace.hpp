@@ -0,0 +1,160 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_DAVIDSONSUBSPACE_HPP
+#define GQCP_DAVIDSONSUBSPACE_HPP
+
+
+#include "math/optimization/EigenproblemSolverOptions.hpp"
+
+#include "math/Matrix.hpp"
+
+#include <string>
+#include <vector>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  A fixed-capacity set of (dim)-dimensional column vectors that span a Davidson subspace
+ *
+ *  The columns are stored contiguously (column-major), either in core or in a memory-mapped scratch file. All products with the stored columns are done by streaming over blocks of rows, so that a memory-mapped subspace can be (much) larger than the available memory.
+ *
+ *  The storage for the full capacity is reserved (but not written) at construction, so only the columns that have actually been appended occupy memory
+ */
+class DavidsonSubspace {
+private:
+    size_t dim;  // the dimension of the column vectors
+    size_t capacity;  // the maximum number of columns that can be stored
+    size_t number_of_columns = 0;
+    size_t number_of_allocated_columns = 0;  // the largest number of columns that has been stored at once
+
+    std::vector<double> buffer;  // the in-core storage, empty if the columns are memory-mapped
+    int file_descriptor = -1;  // the descriptor of the (already unlinked) scratch file, -1 if the columns are stored in core
+    double* data = nullptr;  // the start of the column-major storage
+
+    static constexpr size_t block_size = 65536;  // the number of rows that is streamed at once
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param dim                  the dimension of the column vectors
+     *  @param capacity             the maximum number of columns that can be stored
+     *  @param storage              where the columns should be stored
+     *  @param scratch_directory    the directory in which the scratch file is created for memory-mapped storage, preferably on a fast local disk
+     *
+     *  A memory-mapped scratch file is removed from the file system right after its creation, so it disappears together with this subspace
+     */
+    DavidsonSubspace(size_t dim, size_t capacity, SubspaceStorage storage = SubspaceStorage::IN_CORE, const std::string& scratch_directory = "/tmp");
+
+    DavidsonSubspace(const DavidsonSubspace& other) = delete;
+    DavidsonSubspace& operator=(const DavidsonSubspace& other) = delete;
+
+
+    // DESTRUCTOR
+    ~DavidsonSubspace();
+
+
+    // GETTERS
+    size_t rows() const { return this->dim; }
+    size_t cols() const { return this->number_of_columns; }
+    bool is_memory_mapped() const { return this->file_descriptor != -1; }
+    size_t allocated_bytes() const { return this->number_of_allocated_columns * this->dim * sizeof(double); }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return a read-only view on the stored columns
+     */
+    Eigen::Map<const Eigen::MatrixXd> matrix() const;
+
+    /**
+     *  @param j            the index of the column
+     *
+     *  @return a copy of the j-th column
+     */
+    VectorX<double> column(size_t j) const;
+
+    /**
+     *  @param j            the index of the column
+     *  @param v            the (dim)-dimensional vector in which a copy of the j-th column is stored, without allocating
+     */
+    void column(size_t j, VectorX<double>& v) const;
+
+    /**
+     *  Append a (scaled) column vector
+     *
+     *  @param v            the column vector that should be appended
+     *  @param scaling      the factor with which v is multiplied before it is stored
+     */
+    void append(const VectorX<double>& v, double scaling = 1.0);
+
+    /**
+     *  @param w            a (dim)-dimensional vector
+     *
+     *  @return the product V^T w, streaming once over every stored column
+     */
+    VectorX<double> transposeMultiply(const VectorX<double>& w) const;
+
+    /**
+     *  @param w            a (dim)-dimensional vector
+     *  @param result       the vector in which the product V^T w is stored, without allocating; its size should be the number of stored columns
+     */
+    void transposeMultiply(const VectorX<double>& w, Eigen::Ref<Eigen::VectorXd> result) const;
+
+    /**
+     *  @param Z            a (cols x n)-matrix
+     *
+     *  @return the (dim x n)-matrix V Z, streaming over blocks of rows
+     */
+    MatrixX<double> multiply(const MatrixX<double>& Z) const;
+
+    /**
+     *  @param z            a vector whose size is at most the number of stored columns
+     *  @param result       the (dim)-dimensional vector in which the product of the first z.size() columns with z is stored, without allocating
+     */
+    void multiply(const Eigen::Ref<const Eigen::VectorXd>& z, VectorX<double>& result) const;
+
+    /**
+     *  Subtract the product of the first z.size() columns with z from the given vector, streaming over blocks of rows
+     *
+     *  @param z            a vector whose size is at most the number of stored columns
+     *  @param w            the (dim)-dimensional vector from which V z is subtracted
+     */
+    void subtractProduct(const Eigen::Ref<const Eigen::VectorXd>& z, VectorX<double>& w) const;
+
+    /**
+     *  Replace the stored columns by the linear combinations V Y, in place and streaming over blocks of rows
+     *
+     *  @param Y            a (cols x c)-matrix whose columns define the collapsed subspace
+     */
+    void collapse(const MatrixX<double>& Y);
+
+    /**
+     *  Remove all stored columns, keeping the allocated storage
+     */
+    void clear() { this->number_of_columns = 0; }
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_DAVIDSONSUBSPACE_HPP
@@ -20,9 +20,13 @@
 
 
 #include "math/Matrix.hpp"
+#include "Observer/BaseIterationObserver.hpp"
 
 #include <cstddef>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 
 namespace GQCP {
@@ -39,6 +43,26 @@ enum class SolverType {
 
 
 
+/**
+ *  An enum class for the precision in which the Davidson subspace vectors (and their matrix-vector products) are stored
+ */
+enum class SubspacePrecision {
+    DOUBLE,
+    SINGLE  // store the subspace in float, accumulate in double and finish with a double-precision refinement
+};
+
+
+
+/**
+ *  An enum class for the location where the (double-precision) Davidson subspace vectors (and their matrix-vector products) are stored
+ */
+enum class SubspaceStorage {
+    IN_CORE,
+    MEMORY_MAPPED  // store the subspace in a memory-mapped scratch file, for subspaces that don't fit in memory
+};
+
+
+
 /**
  *  A base struct to specify eigenproblem solver options, whose derived structs can be used with the eigenproblem solvers
  */
@@ -89,10 +113,23 @@ public:
     size_t collapsed_subspace_dimension = 2;
     size_t maximum_number_of_iterations = 128;
 
+    SubspacePrecision subspace_precision = SubspacePrecision::DOUBLE;
+    double refinement_threshold = 1.0e-04;  // the residual norm at which single-precision iterations hand over to the double-precision refinement
+
+    SubspaceStorage subspace_storage = SubspaceStorage::IN_CORE;
+    std::string scratch_directory = "/tmp";  // the directory for the scratch files of a memory-mapped subspace
+
+    std::vector<std::shared_ptr<BaseIterationObserver>> observers;  // the observers that are attached to the Davidson solver
+
     MatrixX<double> X_0;  // MatrixX<double> of initial guesses, or VectorX<double> of initial guess
 
 
     // CONSTRUCTORS
+    /**
+     *  Default constructor without initial guesses: a CISolver then generates them from the diagonal of the Hamiltonian matrix
+     */
+    DavidsonSolverOptions() = default;
+
     /**
      *  @param initial_guess        the initial guess(es) for the Davidson algorithm, specified as column(s) of the given vector/matrix
      */
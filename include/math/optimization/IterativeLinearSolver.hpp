@@ -0,0 +1,185 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_ITERATIVELINEARSOLVER_HPP
+#define GQCP_ITERATIVELINEARSOLVER_HPP
+
+
+#include "math/optimization/EigenproblemSolverOptions.hpp"
+
+#include "math/SquareMatrix.hpp"
+#include "Observer/ObservableSolver.hpp"
+
+#include "typedefs.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  An enum class for the implemented Krylov methods for linear systems of equations
+ */
+enum class KrylovMethod {
+    CG,  // for positive definite systems, e.g. (H - E_0) projected on the complement of the ground state
+    MINRES,  // for symmetric, possibly indefinite systems
+    GMRES  // restarted GMRES, for any non-singular system
+};
+
+
+
+/**
+ *  A class that solves the (shifted) linear systems of equations (A - shift) x = b for a (possibly large) symmetric matrix A that is only known through its matrix-vector products and its diagonal, such as a CI Hamiltonian
+ *
+ *  The Jacobi preconditioner (diag(A) - shift)^(-1) is used. If a reference vector c is given, the system is solved in the orthogonal complement of c, i.e. P (A - shift) P x = P b with P = 1 - c c^T, as is needed for (H - E) x = b with E the eigenvalue that belongs to c
+ */
+class IterativeLinearSolver : public ObservableSolver {
+private:
+    KrylovMethod method;
+    double convergence_threshold;  // the tolerance on the norm of the residual vector
+    size_t maximum_number_of_iterations;  // the maximum number of iterations per right-hand side
+    size_t restart_dimension;  // the maximum dimension of the Krylov subspace in GMRES before a restart
+
+    SubspaceStorage subspace_storage;  // where the GMRES Krylov vectors are stored
+    std::string scratch_directory;  // the directory for the scratch files of memory-mapped Krylov vectors
+
+    VectorFunction matrixVectorProduct;
+    double shift;
+    size_t dim;
+
+    VectorX<double> reference;  // the normalized reference vector c, empty if no projection is needed
+    VectorX<double> inverse_preconditioner;  // the inverse of the diagonal preconditioner
+    VectorX<double> preconditioned_reference;  // M^(-1) c
+    double reference_overlap = 0.0;  // c^T M^(-1) c
+
+    bool is_solved = false;
+    MatrixX<double> X;  // the solutions, as columns
+    std::vector<size_t> number_of_iterations;  // the number of iterations for every right-hand side
+
+    static constexpr double preconditioner_threshold = 1.0e-08;  // the minimal absolute value of an element of the diagonal preconditioner
+
+
+    // PRIVATE METHODS
+    /**
+     *  @param x            a vector in the orthogonal complement of the reference vector
+     *  @param y            the vector in which P (A - shift) x is stored
+     *  @param record       the record of the current iteration, in which the cost of the matrix-vector product is accumulated
+     */
+    void applyOperator(const VectorX<double>& x, VectorX<double>& y, IterationRecord& record) const;
+
+    /**
+     *  @param r            a vector in the orthogonal complement of the reference vector
+     *  @param z            the vector in which the preconditioned vector is stored, which is again orthogonal to the reference vector
+     */
+    void applyPreconditioner(const VectorX<double>& r, VectorX<double>& z) const;
+
+    /**
+     *  @param v            the vector from which the component along the reference vector should be removed
+     */
+    void project(VectorX<double>& v) const;
+
+    /**
+     *  Finish the record of the current iteration, notify the attached observers and prepare the record and start time for the next iteration
+     *
+     *  @param record       the record of the current iteration
+     *  @param start        the time at which the current iteration started
+     */
+    void notifyIteration(IterationRecord& record, std::chrono::steady_clock::time_point& start) const;
+
+    /**
+     *  @param b            the (projected) right-hand side
+     *  @param x            the solution, which should be initialized to zero
+     *
+     *  @return the number of iterations that were needed
+     */
+    size_t solveCG(const VectorX<double>& b, VectorX<double>& x) const;
+
+    /**
+     *  @param b            the (projected) right-hand side
+     *  @param x            the solution, which should be initialized to zero
+     *
+     *  @return the number of iterations that were needed
+     */
+    size_t solveMINRES(const VectorX<double>& b, VectorX<double>& x) const;
+
+    /**
+     *  @param b            the (projected) right-hand side
+     *  @param x            the solution, which should be initialized to zero
+     *
+     *  @return the number of iterations that were needed
+     */
+    size_t solveGMRES(const VectorX<double>& b, VectorX<double>& x) const;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param matrixVectorProduct              a vector function that returns the matrix-vector product of A (i.e. the matrix-vector product representation of A)
+     *  @param diagonal                         the diagonal of A
+     *  @param shift                            the shift that is subtracted from A, e.g. an eigenvalue E
+     *  @param reference                        the reference vector whose orthogonal complement contains the solutions, or an empty vector if no projection is needed
+     *  @param method                           the Krylov method that is used
+     *  @param convergence_threshold            the tolerance on the norm of the residual vector
+     *  @param maximum_number_of_iterations     the maximum number of iterations per right-hand side
+     *  @param restart_dimension                the maximum dimension of the Krylov subspace in GMRES before a restart
+     *  @param subspace_storage                 where the GMRES Krylov vectors are stored
+     *  @param scratch_directory                the directory for the scratch files of memory-mapped Krylov vectors
+     */
+    IterativeLinearSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal, double shift = 0.0, const VectorX<double>& reference = VectorX<double>(), KrylovMethod method = KrylovMethod::MINRES, double convergence_threshold = 1.0e-08, size_t maximum_number_of_iterations = 128, size_t restart_dimension = 30, SubspaceStorage subspace_storage = SubspaceStorage::IN_CORE, const std::string& scratch_directory = "/tmp");
+
+    /**
+     *  @param A                                the matrix
+     *  @param shift                            the shift that is subtracted from A, e.g. an eigenvalue E
+     *  @param reference                        the reference vector whose orthogonal complement contains the solutions, or an empty vector if no projection is needed
+     *  @param method                           the Krylov method that is used
+     *  @param convergence_threshold            the tolerance on the norm of the residual vector
+     *  @param maximum_number_of_iterations     the maximum number of iterations per right-hand side
+     *  @param restart_dimension                the maximum dimension of the Krylov subspace in GMRES before a restart
+     *  @param subspace_storage                 where the GMRES Krylov vectors are stored
+     *  @param scratch_directory                the directory for the scratch files of memory-mapped Krylov vectors
+     */
+    IterativeLinearSolver(const SquareMatrix<double>& A, double shift = 0.0, const VectorX<double>& reference = VectorX<double>(), KrylovMethod method = KrylovMethod::MINRES, double convergence_threshold = 1.0e-08, size_t maximum_number_of_iterations = 128, size_t restart_dimension = 30, SubspaceStorage subspace_storage = SubspaceStorage::IN_CORE, const std::string& scratch_directory = "/tmp");
+
+
+    // GETTERS
+    const MatrixX<double>& get_solutions() const;
+    VectorX<double> get_solution(size_t index = 0) const;
+    const std::vector<size_t>& get_number_of_iterations() const;
+
+
+    // PUBLIC METHODS
+    /**
+     *  Solve the linear systems of equations for every right-hand side, one after the other
+     *
+     *  @param B            the right-hand side(s), specified as column(s) of the given vector/matrix. Their components along the reference vector are removed.
+     *
+     *  If successful, it sets
+     *      - is_solved to true
+     *      - the solutions, as columns
+     */
+    void solve(const MatrixX<double>& B);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_ITERATIVELINEARSOLVER_HPP
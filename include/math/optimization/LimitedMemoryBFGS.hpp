@@ -0,0 +1,94 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_LIMITEDMEMORYBFGS_HPP
+#define GQCP_LIMITEDMEMORYBFGS_HPP
+
+
+#include "math/Matrix.hpp"
+
+#include <deque>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  The limited-memory BFGS approximation of an inverse Hessian, which is represented by the most recent steps s_k = x_(k+1) - x_k and the corresponding gradient differences y_k = g_(k+1) - g_k
+ *
+ *  Only gradients are needed to build the approximation, so that it can be used in any quasi-Newton optimization (e.g. orbital optimization) in which the exact Hessian is too expensive
+ */
+class LimitedMemoryBFGS {
+private:
+    size_t maximum_history_size;  // the maximum number of stored (s, y)-pairs
+
+    std::deque<VectorX<double>> steps;  // the steps s_k, oldest first
+    std::deque<VectorX<double>> gradient_differences;  // the gradient differences y_k, oldest first
+    std::deque<double> rhos;  // 1 / (y_k^T s_k)
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param maximum_history_size     the maximum number of (s, y)-pairs that is stored: when a new pair is added to a full history, the oldest one is discarded
+     */
+    explicit LimitedMemoryBFGS(size_t maximum_history_size = 8);
+
+
+    // GETTERS
+    size_t get_maximum_history_size() const { return this->maximum_history_size; }
+    size_t size() const { return this->steps.size(); }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Add a (s, y)-pair to the history
+     *
+     *  @param s                the step x_(k+1) - x_k
+     *  @param y                the corresponding gradient difference g_(k+1) - g_k
+     *
+     *  @return if the pair has been added. A pair that doesn't satisfy the curvature condition y^T s > 0 is skipped, so that the approximate inverse Hessian stays positive definite
+     */
+    bool update(const VectorX<double>& s, const VectorX<double>& y);
+
+    /**
+     *  @param v                            a vector
+     *  @param initial_hessian_diagonal     the (positive) diagonal of the initial Hessian approximation, whose inverse is updated with the stored pairs
+     *
+     *  @return the product H v of the approximate inverse Hessian H with the given vector, calculated with the two-loop recursion
+     */
+    VectorX<double> inverseHessianProduct(const VectorX<double>& v, const VectorX<double>& initial_hessian_diagonal) const;
+
+    /**
+     *  @param v                            a vector
+     *
+     *  @return the product H v of the approximate inverse Hessian H with the given vector, in which the initial inverse Hessian is the identity scaled with y^T s / y^T y of the most recent pair (or the identity if there are no stored pairs)
+     */
+    VectorX<double> inverseHessianProduct(const VectorX<double>& v) const;
+
+    /**
+     *  Remove all stored pairs
+     */
+    void clear();
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_LIMITEDMEMORYBFGS_HPP
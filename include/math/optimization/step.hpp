@@ -21,6 +21,7 @@
 
 #include "typedefs.hpp"
 #include "math/Matrix.hpp"
+#include "math/optimization/Eigenpair.hpp"
 
 
 
@@ -38,6 +39,30 @@ namespace GQCP {
 VectorX<double> newtonStep(const VectorX<double>& x, const VectorFunction& f, const MatrixFunction& J);
 
 
+/**
+ *  @param gradient                         the gradient g at the current point
+ *  @param hessianVectorProduct             a vector function that returns the product of the Hessian H at the current point with a given vector
+ *  @param radius                           the radius of the trust region
+ *  @param predicted_change                 the change g^T p + 1/2 p^T H p that the quadratic model predicts for the returned step p, which is set by this function
+ *  @param convergence_threshold            the tolerance on the norm of the residual g + H p of the Newton equations, relative to the norm of the gradient
+ *  @param maximum_number_of_iterations     the maximum number of conjugate gradient iterations
+ *
+ *  @return the truncated conjugate gradient (Steihaug-Toint) step, which approximately minimizes the quadratic model within the trust region ||p|| <= radius. The conjugate gradient iterations are stopped at the boundary of the trust region, or as soon as a direction of negative curvature is encountered, so that the Hessian is only needed through its matrix-vector products
+ */
+VectorX<double> trustRegionNewtonStep(const VectorX<double>& gradient, const VectorFunction& hessianVectorProduct, double radius, double& predicted_change, double convergence_threshold = 1.0e-06, size_t maximum_number_of_iterations = 128);
+
+
+/**
+ *  @param matrixVectorProduct              a vector function that returns the product of a symmetric matrix A with a given vector
+ *  @param x0                               the start vector of the Krylov subspace
+ *  @param convergence_threshold            the tolerance on the norm of the residual A v - lambda v of the Ritz pair
+ *  @param maximum_number_of_iterations     the maximum dimension of the Krylov subspace
+ *
+ *  @return an estimate of the lowest eigenpair of A: the lowest Ritz pair in the Krylov subspace that is built by the Lanczos algorithm (with full reorthogonalization)
+ */
+Eigenpair lanczosLowestEigenpair(const VectorFunction& matrixVectorProduct, const VectorX<double>& x0, double convergence_threshold = 1.0e-06, size_t maximum_number_of_iterations = 32);
+
+
 }  // namespace GQCP
 
 
@@ -72,6 +72,17 @@ size_t matrixIndexMinor(size_t v, size_t cols, size_t skipped=0);
  *  @return the vector index given the corresponding row-major matrix indices
  */
 size_t vectorIndex(size_t i, size_t j, size_t cols, size_t skipped=0);
+
+/**
+ *  Call a function on contiguous blocks of the range [0, size) that are distributed over a number of threads
+ *
+ *  @param size                 the size of the range
+ *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+ *  @param function             the function that is called as function(start, end) for every block [start, end)
+ *
+ *  The calling thread handles the last block itself, and an exception that is thrown in any of the blocks is rethrown after all threads have finished
+ */
+void parallelFor(size_t size, size_t number_of_threads, const std::function<void(size_t, size_t)>& function);
     
 
 /**
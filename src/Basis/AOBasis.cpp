@@ -18,6 +18,10 @@
 #include "Basis/AOBasis.hpp"
 #include "Basis/LibintInterfacer.hpp"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 
 namespace GQCP {
 
@@ -50,6 +54,24 @@ AOBasis::AOBasis(const Molecule& molecule, const std::string& basisset_name) :
 
 
 
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  @return the libint2 representation of the underlying shell set, which is only created once for this AO basis (and its copies)
+ */
+const libint2::BasisSet& AOBasis::get_libint_basisset() const {
+
+    if (!this->libint_basisset) {
+        this->libint_basisset = std::make_shared<const libint2::BasisSet>(LibintInterfacer::get().interface(this->shell_set));
+    }
+
+    return *this->libint_basisset;
+}
+
+
+
 /*
  *  PUBLIC METHODS
  */
@@ -62,18 +84,26 @@ size_t AOBasis::numberOfBasisFunctions() const {
 }
 
 
-
-/*
- *  PUBLIC METHODS
+/**
+ *  @return the (nsh x nsh)-matrix of the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells a and b, which are only calculated once for this AO basis
  */
+const SquareMatrix<double>& AOBasis::get_schwarz_bounds() const {
+
+    if (this->schwarz_bounds.size() == 0) {
+        const auto& libint_basisset = this->get_libint_basisset();
+        this->schwarz_bounds = LibintInterfacer::get().calculateSchwarzBounds(libint2::Operator::coulomb, libint_basisset);
+    }
+
+    return this->schwarz_bounds;
+}
+
 
 /**
  *  @return the matrix representation of the overlap operator in this AO basis
  */
 OneElectronOperator<double> AOBasis::calculateOverlapIntegrals() const {
 
-    auto libint_basisset = LibintInterfacer::get().interface(this->shell_set);
-    return LibintInterfacer::get().calculateOneElectronIntegrals<1>(libint2::Operator::overlap, libint_basisset)[0];
+    return LibintInterfacer::get().calculateSymmetricOneElectronIntegrals({{libint2::Operator::overlap, libint2::any()}}, this->get_libint_basisset(), 0)[0];
 }
 
 
@@ -82,8 +112,7 @@ OneElectronOperator<double> AOBasis::calculateOverlapIntegrals() const {
  */
 OneElectronOperator<double> AOBasis::calculateKineticIntegrals() const {
 
-    auto libint_basisset = LibintInterfacer::get().interface(this->shell_set);
-    return LibintInterfacer::get().calculateOneElectronIntegrals<1>(libint2::Operator::kinetic, libint_basisset)[0];
+    return LibintInterfacer::get().calculateSymmetricOneElectronIntegrals({{libint2::Operator::kinetic, libint2::any()}}, this->get_libint_basisset(), 0)[0];
 }
 
 
@@ -92,10 +121,9 @@ OneElectronOperator<double> AOBasis::calculateKineticIntegrals() const {
  */
 OneElectronOperator<double> AOBasis::calculateNuclearIntegrals() const {
 
-    auto libint_basisset = LibintInterfacer::get().interface(this->shell_set);
     auto libint_atoms = LibintInterfacer::get().interface(this->shell_set.atoms());
 
-    return LibintInterfacer::get().calculateOneElectronIntegrals<1>(libint2::Operator::nuclear, libint_basisset, make_point_charges(libint_atoms))[0];
+    return LibintInterfacer::get().calculateSymmetricOneElectronIntegrals({{libint2::Operator::nuclear, make_point_charges(libint_atoms)}}, this->get_libint_basisset(), 0)[0];
 }
 
 
@@ -108,8 +136,7 @@ std::array<OneElectronOperator<double>, 3> AOBasis::calculateDipoleIntegrals(con
 
     std::array<double, 3> origin_array {origin.x(), origin.y(), origin.z()};
 
-    auto libint_basisset = LibintInterfacer::get().interface(this->shell_set);
-    auto all_integrals = LibintInterfacer::get().calculateOneElectronIntegrals<4>(libint2::Operator::emultipole1, libint_basisset, origin_array);  // overlap, x, y, z
+    auto all_integrals = LibintInterfacer::get().calculateSymmetricOneElectronIntegrals({{libint2::Operator::emultipole1, origin_array}}, this->get_libint_basisset(), 0);  // overlap, x, y, z
 
     // Apply the minus sign which comes from the charge of the electrons -e
     return std::array<OneElectronOperator<double>, 3> {-all_integrals[1], -all_integrals[2], -all_integrals[3]};  // we don't need the overlap, so ignore [0]
@@ -117,12 +144,176 @@ std::array<OneElectronOperator<double>, 3> AOBasis::calculateDipoleIntegrals(con
 
 
 /**
+ *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+ *
+ *  @return the matrix representations of the overlap, kinetic energy and nuclear attraction operators in this AO basis (in that order), calculated in one sweep over the unique shell pairs
+ */
+std::array<OneElectronOperator<double>, 3> AOBasis::calculateOneElectronIntegrals(size_t number_of_threads) const {
+
+    auto libint_atoms = LibintInterfacer::get().interface(this->shell_set.atoms());
+
+    auto all_integrals = LibintInterfacer::get().calculateSymmetricOneElectronIntegrals({{libint2::Operator::overlap, libint2::any()},
+                                                                                         {libint2::Operator::kinetic, libint2::any()},
+                                                                                         {libint2::Operator::nuclear, make_point_charges(libint_atoms)}},
+                                                                                        this->get_libint_basisset(), number_of_threads);
+
+    return std::array<OneElectronOperator<double>, 3> {all_integrals[0], all_integrals[1], all_integrals[2]};
+}
+
+
+/**
+ *  @param origin                   the origin of the dipole
+ *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+ *
+ *  @return the matrix representations of the overlap, kinetic energy and nuclear attraction operators and the Cartesian components of the electrical dipole operator in this AO basis (in that order), calculated in one sweep over the unique shell pairs
+ */
+std::array<OneElectronOperator<double>, 6> AOBasis::calculateOneElectronAndDipoleIntegrals(const Vector<double, 3>& origin, size_t number_of_threads) const {
+
+    std::array<double, 3> origin_array {origin.x(), origin.y(), origin.z()};
+    auto libint_atoms = LibintInterfacer::get().interface(this->shell_set.atoms());
+
+    // The first component of the multipole engine is the overlap, so we don't need a separate overlap engine
+    auto all_integrals = LibintInterfacer::get().calculateSymmetricOneElectronIntegrals({{libint2::Operator::kinetic, libint2::any()},
+                                                                                         {libint2::Operator::nuclear, make_point_charges(libint_atoms)},
+                                                                                         {libint2::Operator::emultipole1, origin_array}},  // overlap, x, y, z
+                                                                                        this->get_libint_basisset(), number_of_threads);
+
+    // Apply the minus sign which comes from the charge of the electrons -e
+    return std::array<OneElectronOperator<double>, 6> {all_integrals[2], all_integrals[0], all_integrals[1], -all_integrals[3], -all_integrals[4], -all_integrals[5]};
+}
+
+
+/**
+ *  @param screening_threshold      the threshold on the product of the Schwarz bounds of two shell pairs, below which their shell quartet isn't computed. A zero threshold disables the screening.
+ *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+ *
  *  @return the matrix representation of the Coulomb repulsion operator in this AO basis
+ *
+ *  The number of skipped shell quartets can be retrieved afterwards with get_number_of_skipped_quartets()
  */
-TwoElectronOperator<double> AOBasis::calculateCoulombRepulsionIntegrals() const {
+TwoElectronOperator<double> AOBasis::calculateCoulombRepulsionIntegrals(double screening_threshold, size_t number_of_threads) const {
+
+    if (number_of_threads == 0) {
+        number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const auto& libint_basisset = this->get_libint_basisset();
+
+    if (screening_threshold > 0.0) {
+        return LibintInterfacer::get().calculateTwoElectronIntegrals(libint2::Operator::coulomb, libint_basisset, this->get_schwarz_bounds(), screening_threshold, this->number_of_skipped_quartets, number_of_threads);
+    } else {
+        return LibintInterfacer::get().calculateTwoElectronIntegrals(libint2::Operator::coulomb, libint_basisset, SquareMatrix<double>(), 0.0, this->number_of_skipped_quartets, number_of_threads);
+    }
+}
+
+
+/**
+ *  @param screening_threshold      the threshold on the product of the Schwarz bounds of two shell pairs, below which their shell quartet isn't computed. A zero threshold disables the screening.
+ *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+ *
+ *  @return the eight-fold packed representation of the Coulomb repulsion operator in this AO basis, which only takes an eighth of the memory of the dense representation
+ */
+PackedTwoElectronOperator AOBasis::calculatePackedCoulombRepulsionIntegrals(double screening_threshold, size_t number_of_threads) const {
+
+    if (number_of_threads == 0) {
+        number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const auto& libint_basisset = this->get_libint_basisset();
+
+    if (screening_threshold > 0.0) {
+        return LibintInterfacer::get().calculatePackedTwoElectronIntegrals(libint2::Operator::coulomb, libint_basisset, this->get_schwarz_bounds(), screening_threshold, this->number_of_skipped_quartets, number_of_threads);
+    } else {
+        return LibintInterfacer::get().calculatePackedTwoElectronIntegrals(libint2::Operator::coulomb, libint_basisset, SquareMatrix<double>(), 0.0, this->number_of_skipped_quartets, number_of_threads);
+    }
+}
+
+
+/**
+ *  @param auxiliary_basis          the auxiliary basis in which the orbital products are fitted, e.g. a (def2-universal-)JKFIT or RIFIT basis on the same molecule
+ *  @param eigenvalue_threshold     the threshold on the eigenvalues of the two-center integrals of the auxiliary basis below which the corresponding linear combinations of auxiliary functions are discarded
+ *
+ *  @return the density-fitted (resolution-of-the-identity) Coulomb repulsion operator in this AO basis, which only stores O(K^2 N_aux) values
+ */
+FactorizedTwoElectronOperator AOBasis::calculateDensityFittedCoulombRepulsionIntegrals(const AOBasis& auxiliary_basis, double eigenvalue_threshold) const {
+
+    const auto& libint_basisset = this->get_libint_basisset();
+    const auto& libint_auxiliary_basisset = auxiliary_basis.get_libint_basisset();
+
+    const auto three_center_integrals = LibintInterfacer::get().calculateThreeCenterIntegrals(libint2::Operator::coulomb, libint_basisset, libint_auxiliary_basisset);
+    const auto two_center_integrals = LibintInterfacer::get().calculateTwoCenterIntegrals(libint2::Operator::coulomb, libint_auxiliary_basisset);
+
+    return FactorizedTwoElectronOperator::DensityFitted(three_center_integrals, two_center_integrals, eigenvalue_threshold);
+}
+
+
+/**
+ *  @param tolerance        the tolerance on the largest remaining diagonal element of the decomposition, which bounds the error on every reconstructed integral
+ *
+ *  @return the pivoted Cholesky decomposition of the Coulomb repulsion operator in this AO basis, calculated from the diagonal shell quartets and the columns of the pivots, so that the full K^4 tensor is never formed
+ */
+FactorizedTwoElectronOperator AOBasis::calculateCholeskyCoulombRepulsionIntegrals(double tolerance) const {
+
+    const auto& libint_basisset = this->get_libint_basisset();
+    const auto nbf = static_cast<size_t>(libint_basisset.nbf());
+    const auto& shell2bf = libint_basisset.shell2bf();
+
+    std::vector<size_t> bf2shell (nbf);
+    for (size_t sh = 0; sh < libint_basisset.size(); sh++) {
+        for (size_t f = 0; f < libint_basisset[sh].size(); f++) {
+            bf2shell[shell2bf[sh] + f] = sh;
+        }
+    }
+
+    const auto diagonal = LibintInterfacer::get().calculateTwoElectronDiagonal(libint2::Operator::coulomb, libint_basisset);
+
+
+    // Libint calculates whole shell quartets, so the columns of all functions in the shell pair of the pivot are kept, since consecutive pivots often belong to the same shell pair
+    size_t cached_sh1 = nbf;  // no shell pair has been calculated yet
+    size_t cached_sh2 = nbf;
+    MatrixX<double> cached_columns;
+
+    auto calculateColumn = [&] (size_t pq) {
+        const auto p = pq % nbf;
+        const auto q = pq / nbf;
+        const auto sh1 = bf2shell[p];
+        const auto sh2 = bf2shell[q];
+
+        if ((sh1 != cached_sh1) || (sh2 != cached_sh2)) {
+            cached_columns = LibintInterfacer::get().calculateTwoElectronColumns(libint2::Operator::coulomb, libint_basisset, sh1, sh2);
+            cached_sh1 = sh1;
+            cached_sh2 = sh2;
+        }
+
+        return VectorX<double>(cached_columns.col((p - shell2bf[sh1]) + libint_basisset[sh1].size() * (q - shell2bf[sh2])));
+    };
+
+    return FactorizedTwoElectronOperator::PivotedCholesky(diagonal, calculateColumn, tolerance);
+}
+
+
+/**
+ *  @param D_AO                     the RHF density matrix in this AO basis
+ *  @param screening_threshold      the threshold on the product of the Schwarz bounds of two shell pairs and the largest density matrix element they are contracted with, below which their shell quartet isn't computed. A zero threshold disables the screening.
+ *  @param number_of_threads        the number of threads that calculate the integrals, or 0 to use all available hardware threads
+ *
+ *  @return the two-electron part G = J - 1/2 K of the RHF Fock matrix, calculated integral-direct so that only O(K^2) memory is needed
+ *
+ *  The number of skipped shell quartets can be retrieved afterwards with get_number_of_skipped_quartets()
+ */
+SquareMatrix<double> AOBasis::calculateDirectRHFTwoElectronMatrix(const SquareMatrix<double>& D_AO, double screening_threshold, size_t number_of_threads) const {
+
+    if (number_of_threads == 0) {
+        number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const auto& libint_basisset = this->get_libint_basisset();
 
-    auto libint_basisset = LibintInterfacer::get().interface(this->shell_set);
-    return LibintInterfacer::get().calculateTwoElectronIntegrals(libint2::Operator::coulomb, libint_basisset);
+    if (screening_threshold > 0.0) {
+        return LibintInterfacer::get().calculateDirectRHFTwoElectronMatrix(libint2::Operator::coulomb, libint_basisset, D_AO, this->get_schwarz_bounds(), screening_threshold, this->number_of_skipped_quartets, number_of_threads);
+    } else {
+        return LibintInterfacer::get().calculateDirectRHFTwoElectronMatrix(libint2::Operator::coulomb, libint_basisset, D_AO, SquareMatrix<double>(), 0.0, this->number_of_skipped_quartets, number_of_threads);
+    }
 }
 
 
@@ -18,12 +18,18 @@
 #include "Basis/LibintInterfacer.hpp"
 
 #include "Basis/CartesianGTO.hpp"
+#include "utilities/miscellaneous.hpp"
 
 #include <boost/math/constants/constants.hpp>
 #include <boost/math/special_functions/factorials.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 
 
@@ -59,6 +65,167 @@ LibintInterfacer::~LibintInterfacer() {
 }
 
 
+/*
+ *  PRIVATE METHODS - INTEGRALS
+ */
+
+/**
+ *  Calculate the canonical shell quartets (sh1 >= sh2, sh3 >= sh4, (sh1 sh2) >= (sh3 sh4)) of a two-electron operator on multiple threads
+ *
+ *  @param operator_type                    the name of the operator as specified by the enumeration
+ *  @param libint_basisset                  the libint2 basis set representing the AO basis
+ *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+ *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs, below which a shell quartet isn't computed
+ *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+ *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine
+ *  @param store_integral                   the callable (p, q, r, s, value) that stores an integral (pq|rs) together with its symmetry-related integrals
+ *
+ *  Every stored integral belongs to exactly one canonical shell quartet, so store_integral may be called concurrently as long as it doesn't write to the storage of other integrals
+ */
+template <typename StoreIntegral>
+void LibintInterfacer::calculateCanonicalTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads, const StoreIntegral& store_integral) const {
+
+    const auto nsh = static_cast<size_t>(libint_basisset.size());  // nsh: number of shells in the basisset
+
+    const bool screen = (screening_threshold > 0.0);
+    if (screen && ((schwarz_bounds.rows() != nsh) || (schwarz_bounds.cols() != nsh))) {
+        throw std::invalid_argument("LibintInterfacer::calculateCanonicalTwoElectronIntegrals(libint2::Operator, libint2::BasisSet, SquareMatrix<double>, double, size_t, size_t, StoreIntegral): The Schwarz bounds are not compatible with the basis set.");
+    }
+
+    if (number_of_threads == 0) {
+        throw std::invalid_argument("LibintInterfacer::calculateCanonicalTwoElectronIntegrals(libint2::Operator, libint2::BasisSet, SquareMatrix<double>, double, size_t, size_t, StoreIntegral): The number of threads must be at least 1.");
+    }
+
+    const double maximum_bound = screen ? schwarz_bounds.maxCoeff() : 0.0;
+
+    // Construct the libint2 engine, which is copied for every thread since libint2 engines aren't thread-safe
+    libint2::Engine engine(libint2::Operator::coulomb, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+
+    const auto& shell2bf = libint_basisset.shell2bf();  // maps shell index to bf index
+
+
+    // Two-electron integrals are between four basis functions, so we'll need four loops
+    // Libint calculates integrals between libint2::Shells, so we will loop over the shells (sh) in the basisset
+    // Because of the 8-fold permutational symmetry of real two-electron integrals, (12|34) = (21|34) = (12|43) = (21|43) = (34|12) = (43|12) = (34|21) = (43|21), we only compute the canonical shell quartets sh1 >= sh2, sh3 >= sh4, (sh1 sh2) >= (sh3 sh4) and scatter them to all symmetry-related positions
+    // Every integral belongs to exactly one canonical shell quartet, so the threads can store the integrals without conflicts
+    // The work is distributed dynamically over the threads per shell pair (sh1 sh2), starting with the most expensive pairs
+    std::vector<std::pair<size_t, size_t>> shell_pairs;
+    shell_pairs.reserve(nsh * (nsh + 1) / 2);
+    for (size_t sh1 = nsh; sh1-- > 0; ) {
+        for (size_t sh2 = sh1 + 1; sh2-- > 0; ) {
+            shell_pairs.emplace_back(sh1, sh2);
+        }
+    }
+
+    std::atomic<size_t> next_shell_pair (0);
+    std::atomic<size_t> total_number_of_skipped_quartets (0);
+
+    auto calculateShellPairs = [&, engine] () mutable {  // every thread gets its own copy of the engine
+
+        const auto& buffer = engine.results();  // vector that holds pointers to computed shell sets
+        // actually, buffer.size() is always 1, so buffer[0] is a pointer to
+        //      the first calculated integral of these specific shells
+        // the values that buffer[0] points to will change after every compute() call
+
+        size_t skipped_quartets = 0;
+        for (size_t index = next_shell_pair++; index < shell_pairs.size(); index = next_shell_pair++) {
+            const auto sh1 = shell_pairs[index].first;  // sh1: shell 1
+            const auto sh2 = shell_pairs[index].second;  // sh2: shell 2
+
+            // Shell quartets whose Schwarz bound |(12|34)| <= bound(1,2) * bound(3,4) drops below the screening threshold are skipped
+            if (screen && (schwarz_bounds(sh1, sh2) * maximum_bound < screening_threshold)) {  // no quartet with this shell pair survives
+                skipped_quartets += sh1 * (sh1 + 1) / 2 + sh2 + 1;  // the number of shell pairs (sh3 sh4) up to (sh1 sh2)
+                continue;
+            }
+
+            for (size_t sh3 = 0; sh3 <= sh1; sh3++) {  // sh3: shell 3
+                const auto sh4_max = (sh3 == sh1) ? sh2 : sh3;  // make sure that the pair (sh3 sh4) doesn't come after the pair (sh1 sh2)
+                for (size_t sh4 = 0; sh4 <= sh4_max; sh4++) {  //sh4: shell 4
+
+                    if (screen && (schwarz_bounds(sh1, sh2) * schwarz_bounds(sh3, sh4) < screening_threshold)) {
+                        skipped_quartets++;
+                        continue;
+                    }
+
+                    // Calculate integrals between the two shells (obs is a decorated std::vector<libint2::Shell>)
+                    engine.compute(libint_basisset[sh1], libint_basisset[sh2], libint_basisset[sh3], libint_basisset[sh4]);
+
+                    const auto& calculated_integrals = buffer[0];
+
+                    if (calculated_integrals == nullptr) {  // if the zeroth element is nullptr, then the whole shell has been exhausted
+                        // or the libint engine predicts that the integrals are below a certain threshold
+                        // in this case the value does not need to be filled in, and we are safe because we have properly initialized to zero
+                        continue;
+                    }
+
+                    // Extract the calculated integrals from calculated_integrals.
+                    // In calculated_integrals, the integrals are stored in row major form.
+                    auto bf1 = static_cast<long>(shell2bf[sh1]);  // (index of) first bf in sh1
+                    auto bf2 = static_cast<long>(shell2bf[sh2]);  // (index of) first bf in sh2
+                    auto bf3 = static_cast<long>(shell2bf[sh3]);  // (index of) first bf in sh3
+                    auto bf4 = static_cast<long>(shell2bf[sh4]);  // (index of) first bf in sh4
+
+
+                    auto nbf_sh1 = static_cast<long>(libint_basisset[sh1].size());  // number of basis functions in first shell
+                    auto nbf_sh2 = static_cast<long>(libint_basisset[sh2].size());  // number of basis functions in second shell
+                    auto nbf_sh3 = static_cast<long>(libint_basisset[sh3].size());  // number of basis functions in third shell
+                    auto nbf_sh4 = static_cast<long>(libint_basisset[sh4].size());  // number of basis functions in fourth shell
+
+                    for (auto f1 = 0L; f1 != nbf_sh1; ++f1) {
+                        const auto p = f1 + bf1;
+                        for (auto f2 = 0L; f2 != nbf_sh2; ++f2) {
+                            const auto q = f2 + bf2;
+                            for (auto f3 = 0L; f3 != nbf_sh3; ++f3) {
+                                const auto r = f3 + bf3;
+                                for (auto f4 = 0L; f4 != nbf_sh4; ++f4) {
+                                    const auto s = f4 + bf4;
+                                    const auto& computed_integral = calculated_integrals[f4 + nbf_sh4 * (f3 + nbf_sh3 * (f2 + nbf_sh2 * (f1)))];  // integrals are packed in row-major form
+
+                                    // Two-electron integrals are given in CHEMIST'S notation: (11|22)
+                                    store_integral(p, q, r, s, computed_integral);
+                                }
+                            }
+                        }
+                    } // data access loops
+
+                }
+            }
+        } // shell loops
+
+        total_number_of_skipped_quartets += skipped_quartets;
+    };
+
+
+    // The calling thread also does its share of the work, and exceptions that occur in the other threads are rethrown here
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> exceptions (number_of_threads - 1);
+    for (size_t t = 0; t < number_of_threads - 1; t++) {
+        threads.emplace_back([&calculateShellPairs, &exceptions, t] () {
+            try {
+                auto calculateThreadShellPairs = calculateShellPairs;  // copy the engine for this thread
+                calculateThreadShellPairs();
+            } catch (...) {
+                exceptions[t] = std::current_exception();
+            }
+        });
+    }
+
+    auto calculateOwnShellPairs = calculateShellPairs;
+    calculateOwnShellPairs();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    number_of_skipped_quartets = total_number_of_skipped_quartets;
+}
+
+
 /*
  *  PUBLIC METHODS - SINGLETON
  */
@@ -309,6 +476,87 @@ void LibintInterfacer::undo_renorm(libint2::Shell& libint_shell) const {
  *  PUBLIC METHODS - INTEGRALS
  */
 
+/**
+ *  Calculate the matrix representations of several one-electron operators in one sweep over the unique shell pairs sh1 >= sh2, so that the shell pair loop is shared by all the operators and the (sh2, sh1)-blocks are filled in by symmetry
+ *
+ *  @param operators            the names of the operators as specified by the enumeration, together with the parameters for their integral engines (as specified by libint2)
+ *  @param libint_basisset      the libint2 basis set representing the AO basis
+ *  @param number_of_threads    the number of threads that calculate the shell pairs, each with their own libint2 engines, or 0 to use all available hardware threads
+ *
+ *  @return the matrix representations of all the components of the given operators, in the order of the operators. Since only the unique shell pairs are calculated, the operators should be symmetric, like the overlap, kinetic, nuclear attraction and multipole operators.
+ */
+std::vector<OneElectronOperator<double>> LibintInterfacer::calculateSymmetricOneElectronIntegrals(const std::vector<std::pair<libint2::Operator, libint2::any>>& operators, const libint2::BasisSet& libint_basisset, size_t number_of_threads) const {
+
+    // Construct one libint2 engine per operator, which are copied for every thread since libint2 engines aren't thread-safe
+    std::vector<libint2::Engine> engines;
+    std::vector<size_t> first_components;  // the index of the first component of every operator in the returned matrix representations
+    size_t number_of_components = 0;
+    for (const auto& op : operators) {
+        engines.emplace_back(op.first, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+        engines.back().set_params(op.second);
+
+        first_components.push_back(number_of_components);
+        number_of_components += engines.back().results().size();
+    }
+
+    const auto nbf = static_cast<size_t>(libint_basisset.nbf());  // number of basis functions
+    std::vector<OneElectronOperator<double>> operator_components (number_of_components, OneElectronOperator<double>::Zero(nbf, nbf));
+
+
+    // The unique shell pairs sh1 >= sh2 are distributed over the threads in contiguous blocks
+    // Every shell pair fills in its own (sh1, sh2)- and (sh2, sh1)-blocks, so the threads can store the integrals without conflicts
+    const auto nsh = static_cast<size_t>(libint_basisset.size());  // number of shells
+    std::vector<std::pair<size_t, size_t>> shell_pairs;
+    shell_pairs.reserve(nsh * (nsh + 1) / 2);
+    for (size_t sh1 = 0; sh1 < nsh; sh1++) {
+        for (size_t sh2 = 0; sh2 <= sh1; sh2++) {
+            shell_pairs.emplace_back(sh1, sh2);
+        }
+    }
+
+    const auto& shell2bf = libint_basisset.shell2bf();  // maps shell index to bf index
+
+    parallelFor(shell_pairs.size(), number_of_threads, [&] (size_t start, size_t end) {
+
+        auto thread_engines = engines;  // every thread gets its own copies of the engines
+
+        for (size_t index = start; index < end; index++) {
+            const auto sh1 = shell_pairs[index].first;  // sh1: shell 1
+            const auto sh2 = shell_pairs[index].second;  // sh2: shell 2
+
+            const auto bf1 = shell2bf[sh1];  // (index of) first bf in sh1
+            const auto bf2 = shell2bf[sh2];  // (index of) first bf in sh2
+
+            const auto nbf_sh1 = libint_basisset[sh1].size();  // number of basis functions in first shell
+            const auto nbf_sh2 = libint_basisset[sh2].size();  // number of basis functions in second shell
+
+            for (size_t o = 0; o < thread_engines.size(); o++) {
+                auto& engine = thread_engines[o];
+                engine.compute(libint_basisset[sh1], libint_basisset[sh2]);  // this updates the pointers in engine.results()
+
+                const auto& calculated_integrals = engine.results();
+                for (size_t i = 0; i < calculated_integrals.size(); i++) {
+                    if (calculated_integrals[i] == nullptr) {  // the integrals are all zero, and the matrix representations are properly initialized to zero
+                        continue;
+                    }
+
+                    auto& component = operator_components[first_components[o] + i];
+                    for (size_t f1 = 0; f1 < nbf_sh1; f1++) {
+                        for (size_t f2 = 0; f2 < nbf_sh2; f2++) {
+                            const double computed_integral = calculated_integrals[i][f2 + f1 * nbf_sh2];  // integrals are packed in row-major form
+                            component(bf1 + f1, bf2 + f2) = computed_integral;
+                            component(bf2 + f2, bf1 + f1) = computed_integral;
+                        }
+                    }
+                }  // data access loops
+            }
+        }  // shell pair loop
+    });
+
+    return operator_components;
+}
+
+
 /**
  *  @param operator_type        the name of the operator as specified by the enumeration
  *  @param libint_basisset      the libint2 basis set representing the AO basis
@@ -317,75 +565,499 @@ void LibintInterfacer::undo_renorm(libint2::Shell& libint_shell) const {
  */
 TwoElectronOperator<double> LibintInterfacer::calculateTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset) const {
 
+    size_t number_of_skipped_quartets = 0;
+    return this->calculateTwoElectronIntegrals(operator_type, libint_basisset, SquareMatrix<double>(), 0.0, number_of_skipped_quartets, 1);
+}
+
+
+/**
+ *  @param operator_type                    the name of the operator as specified by the enumeration
+ *  @param libint_basisset                  the libint2 basis set representing the AO basis
+ *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+ *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs, below which a shell quartet isn't computed
+ *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+ *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine
+ *
+ *  @return the matrix representation of a two-electron operator in the given AO basis, in which the integrals of the skipped shell quartets are set to zero
+ */
+TwoElectronOperator<double> LibintInterfacer::calculateTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads) const {
+
     auto nbf = static_cast<size_t>(libint_basisset.nbf());  // nbf: number of basis functions in the basisset
 
     // Initialize the rank-4 two-electron integrals tensor and set to zero
     TwoElectronOperator<double> g (nbf);
     g.setZero();
 
+    // Scatter every calculated integral to all its symmetry-related positions
+    this->calculateCanonicalTwoElectronIntegrals(operator_type, libint_basisset, schwarz_bounds, screening_threshold, number_of_skipped_quartets, number_of_threads, [&g] (long p, long q, long r, long s, double value) {
+        g(p, q, r, s) = value;
+        g(q, p, r, s) = value;
+        g(p, q, s, r) = value;
+        g(q, p, s, r) = value;
+        g(r, s, p, q) = value;
+        g(s, r, p, q) = value;
+        g(r, s, q, p) = value;
+        g(s, r, q, p) = value;
+    });
 
-    // Construct the libint2 engine
-    libint2::Engine engine(libint2::Operator::coulomb, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+    return g;
+}
 
-    const auto& shell2bf = libint_basisset.shell2bf();  // maps shell index to bf index
 
-    const auto& buffer = engine.results();  // vector that holds pointers to computed shell sets
-    // actually, buffer.size() is always 1, so buffer[0] is a pointer to
-    //      the first calculated integral of these specific shells
-    // the values that buffer[0] points to will change after every compute() call
+/**
+ *  @param operator_type                    the name of the operator as specified by the enumeration
+ *  @param libint_basisset                  the libint2 basis set representing the AO basis
+ *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+ *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs, below which a shell quartet isn't computed
+ *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+ *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine
+ *
+ *  @return the eight-fold packed representation of a two-electron operator in the given AO basis, in which the integrals of the skipped shell quartets are set to zero
+ */
+PackedTwoElectronOperator LibintInterfacer::calculatePackedTwoElectronIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads) const {
+
+    auto nbf = static_cast<size_t>(libint_basisset.nbf());  // nbf: number of basis functions in the basisset
 
+    // Only the unique integrals are stored, so the full tensor is never allocated
+    PackedTwoElectronOperator g (nbf, PackedSymmetry::EIGHTFOLD);
+    this->calculateCanonicalTwoElectronIntegrals(operator_type, libint_basisset, schwarz_bounds, screening_threshold, number_of_skipped_quartets, number_of_threads, [&g] (size_t p, size_t q, size_t r, size_t s, double value) {
+        g(p, q, r, s) = value;
+    });
+
+    return g;
+}
+
+
+/**
+ *  Calculate the two-electron part G = J - 1/2 K of the RHF Fock matrix integral-direct, i.e. by contracting every calculated shell quartet with the density matrix and discarding it afterwards
+ *
+ *  @param operator_type                    the name of the operator as specified by the enumeration
+ *  @param libint_basisset                  the libint2 basis set representing the AO basis
+ *  @param D                                the (RHF) density matrix in the AO basis
+ *  @param schwarz_bounds                   the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells, as calculated by calculateSchwarzBounds()
+ *  @param screening_threshold              the threshold on the product of the Schwarz bounds of both shell pairs and the largest density matrix element that the shell quartet is contracted with, below which a shell quartet isn't computed
+ *  @param number_of_skipped_quartets       the number of canonical shell quartets that were skipped by the screening
+ *  @param number_of_threads                the number of threads that calculate the shell quartets, each with their own libint2 engine and Fock matrix contribution
+ *
+ *  @return the two-electron part of the RHF Fock matrix G(p,q) = (pq|rs) D(s,r) - 1/2 (pr|sq) D(r,s)
+ */
+SquareMatrix<double> LibintInterfacer::calculateDirectRHFTwoElectronMatrix(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const SquareMatrix<double>& D, const SquareMatrix<double>& schwarz_bounds, double screening_threshold, size_t& number_of_skipped_quartets, size_t number_of_threads) const {
 
-    // Two-electron integrals are between four basis functions, so we'll need four loops
-    // Libint calculates integrals between libint2::Shells, so we will loop over the shells (sh) in the basisset
     const auto nsh = static_cast<size_t>(libint_basisset.size());  // nsh: number of shells in the basisset
-    for (auto sh1 = 0; sh1 != nsh; ++sh1) {  // sh1: shell 1
-        for (auto sh2 = 0; sh2 != nsh; ++sh2) {  // sh2: shell 2
-            for (auto sh3 = 0; sh3 != nsh; ++sh3) {  // sh3: shell 3
-                for (auto sh4 = 0; sh4 != nsh; ++sh4) {  //sh4: shell 4
-                    // Calculate integrals between the two shells (obs is a decorated std::vector<libint2::Shell>)
+    const auto nbf = static_cast<size_t>(libint_basisset.nbf());  // nbf: number of basis functions in the basisset
+
+    if (D.cols() != nbf) {
+        throw std::invalid_argument("LibintInterfacer::calculateDirectRHFTwoElectronMatrix(libint2::Operator, libint2::BasisSet, SquareMatrix<double>, SquareMatrix<double>, double, size_t, size_t): The density matrix is not compatible with the basis set.");
+    }
+
+    const bool screen = (screening_threshold > 0.0);
+    if (screen && ((schwarz_bounds.rows() != nsh) || (schwarz_bounds.cols() != nsh))) {
+        throw std::invalid_argument("LibintInterfacer::calculateDirectRHFTwoElectronMatrix(libint2::Operator, libint2::BasisSet, SquareMatrix<double>, SquareMatrix<double>, double, size_t, size_t): The Schwarz bounds are not compatible with the basis set.");
+    }
+
+    if (number_of_threads == 0) {
+        throw std::invalid_argument("LibintInterfacer::calculateDirectRHFTwoElectronMatrix(libint2::Operator, libint2::BasisSet, SquareMatrix<double>, SquareMatrix<double>, double, size_t, size_t): The number of threads must be at least 1.");
+    }
+
+    const auto& shell2bf = libint_basisset.shell2bf();  // maps shell index to bf index
+
+
+    // The largest density matrix element in every block of shells, so that |G contribution of (12|34)| <= bound(1,2) * bound(3,4) * max(D blocks that are contracted with (12|34))
+    SquareMatrix<double> shell_density = SquareMatrix<double>::Zero(nsh, nsh);
+    for (size_t sh1 = 0; sh1 < nsh; sh1++) {
+        for (size_t sh2 = 0; sh2 < nsh; sh2++) {
+            shell_density(sh1, sh2) = D.block(shell2bf[sh1], shell2bf[sh2], libint_basisset[sh1].size(), libint_basisset[sh2].size()).cwiseAbs().maxCoeff();
+        }
+    }
+    const double maximum_bound = screen ? schwarz_bounds.maxCoeff() : 0.0;
+    const double maximum_density = shell_density.maxCoeff();
+
+
+    // Construct the libint2 engine, which is copied for every thread since libint2 engines aren't thread-safe
+    libint2::Engine engine (operator_type, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+
+
+    // Only the canonical shell quartets sh1 >= sh2, sh3 >= sh4, (sh1 sh2) >= (sh3 sh4) are calculated, and their integrals are weighted by the number of symmetry-related shell quartets they represent
+    // Every thread accumulates into its own (unsymmetrized) matrix G, which are summed afterwards
+    std::vector<std::pair<size_t, size_t>> shell_pairs;
+    shell_pairs.reserve(nsh * (nsh + 1) / 2);
+    for (size_t sh1 = nsh; sh1-- > 0; ) {
+        for (size_t sh2 = sh1 + 1; sh2-- > 0; ) {
+            shell_pairs.emplace_back(sh1, sh2);
+        }
+    }
+
+    std::atomic<size_t> next_shell_pair (0);
+    std::atomic<size_t> total_number_of_skipped_quartets (0);
+    std::vector<SquareMatrix<double>> thread_G (number_of_threads, SquareMatrix<double>::Zero(nbf, nbf));
+
+    auto calculateShellPairs = [&, engine] (size_t thread_index) mutable {  // every thread gets its own copy of the engine
+
+        auto& G = thread_G[thread_index];
+        const auto& buffer = engine.results();
+
+        size_t skipped_quartets = 0;
+        for (size_t index = next_shell_pair++; index < shell_pairs.size(); index = next_shell_pair++) {
+            const auto sh1 = shell_pairs[index].first;
+            const auto sh2 = shell_pairs[index].second;
+
+            if (screen && (schwarz_bounds(sh1, sh2) * maximum_bound * maximum_density < screening_threshold)) {  // no quartet with this shell pair survives
+                skipped_quartets += sh1 * (sh1 + 1) / 2 + sh2 + 1;  // the number of shell pairs (sh3 sh4) up to (sh1 sh2)
+                continue;
+            }
+
+            for (size_t sh3 = 0; sh3 <= sh1; sh3++) {
+                const auto sh4_max = (sh3 == sh1) ? sh2 : sh3;  // make sure that the pair (sh3 sh4) doesn't come after the pair (sh1 sh2)
+                for (size_t sh4 = 0; sh4 <= sh4_max; sh4++) {
+
+                    if (screen) {
+                        const double density_bound = std::max({shell_density(sh1, sh2), shell_density(sh3, sh4), shell_density(sh1, sh3), shell_density(sh1, sh4), shell_density(sh2, sh3), shell_density(sh2, sh4)});
+                        if (schwarz_bounds(sh1, sh2) * schwarz_bounds(sh3, sh4) * density_bound < screening_threshold) {
+                            skipped_quartets++;
+                            continue;
+                        }
+                    }
+
                     engine.compute(libint_basisset[sh1], libint_basisset[sh2], libint_basisset[sh3], libint_basisset[sh4]);
 
                     const auto& calculated_integrals = buffer[0];
-
-                    if (calculated_integrals == nullptr) {  // if the zeroth element is nullptr, then the whole shell has been exhausted
-                        // or the libint engine predicts that the integrals are below a certain threshold
-                        // in this case the value does not need to be filled in, and we are safe because we have properly initialized to zero
+                    if (calculated_integrals == nullptr) {  // the integrals are negligible
                         continue;
                     }
 
-                    // Extract the calculated integrals from calculated_integrals.
-                    // In calculated_integrals, the integrals are stored in row major form.
-                    auto bf1 = static_cast<long>(shell2bf[sh1]);  // (index of) first bf in sh1
-                    auto bf2 = static_cast<long>(shell2bf[sh2]);  // (index of) first bf in sh2
-                    auto bf3 = static_cast<long>(shell2bf[sh3]);  // (index of) first bf in sh3
-                    auto bf4 = static_cast<long>(shell2bf[sh4]);  // (index of) first bf in sh4
+                    // The number of shell quartets that are symmetry-related to (12|34)
+                    const double degeneracy = ((sh1 == sh2) ? 1.0 : 2.0) * ((sh3 == sh4) ? 1.0 : 2.0) * (((sh1 == sh3) && (sh2 == sh4)) ? 1.0 : 2.0);
+
+                    const auto bf1 = shell2bf[sh1];
+                    const auto bf2 = shell2bf[sh2];
+                    const auto bf3 = shell2bf[sh3];
+                    const auto bf4 = shell2bf[sh4];
+
+                    const auto nbf_sh1 = libint_basisset[sh1].size();
+                    const auto nbf_sh2 = libint_basisset[sh2].size();
+                    const auto nbf_sh3 = libint_basisset[sh3].size();
+                    const auto nbf_sh4 = libint_basisset[sh4].size();
+
+                    for (size_t f1 = 0, f1234 = 0; f1 < nbf_sh1; f1++) {
+                        const auto p = bf1 + f1;
+                        for (size_t f2 = 0; f2 < nbf_sh2; f2++) {
+                            const auto q = bf2 + f2;
+                            for (size_t f3 = 0; f3 < nbf_sh3; f3++) {
+                                const auto r = bf3 + f3;
+                                for (size_t f4 = 0; f4 < nbf_sh4; f4++, f1234++) {  // integrals are packed in row-major form
+                                    const auto s = bf4 + f4;
+                                    const double value = degeneracy * calculated_integrals[f1234];
+
+                                    // The Coulomb and exchange contributions of the eight index permutations of (pq|rs), which each carry 1/8 of the degeneracy, pairwise combined through the symmetrization of G afterwards
+                                    G(p, q) += 0.25 * D(r, s) * value;
+                                    G(r, s) += 0.25 * D(p, q) * value;
+                                    G(p, r) -= 0.0625 * D(q, s) * value;
+                                    G(q, s) -= 0.0625 * D(p, r) * value;
+                                    G(p, s) -= 0.0625 * D(q, r) * value;
+                                    G(q, r) -= 0.0625 * D(p, s) * value;
+                                }
+                            }
+                        }
+                    }  // data access loops
+                }
+            }
+        }  // shell loops
+
+        total_number_of_skipped_quartets += skipped_quartets;
+    };
+
+
+    // The calling thread also does its share of the work, and exceptions that occur in the other threads are rethrown here
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> exceptions (number_of_threads - 1);
+    for (size_t t = 0; t < number_of_threads - 1; t++) {
+        threads.emplace_back([&calculateShellPairs, &exceptions, t] () {
+            try {
+                auto calculateThreadShellPairs = calculateShellPairs;  // copy the engine for this thread
+                calculateThreadShellPairs(t + 1);
+            } catch (...) {
+                exceptions[t] = std::current_exception();
+            }
+        });
+    }
 
+    auto calculateOwnShellPairs = calculateShellPairs;
+    calculateOwnShellPairs(0);
 
-                    auto nbf_sh1 = static_cast<long>(libint_basisset[sh1].size());  // number of basis functions in first shell
-                    auto nbf_sh2 = static_cast<long>(libint_basisset[sh2].size());  // number of basis functions in second shell
-                    auto nbf_sh3 = static_cast<long>(libint_basisset[sh3].size());  // number of basis functions in third shell
-                    auto nbf_sh4 = static_cast<long>(libint_basisset[sh4].size());  // number of basis functions in fourth shell
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
 
-                    for (auto f1 = 0L; f1 != nbf_sh1; ++f1) {
-                        for (auto f2 = 0L; f2 != nbf_sh2; ++f2) {
-                            for (auto f3 = 0L; f3 != nbf_sh3; ++f3) {
-                                for (auto f4 = 0L; f4 != nbf_sh4; ++f4) {
-                                    const auto& computed_integral = calculated_integrals[f4 + nbf_sh4 * (f3 + nbf_sh3 * (f2 + nbf_sh2 * (f1)))];  // integrals are packed in row-major form
+    number_of_skipped_quartets = total_number_of_skipped_quartets;
 
-                                    // Two-electron integrals are given in CHEMIST'S notation: (11|22)
-                                    g(f1 + bf1, f2 + bf2, f3 + bf3, f4 + bf4) = computed_integral;
-                                }
-                            }
+
+    // Sum the contributions of all threads and symmetrize
+    SquareMatrix<double> G = SquareMatrix<double>::Zero(nbf, nbf);
+    for (const auto& G_thread : thread_G) {
+        G += G_thread;
+    }
+
+    return SquareMatrix<double>(G + G.transpose());
+}
+
+
+/**
+ *  @param operator_type        the name of the operator as specified by the enumeration
+ *  @param libint_basisset      the libint2 basis set representing the AO basis
+ *
+ *  @return the K^2 diagonal two-electron integrals (pq|pq), in which the compound index pq is p + K q, calculated from the diagonal shell quartets (12|12) only
+ */
+VectorX<double> LibintInterfacer::calculateTwoElectronDiagonal(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset) const {
+
+    const auto nbf = static_cast<size_t>(libint_basisset.nbf());
+    VectorX<double> diagonal = VectorX<double>::Zero(nbf * nbf);
+
+
+    // Construct the libint2 engine
+    libint2::Engine engine (operator_type, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+    const auto& buffer = engine.results();
+
+    const auto& shell2bf = libint_basisset.shell2bf();
+
+    const auto nsh = static_cast<size_t>(libint_basisset.size());
+    for (size_t sh1 = 0; sh1 < nsh; sh1++) {
+        for (size_t sh2 = 0; sh2 <= sh1; sh2++) {
+            engine.compute(libint_basisset[sh1], libint_basisset[sh2], libint_basisset[sh1], libint_basisset[sh2]);
+
+            const auto& calculated_integrals = buffer[0];
+            if (calculated_integrals == nullptr) {  // the integrals are negligible
+                continue;
+            }
+
+            // The diagonal integrals (f1 f2|f1 f2) are found on the diagonal of the row-major (n12 x n12)-matrix of calculated integrals
+            const auto nbf_sh1 = libint_basisset[sh1].size();
+            const auto nbf_sh2 = libint_basisset[sh2].size();
+            const auto n12 = nbf_sh1 * nbf_sh2;
+            for (size_t f1 = 0; f1 < nbf_sh1; f1++) {
+                const auto p = shell2bf[sh1] + f1;
+                for (size_t f2 = 0; f2 < nbf_sh2; f2++) {
+                    const auto q = shell2bf[sh2] + f2;
+                    const auto f12 = f2 + nbf_sh2 * f1;
+
+                    diagonal(p + nbf * q) = calculated_integrals[f12 * n12 + f12];
+                    diagonal(q + nbf * p) = diagonal(p + nbf * q);
+                }
+            }
+        }
+    }
+
+    return diagonal;
+}
+
+
+/**
+ *  @param operator_type        the name of the operator as specified by the enumeration
+ *  @param libint_basisset      the libint2 basis set representing the AO basis
+ *  @param sh1                  the index of the first shell
+ *  @param sh2                  the index of the second shell
+ *
+ *  @return the (K^2 x n1 n2)-matrix of the two-electron integrals (rs|ab) for all functions a in shell 1 and b in shell 2, in which the row index is r + K s and the column index is (a - a0) + n1 (b - b0)
+ */
+MatrixX<double> LibintInterfacer::calculateTwoElectronColumns(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, size_t sh1, size_t sh2) const {
+
+    const auto nbf = static_cast<size_t>(libint_basisset.nbf());
+    const auto nbf_sh1 = libint_basisset[sh1].size();
+    const auto nbf_sh2 = libint_basisset[sh2].size();
+    MatrixX<double> columns = MatrixX<double>::Zero(nbf * nbf, nbf_sh1 * nbf_sh2);
+
+
+    // Construct the libint2 engine
+    libint2::Engine engine (operator_type, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+    const auto& buffer = engine.results();
+
+    const auto& shell2bf = libint_basisset.shell2bf();
+
+    const auto nsh = static_cast<size_t>(libint_basisset.size());
+    for (size_t sh3 = 0; sh3 < nsh; sh3++) {
+        for (size_t sh4 = 0; sh4 <= sh3; sh4++) {  // (rs|ab) = (sr|ab)
+            engine.compute(libint_basisset[sh3], libint_basisset[sh4], libint_basisset[sh1], libint_basisset[sh2]);
+
+            const auto& calculated_integrals = buffer[0];
+            if (calculated_integrals == nullptr) {  // the integrals are negligible
+                continue;
+            }
+
+            const auto nbf_sh3 = libint_basisset[sh3].size();
+            const auto nbf_sh4 = libint_basisset[sh4].size();
+            for (size_t f3 = 0; f3 < nbf_sh3; f3++) {
+                const auto r = shell2bf[sh3] + f3;
+                for (size_t f4 = 0; f4 < nbf_sh4; f4++) {
+                    const auto s = shell2bf[sh4] + f4;
+                    for (size_t f1 = 0; f1 < nbf_sh1; f1++) {
+                        for (size_t f2 = 0; f2 < nbf_sh2; f2++) {
+                            const auto& computed_integral = calculated_integrals[f2 + nbf_sh2 * (f1 + nbf_sh1 * (f4 + nbf_sh4 * f3))];  // integrals are packed in row-major form
+
+                            columns(r + nbf * s, f1 + nbf_sh1 * f2) = computed_integral;
+                            columns(s + nbf * r, f1 + nbf_sh1 * f2) = computed_integral;
                         }
-                    } // data access loops
+                    }
+                }
+            }  // data access loops
+        }
+    }  // shell loops
+
+    return columns;
+}
 
+
+/**
+ *  @param operator_type                the name of the operator as specified by the enumeration
+ *  @param libint_basisset              the libint2 basis set representing the AO basis
+ *  @param libint_auxiliary_basisset    the libint2 basis set representing the auxiliary basis
+ *
+ *  @return the (K^2 x N_aux)-matrix of the three-center integrals (pq|P), in which the compound index pq is p + K q
+ */
+MatrixX<double> LibintInterfacer::calculateThreeCenterIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset, const libint2::BasisSet& libint_auxiliary_basisset) const {
+
+    const auto nbf = static_cast<size_t>(libint_basisset.nbf());
+    const auto nbf_aux = static_cast<size_t>(libint_auxiliary_basisset.nbf());
+    MatrixX<double> integrals = MatrixX<double>::Zero(nbf * nbf, nbf_aux);
+
+
+    // The three-center integrals (P|pq) are calculated as the four-center integrals (P 1|pq) with a unit shell, so the engine has to accommodate both basis sets
+    const auto max_nprim = std::max(libint_basisset.max_nprim(), libint_auxiliary_basisset.max_nprim());
+    const auto max_l = std::max(libint_basisset.max_l(), libint_auxiliary_basisset.max_l());
+    libint2::Engine engine (operator_type, max_nprim, static_cast<int>(max_l));  // libint2 requires an int
+    const auto& buffer = engine.results();
+
+    const auto& shell2bf = libint_basisset.shell2bf();
+    const auto& aux_shell2bf = libint_auxiliary_basisset.shell2bf();
+    const auto unit_shell = libint2::Shell::unit();
+
+    const auto nsh = static_cast<size_t>(libint_basisset.size());
+    const auto nsh_aux = static_cast<size_t>(libint_auxiliary_basisset.size());
+    for (size_t sh_aux = 0; sh_aux < nsh_aux; sh_aux++) {
+        for (size_t sh1 = 0; sh1 < nsh; sh1++) {
+            for (size_t sh2 = 0; sh2 <= sh1; sh2++) {  // (P|pq) = (P|qp)
+                engine.compute(libint_auxiliary_basisset[sh_aux], unit_shell, libint_basisset[sh1], libint_basisset[sh2]);
+
+                const auto& calculated_integrals = buffer[0];
+                if (calculated_integrals == nullptr) {  // the integrals are negligible
+                    continue;
                 }
+
+                const auto nbf_sh_aux = libint_auxiliary_basisset[sh_aux].size();
+                const auto nbf_sh1 = libint_basisset[sh1].size();
+                const auto nbf_sh2 = libint_basisset[sh2].size();
+
+                for (size_t f_aux = 0; f_aux < nbf_sh_aux; f_aux++) {
+                    const auto P = aux_shell2bf[sh_aux] + f_aux;
+                    for (size_t f1 = 0; f1 < nbf_sh1; f1++) {
+                        const auto p = shell2bf[sh1] + f1;
+                        for (size_t f2 = 0; f2 < nbf_sh2; f2++) {
+                            const auto q = shell2bf[sh2] + f2;
+
+                            const auto& computed_integral = calculated_integrals[f2 + nbf_sh2 * (f1 + nbf_sh1 * f_aux)];  // integrals are packed in row-major form
+                            integrals(p + nbf * q, P) = computed_integral;
+                            integrals(q + nbf * p, P) = computed_integral;
+                        }
+                    }
+                }  // data access loops
             }
         }
-    } // shell loops
+    }  // shell loops
 
-    return g;
-};
+    return integrals;
+}
+
+
+/**
+ *  @param operator_type                the name of the operator as specified by the enumeration
+ *  @param libint_auxiliary_basisset    the libint2 basis set representing the auxiliary basis
+ *
+ *  @return the (N_aux x N_aux)-matrix of the two-center integrals (P|Q)
+ */
+SquareMatrix<double> LibintInterfacer::calculateTwoCenterIntegrals(libint2::Operator operator_type, const libint2::BasisSet& libint_auxiliary_basisset) const {
+
+    const auto nbf_aux = static_cast<size_t>(libint_auxiliary_basisset.nbf());
+    SquareMatrix<double> integrals = SquareMatrix<double>::Zero(nbf_aux, nbf_aux);
+
+
+    // The two-center integrals (P|Q) are calculated as the four-center integrals (P 1|Q 1) with unit shells
+    libint2::Engine engine (operator_type, libint_auxiliary_basisset.max_nprim(), static_cast<int>(libint_auxiliary_basisset.max_l()));  // libint2 requires an int
+    const auto& buffer = engine.results();
+
+    const auto& shell2bf = libint_auxiliary_basisset.shell2bf();
+    const auto unit_shell = libint2::Shell::unit();
+
+    const auto nsh = static_cast<size_t>(libint_auxiliary_basisset.size());
+    for (size_t sh1 = 0; sh1 < nsh; sh1++) {
+        for (size_t sh2 = 0; sh2 <= sh1; sh2++) {
+            engine.compute(libint_auxiliary_basisset[sh1], unit_shell, libint_auxiliary_basisset[sh2], unit_shell);
+
+            const auto& calculated_integrals = buffer[0];
+            if (calculated_integrals == nullptr) {  // the integrals are negligible
+                continue;
+            }
+
+            const auto nbf_sh1 = libint_auxiliary_basisset[sh1].size();
+            const auto nbf_sh2 = libint_auxiliary_basisset[sh2].size();
+            for (size_t f1 = 0; f1 < nbf_sh1; f1++) {
+                for (size_t f2 = 0; f2 < nbf_sh2; f2++) {
+                    const auto P = shell2bf[sh1] + f1;
+                    const auto Q = shell2bf[sh2] + f2;
+
+                    integrals(P, Q) = calculated_integrals[f2 + nbf_sh2 * f1];  // integrals are packed in row-major form
+                    integrals(Q, P) = integrals(P, Q);
+                }
+            }
+        }
+    }
+
+    return integrals;
+}
+
+
+/**
+ *  @param operator_type        the name of the operator as specified by the enumeration
+ *  @param libint_basisset      the libint2 basis set representing the AO basis
+ *
+ *  @return the (nsh x nsh)-matrix of the Schwarz bounds sqrt(max |(ab|ab)|) for every pair of shells a and b, such that |(ab|cd)| <= bound(a,b) * bound(c,d)
+ */
+SquareMatrix<double> LibintInterfacer::calculateSchwarzBounds(libint2::Operator operator_type, const libint2::BasisSet& libint_basisset) const {
+
+    const auto nsh = static_cast<size_t>(libint_basisset.size());  // nsh: number of shells in the basisset
+    SquareMatrix<double> bounds = SquareMatrix<double>::Zero(nsh, nsh);
+
+
+    // Construct the libint2 engine
+    libint2::Engine engine (operator_type, libint_basisset.max_nprim(), static_cast<int>(libint_basisset.max_l()));  // libint2 requires an int
+    const auto& buffer = engine.results();
+
+
+    for (size_t sh1 = 0; sh1 < nsh; sh1++) {
+        for (size_t sh2 = 0; sh2 <= sh1; sh2++) {
+            engine.compute(libint_basisset[sh1], libint_basisset[sh2], libint_basisset[sh1], libint_basisset[sh2]);
+
+            const auto& calculated_integrals = buffer[0];
+            if (calculated_integrals == nullptr) {  // the integrals are negligible
+                continue;
+            }
+
+            // The diagonal integrals (f1 f2|f1 f2) are found on the diagonal of the row-major (n12 x n12)-matrix of calculated integrals
+            const auto n12 = libint_basisset[sh1].size() * libint_basisset[sh2].size();
+            double maximum = 0.0;
+            for (size_t f12 = 0; f12 < n12; f12++) {
+                maximum = std::max(maximum, std::abs(calculated_integrals[f12 * n12 + f12]));
+            }
+
+            bounds(sh1, sh2) = std::sqrt(maximum);
+            bounds(sh2, sh1) = bounds(sh1, sh2);
+        }
+    }
+
+    return bounds;
+}
 
 
 }  // namespace GQCP
@@ -21,6 +21,14 @@
 #include "math/optimization/DavidsonSolver.hpp"
 #include "math/optimization/SparseSolver.hpp"
 
+#include "FockSpace/FrozenProductFockSpace.hpp"
+#include "FockSpace/ProductFockSpace.hpp"
+#include "FockSpace/SelectedFockSpace.hpp"
+#include "HamiltonianBuilder/SelectedCI.hpp"
+
+#include <functional>
+#include <numeric>
+
 
 namespace GQCP {
 
@@ -46,13 +54,160 @@ CISolver::CISolver(const HamiltonianBuilder& hamiltonian_builder, const Hamilton
 
 
 /*
- *  CONSTRUCTORS
+ *  STATIC PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_builder          the HamiltonianBuilder whose Fock space spans the CI eigenvalue problem
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal basis
+ *  @param diagonal                     the diagonal of the Hamiltonian matrix, as calculated by the HamiltonianBuilder
+ *  @param number_of_guesses            the number of initial guesses that should be generated
+ *  @param block_dimension              the number of lowest-diagonal configurations that span the block that is diagonalized
+ *  @param degeneracy_threshold         the threshold on the diagonal values below which configurations are considered degenerate
+ *  @param spin_pairing                 if the spin-flipped partners of the selected configurations should be added to the block (only for Ms=0 product Fock spaces)
+ *
+ *  @return the lowest eigenvectors of the Hamiltonian matrix in the space of the configurations with the lowest diagonal values, as columns of a (dim x number_of_guesses)-matrix
+ *
+ *  Degenerate configurations are not split up: the block is extended with the configurations that are degenerate with the last selected one, up to twice the given block dimension
+ */
+MatrixX<double> CISolver::calculateDiagonalGuess(const HamiltonianBuilder& hamiltonian_builder, const HamiltonianParameters<double>& hamiltonian_parameters, const VectorX<double>& diagonal, size_t number_of_guesses, size_t block_dimension, double degeneracy_threshold, bool spin_pairing) {
+
+    const BaseFockSpace& fock_space = *hamiltonian_builder.get_fock_space();
+    size_t dim = fock_space.get_dimension();
+    size_t K = fock_space.get_K();
+
+    if (diagonal.size() != dim) {
+        throw std::invalid_argument("CISolver::calculateDiagonalGuess(HamiltonianBuilder, HamiltonianParameters<double>, VectorX<double>, size_t, size_t, double, bool): The diagonal is not compatible with the Fock space of the HamiltonianBuilder.");
+    }
+
+    if ((number_of_guesses == 0) || (number_of_guesses > dim)) {
+        throw std::invalid_argument("CISolver::calculateDiagonalGuess(HamiltonianBuilder, HamiltonianParameters<double>, VectorX<double>, size_t, size_t, double, bool): The number of guesses must be between 1 and the dimension of the Fock space.");
+    }
+
+    block_dimension = std::min(std::max(block_dimension, number_of_guesses), dim);
+
+
+    // Prepare the conversion of addresses to configurations, and of addresses to the addresses of their spin-flipped partners
+    std::function<Configuration(size_t)> makeConfiguration;
+    size_t N_alpha = 0;
+    size_t N_beta = 0;
+    size_t dim_beta = 0;  // the dimension of the beta Fock space, if the spin-flipped partners should be added
+    switch (fock_space.get_type()) {
+
+        case FockSpaceType::FockSpace: {
+            const auto& doci_fock_space = dynamic_cast<const FockSpace&>(fock_space);
+            N_alpha = N_beta = doci_fock_space.get_N();
+            makeConfiguration = [&doci_fock_space](size_t I) { ONV onv = doci_fock_space.makeONV(I); return Configuration {onv, onv}; };
+            break;
+        }
+
+        case FockSpaceType::FrozenFockSpace: {
+            const auto& doci_fock_space = dynamic_cast<const FrozenFockSpace&>(fock_space);
+            N_alpha = N_beta = doci_fock_space.get_N();
+            makeConfiguration = [&doci_fock_space](size_t I) { ONV onv = doci_fock_space.makeONV(I); return Configuration {onv, onv}; };
+            break;
+        }
+
+        case FockSpaceType::ProductFockSpace: {
+            const auto& product_fock_space = dynamic_cast<const ProductFockSpace&>(fock_space);
+            N_alpha = product_fock_space.get_N_alpha();
+            N_beta = product_fock_space.get_N_beta();
+            size_t dim_b = product_fock_space.get_fock_space_beta().get_dimension();
+            makeConfiguration = [&product_fock_space, dim_b](size_t I) { return Configuration {product_fock_space.get_fock_space_alpha().makeONV(I / dim_b), product_fock_space.get_fock_space_beta().makeONV(I % dim_b)}; };
+            if (spin_pairing && (N_alpha == N_beta)) {
+                dim_beta = dim_b;
+            }
+            break;
+        }
+
+        case FockSpaceType::FrozenProductFockSpace: {
+            const auto& product_fock_space = dynamic_cast<const FrozenProductFockSpace&>(fock_space);
+            N_alpha = product_fock_space.get_N_alpha();
+            N_beta = product_fock_space.get_N_beta();
+            size_t dim_b = product_fock_space.get_frozen_fock_space_beta().get_dimension();
+            makeConfiguration = [&product_fock_space, dim_b](size_t I) { return Configuration {product_fock_space.get_frozen_fock_space_alpha().makeONV(I / dim_b), product_fock_space.get_frozen_fock_space_beta().makeONV(I % dim_b)}; };
+            if (spin_pairing && (N_alpha == N_beta)) {
+                dim_beta = dim_b;
+            }
+            break;
+        }
+
+        case FockSpaceType::SelectedFockSpace: {
+            const auto& selected_fock_space = dynamic_cast<const SelectedFockSpace&>(fock_space);
+            N_alpha = selected_fock_space.get_N_alpha();
+            N_beta = selected_fock_space.get_N_beta();
+            makeConfiguration = [&selected_fock_space](size_t I) { return selected_fock_space.get_configuration(I); };
+            break;
+        }
+    }
+
+
+    // Select the configurations with the lowest diagonal values, keeping degenerate configurations and spin-flipped partners together
+    std::vector<size_t> sorted_addresses (dim);
+    std::iota(sorted_addresses.begin(), sorted_addresses.end(), 0);
+    std::stable_sort(sorted_addresses.begin(), sorted_addresses.end(), [&diagonal](size_t I, size_t J) { return diagonal(I) < diagonal(J); });
+
+    std::vector<size_t> selected_addresses;
+    std::vector<bool> is_selected (dim, false);
+    for (size_t I : sorted_addresses) {
+
+        if (is_selected[I]) {
+            continue;
+        }
+
+        if (selected_addresses.size() >= block_dimension) {
+            bool is_degenerate = (diagonal(I) - diagonal(selected_addresses.back())) < degeneracy_threshold;
+            if (!is_degenerate || (selected_addresses.size() >= 2 * block_dimension)) {
+                break;
+            }
+        }
+
+        selected_addresses.push_back(I);
+        is_selected[I] = true;
+
+        if (dim_beta > 0) {
+            size_t I_flipped = (I % dim_beta) * dim_beta + I / dim_beta;
+            if (!is_selected[I_flipped]) {
+                selected_addresses.push_back(I_flipped);
+                is_selected[I_flipped] = true;
+            }
+        }
+    }
+
+
+    // Diagonalize the Hamiltonian matrix in the space of the selected configurations
+    SelectedFockSpace block_fock_space (K, N_alpha, N_beta);
+    for (size_t I : selected_addresses) {
+        Configuration configuration = makeConfiguration(I);
+        block_fock_space.addConfiguration(configuration.onv_alpha, configuration.onv_beta);
+    }
+
+    SelectedCI block_builder (block_fock_space);
+    SquareMatrix<double> block_hamiltonian = block_builder.constructHamiltonian(hamiltonian_parameters);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> block_eigensolver (block_hamiltonian);
+
+
+    // Embed the lowest eigenvectors of the block in the full Fock space
+    MatrixX<double> X_0 = MatrixX<double>::Zero(dim, number_of_guesses);
+    for (size_t i = 0; i < selected_addresses.size(); i++) {
+        X_0.row(selected_addresses[i]) = block_eigensolver.eigenvectors().row(i).head(number_of_guesses);
+    }
+
+    return X_0;
+}
+
+
+
+/*
+ *  PUBLIC METHODS
  */
 
 /**
  *  @param solver_options       specify a type of solver and its options
  *
  *  Solve the CI eigenvalue problem and set the eigenpairs internally
+ *
+ *  If the Davidson solver options don't contain any initial guesses, they are generated with calculateDiagonalGuess()
  */
 void CISolver::solve(const BaseSolverOptions& solver_options) {
 
@@ -75,7 +230,12 @@ void CISolver::solve(const BaseSolverOptions& solver_options) {
             auto diagonal = this->hamiltonian_builder->calculateDiagonal(this->hamiltonian_parameters);
             VectorFunction matrixVectorProduct = [this, &diagonal](const VectorX<double>& x) { return hamiltonian_builder->matrixVectorProduct(hamiltonian_parameters, x, diagonal); };
 
-            DavidsonSolver solver (matrixVectorProduct, diagonal, dynamic_cast<const DavidsonSolverOptions&>(solver_options));
+            DavidsonSolverOptions davidson_solver_options = dynamic_cast<const DavidsonSolverOptions&>(solver_options);
+            if (davidson_solver_options.X_0.cols() == 0) {
+                davidson_solver_options.X_0 = CISolver::calculateDiagonalGuess(*this->hamiltonian_builder, this->hamiltonian_parameters, diagonal, davidson_solver_options.number_of_requested_eigenpairs);
+            }
+
+            DavidsonSolver solver (matrixVectorProduct, diagonal, davidson_solver_options);
 
             solver.solve();
             this->eigenpairs = solver.get_eigenpairs();
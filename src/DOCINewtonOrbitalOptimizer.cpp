@@ -17,6 +17,11 @@
 // 
 #include "DOCINewtonOrbitalOptimizer.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
 #include <unsupported/Eigen/MatrixFunctions>
 
 #include "CISolver/CISolver.hpp"
@@ -25,6 +30,7 @@
 #include "utilities/linalg.hpp"
 #include "math/optimization/step.hpp"
 #include "math/optimization/EigenproblemSolverOptions.hpp"
+#include "math/optimization/LimitedMemoryBFGS.hpp"
 
 
 namespace GQCP {
@@ -70,6 +76,8 @@ const Eigenpair& DOCINewtonOrbitalOptimizer::get_eigenpair(size_t index) const {
 /**
  *  Do the orbital optimization for DOCI
  *
+ *  After every iteration, the attached observers are notified with the norm of the orbital gradient, the DOCI energies and the time spent in the CI solver
+ *
  *  @param solver_options       solver options for the CI solver
  *  @param oo_options           options for the orbital optimization
  */
@@ -78,11 +86,69 @@ void DOCINewtonOrbitalOptimizer::solve(BaseSolverOptions& solver_options, const
     auto K = this->ham_par.get_K();
     RDMCalculator rdm_calculator(*this->doci.get_fock_space());  // make the RDMCalculator beforehand, it doesn't have to be constructed in every iteration
     size_t oo_iterations = 0;
+
+    // The state of the trust region, for trust-region Newton and quasi-Newton steps
+    const bool use_trust_region = (oo_options.step_type != OrbitalOptimizationStep::NEWTON);
+    const double energy_noise = 1.0e-12;  // energy changes that are smaller than this don't contain information about the quality of a step
+    double trust_region_radius = oo_options.trust_region_radius;
+    double previous_energy = 0.0;
+    double predicted_change = 0.0;  // the energy change that the quadratic model predicted for the previous step, or zero if there is no step to be judged
+    double step_norm = 0.0;
+    std::shared_ptr<HamiltonianParameters<double>> previous_ham_par;  // the Hamiltonian parameters before the previous step, which are restored if that step is rejected; they are only kept for trust-region steps, since a Newton step would otherwise keep the original two-electron integrals alive after the rotation copies them
+
+    // The state of the quasi-Newton steps
+    const double minimum_curvature = 1.0e-04;  // the lower bound on the (absolute) diagonal elements of the orbital Hessian, which guards against very long steps along (nearly) redundant rotations
+    LimitedMemoryBFGS lbfgs (oo_options.maximum_history_size);
+    VectorX<double> previous_gradient_vector;
+    VectorX<double> previous_kappa_vector;  // the previous step, or an empty vector if there is no (accepted) step that provides curvature information
+
     while (!(this->is_converged)) {
+        auto start = std::chrono::steady_clock::now();
+
+        IterationRecord record;  // the diagnostics of this iteration
+        record.solver = "DOCINewtonOrbitalOptimizer";
+        record.iteration = oo_iterations;
+
 
         // Solve the DOCI eigenvalue equation, using the options provided
         CISolver doci_solver (this->doci, this->ham_par);  // update the CI solver with the rotated Hamiltonian parameters
         doci_solver.solve(solver_options);
+
+        record.number_of_matvecs = 1;  // the CI solve plays the role of the expensive operator application
+        record.matvec_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (const auto& eigenpair : doci_solver.get_eigenpairs()) {
+            record.eigenvalues.push_back(eigenpair.get_eigenvalue());
+        }
+        double energy = doci_solver.get_eigenpair().get_eigenvalue();
+
+
+        // Compare the energy change of the previous trust-region step with the predicted one, update the trust region and reject the step if the energy has increased
+        if (use_trust_region && (std::abs(predicted_change) > energy_noise)) {
+            double actual_change = energy - previous_energy;
+            double ratio = actual_change / predicted_change;
+
+            if (ratio < 0.25) {
+                trust_region_radius = 0.25 * step_norm;
+            } else if ((ratio > 0.75) && (step_norm > 0.99 * trust_region_radius)) {
+                trust_region_radius = std::min(2 * trust_region_radius, oo_options.maximum_trust_region_radius);
+            }
+
+            predicted_change = 0.0;
+            if (actual_change > energy_noise) {
+                this->ham_par = *previous_ham_par;  // the next iteration starts again from the previous orbitals, within the smaller trust region
+                previous_kappa_vector.resize(0);
+
+                oo_iterations++;
+                if (oo_iterations >= oo_options.maximum_number_of_iterations) {
+                    this->finishIteration(record, start);
+                    throw std::runtime_error("DOCINewtonOrbitalOptimizer::solve(BaseSolverOptions, OrbitalOptimizationOptions): The OO-DOCI procedure failed to converge in the maximum number of allowed iterations.");
+                }
+
+                this->finishIteration(record, start);
+                continue;
+            }
+        }
+
         rdm_calculator.set_coefficients(doci_solver.get_eigenpair().get_eigenvector());
 
         // Calculate the 1- and 2-RDMs
@@ -95,54 +161,135 @@ void DOCINewtonOrbitalOptimizer::solve(BaseSolverOptions& solver_options, const
         SquareMatrix<double> gradient_matrix = 2 * (F - F.transpose());
         VectorX<double> gradient_vector = gradient_matrix.strictLowerTriangle();  // gradient vector with the free parameters, at kappa = 0
 
+        record.residual_norms = {gradient_vector.norm()};
 
-        // Calculate the electronic Hessian at kappa = 0
-        auto W = this->ham_par.calculateSuperGeneralizedFockMatrix(D, d);
-        SquareRankFourTensor<double> hessian_tensor (K);
-        hessian_tensor.setZero();
+        VectorX<double> kappa_vector;  // with only the free parameters
+        if (!use_trust_region) {
 
-        for (size_t p = 0; p < K; p++) {
-            for (size_t q = 0; q < K; q++) {
-                for (size_t r = 0; r < K; r++) {
-                    for (size_t s = 0; s < K; s++) {
-                        hessian_tensor(p,q,r,s) = W(p,q,r,s) - W(p,q,s,r) + W(q,p,s,r) - W(q,p,r,s) + W(r,s,p,q) - W(r,s,q,p) + W(s,r,q,p) - W(s,r,p,q);
+            // Calculate the electronic Hessian at kappa = 0
+            auto W = this->ham_par.calculateSuperGeneralizedFockMatrix(D, d);
+            SquareRankFourTensor<double> hessian_tensor (K);
+            hessian_tensor.setZero();
+
+            for (size_t p = 0; p < K; p++) {
+                for (size_t q = 0; q < K; q++) {
+                    for (size_t r = 0; r < K; r++) {
+                        for (size_t s = 0; s < K; s++) {
+                            hessian_tensor(p,q,r,s) = W(p,q,r,s) - W(p,q,s,r) + W(q,p,s,r) - W(q,p,r,s) + W(r,s,p,q) - W(r,s,q,p) + W(s,r,q,p) - W(s,r,p,q);
+                        }
                     }
                 }
             }
-        }
-        auto hessian_matrix = hessian_tensor.pairWiseStrictReduce();  // hessian matrix with only the free parameters, at kappa = 0
+            auto hessian_matrix = hessian_tensor.pairWiseStrictReduce();  // hessian matrix with only the free parameters, at kappa = 0
+
+            Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> hessian_solver (hessian_matrix);
+
+            record.allocated_bytes = (2 * W.size() + hessian_matrix.size()) * sizeof(double);  // the super-generalized Fock matrix and both forms of the Hessian
+
+
+            // Perform a Newton-step to find orbital rotation parameters kappa
+            VectorFunction gradient_function = [gradient_vector](const VectorX<double>& x) { return gradient_vector; };
+            MatrixFunction hessian_function = [hessian_matrix](const VectorX<double>& x) { return hessian_matrix; };
 
-        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> hessian_solver (hessian_matrix);
+            kappa_vector = newtonStep(VectorX<double>::Zero(K), gradient_function, hessian_function);
 
 
-        // Perform a Newton-step to find orbital rotation parameters kappa
-        VectorFunction gradient_function = [gradient_vector](const VectorX<double>& x) { return gradient_vector; };
-        MatrixFunction hessian_function = [hessian_matrix](const VectorX<double>& x) { return hessian_matrix; };
+            // If the calculated norm is zero, we have reached a critical point
+            if (gradient_vector.norm() < oo_options.convergence_threshold) {
 
-        VectorX<double> kappa_vector = newtonStep(VectorX<double>::Zero(K), gradient_function, hessian_function);  // with only the free parameters
+                // If we have found a critical point, but we have a negative eigenvalue for the Hessian, continue in that direction
+                if (hessian_solver.eigenvalues()(0) < 0) {
+                    kappa_vector = hessian_solver.eigenvectors().col(0);
+                }
+                else {  // the Hessian is confirmed to be positive definite, so we have reached a minimum
+                    this->is_converged = true;
+                }
+            }
 
+        } else {
 
-        // If the calculated norm is zero, we have reached a critical point
-        if (gradient_vector.norm() < oo_options.convergence_threshold) {
+            // The orbital Hessian is only needed through its products with (free) orbital rotation parameters, and quasi-Newton steps only need it to characterize a critical point
+            size_t number_of_hessian_vector_products = 0;
+            VectorFunction hessian_vector_product = [this, &D, &d, &F, &number_of_hessian_vector_products] (const VectorX<double>& x) {
+                auto kappa_matrix = SquareMatrix<double>::FromStrictTriangle(x);
+                SquareMatrix<double> kappa_matrix_transpose = kappa_matrix.transpose();
+                kappa_matrix -= kappa_matrix_transpose;
 
-            // If we have found a critical point, but we have a negative eigenvalue for the Hessian, continue in that direction
-            if (hessian_solver.eigenvalues()(0) < 0) {
-                kappa_vector = hessian_solver.eigenvectors().col(0);
+                number_of_hessian_vector_products++;
+                return VectorX<double>(this->ham_par.calculateOrbitalHessianVectorProduct(D, d, F, kappa_matrix).strictLowerTriangle());
+            };
+
+
+            // The L-BFGS update uses the previous step, together with the change of the gradient that it caused
+            if ((oo_options.step_type == OrbitalOptimizationStep::L_BFGS) && (previous_kappa_vector.size() > 0)) {
+                lbfgs.update(previous_kappa_vector, gradient_vector - previous_gradient_vector);
             }
-            else {  // the Hessian is confirmed to be positive definite, so we have reached a minimum
-                this->is_converged = true;
 
-                // Set solutions
-                this->eigenpairs = doci_solver.get_eigenpairs();
+            if (oo_options.step_type == OrbitalOptimizationStep::TRUST_REGION_NEWTON) {
+                record.allocated_bytes = d.size() * sizeof(double);  // the rotated 2-RDM in a Hessian-vector product
+            } else {
+                record.allocated_bytes = 2 * lbfgs.size() * gradient_vector.size() * sizeof(double);  // the L-BFGS history
+            }
+
+
+            if (gradient_vector.norm() < oo_options.convergence_threshold) {
+
+                // At a critical point, a (Lanczos) estimate of the lowest eigenvalue of the Hessian tells if we have reached a minimum or a saddle point
+                if (gradient_vector.size() > 0) {
+                    auto lowest_eigenpair = lanczosLowestEigenpair(hessian_vector_product, VectorX<double>::Random(gradient_vector.size()));
+
+                    if (lowest_eigenpair.get_eigenvalue() < -oo_options.convergence_threshold) {  // continue along the direction of negative curvature, up to the boundary of the trust region
+                        kappa_vector = trust_region_radius * lowest_eigenpair.get_eigenvector();
+                        predicted_change = 0.5 * lowest_eigenpair.get_eigenvalue() * std::pow(trust_region_radius, 2);
+                    } else {
+                        this->is_converged = true;
+                    }
+                } else {
+                    this->is_converged = true;
+                }
 
-                break;  // no need to continue if we have converged
+            } else if (oo_options.step_type == OrbitalOptimizationStep::TRUST_REGION_NEWTON) {
+                kappa_vector = trustRegionNewtonStep(gradient_vector, hessian_vector_product, trust_region_radius, predicted_change);
+
+            } else {  // a quasi-Newton step, for which only the orbital gradient and the diagonal of the orbital Hessian are needed
+                VectorX<double> hessian_diagonal = this->ham_par.calculateOrbitalHessianDiagonal(D, d, F).cwiseAbs().cwiseMax(minimum_curvature);
+
+                VectorX<double> direction;
+                if (oo_options.step_type == OrbitalOptimizationStep::DIAGONAL_HESSIAN) {
+                    direction = -gradient_vector.cwiseQuotient(hessian_diagonal);
+                } else {
+                    direction = -lbfgs.inverseHessianProduct(gradient_vector, hessian_diagonal);
+                }
+
+                // Scale the step to the trust region. The quadratic model has a Hessian B for which B direction = -gradient, so that the predicted change is (s - s^2/2) gradient^T direction for a step s direction
+                double scaling = std::min(1.0, trust_region_radius / direction.norm());
+                kappa_vector = scaling * direction;
+                predicted_change = (scaling - 0.5 * scaling * scaling) * gradient_vector.dot(direction);
             }
 
+            record.number_of_matvecs += number_of_hessian_vector_products;
+            previous_gradient_vector = gradient_vector;
+            step_norm = kappa_vector.norm();
+            previous_energy = energy;
+            previous_ham_par = std::make_shared<HamiltonianParameters<double>>(this->ham_par);
+            previous_kappa_vector = kappa_vector;
+        }
 
-        } else {
+
+        if (this->is_converged) {
+
+            // Set solutions
+            this->eigenpairs = doci_solver.get_eigenpairs();
+
+            this->finishIteration(record, start);
+            break;  // no need to continue if we have converged
+        }
+
+        if (gradient_vector.norm() >= oo_options.convergence_threshold) {
             oo_iterations++;
 
             if (oo_iterations >= oo_options.maximum_number_of_iterations) {
+                this->finishIteration(record, start);
                 throw std::runtime_error("DOCINewtonOrbitalOptimizer::solve(BaseSolverOptions, OrbitalOptimizationOptions): The OO-DOCI procedure failed to converge in the maximum number of allowed iterations.");
             }
         }
@@ -172,6 +319,8 @@ void DOCINewtonOrbitalOptimizer::solve(BaseSolverOptions& solver_options, const
 
             solver_options = davidson_solver_options;
         }
+
+        this->finishIteration(record, start);
     }  // while not converged
 }
 
@@ -242,4 +242,21 @@ void SelectedFockSpace::addConfiguration(const std::vector<std::string>& onv1s,
 }
 
 
+/**
+ *  Add a configuration to this Fock space
+ *
+ *  @param onv_alpha    the alpha ONV
+ *  @param onv_beta     the beta ONV
+ */
+void SelectedFockSpace::addConfiguration(const ONV& onv_alpha, const ONV& onv_beta) {
+
+    if ((onv_alpha.get_occupation_indices().size() != this->N_alpha) || (onv_beta.get_occupation_indices().size() != this->N_beta)) {
+        throw std::invalid_argument("SelectedFockSpace::addConfiguration(ONV, ONV): The given ONVs are not compatible with the number of electrons of the Fock space");
+    }
+
+    this->dim++;
+    configurations.push_back(Configuration {onv_alpha, onv_beta});
+}
+
+
 }  // namespace GQCP
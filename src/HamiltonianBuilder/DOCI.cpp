@@ -189,6 +189,11 @@ VectorX<double> DOCI::calculateDiagonal(const HamiltonianParameters<double>& ham
     size_t dim = this->fock_space.get_dimension();
     VectorX<double> diagonal = VectorX<double>::Zero(dim);
 
+    // Only the pair integrals (pp|qq) and (pq|qp) contribute to the diagonal
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto coulomb = hamiltonian_parameters.calculateCoulombDiagonal();
+    const auto exchange = hamiltonian_parameters.calculateExchangeDiagonal();
+
     // Create the first spin string. Since in DOCI, alpha == beta, we can just treat them as one and multiply all contributions by 2
     ONV onv = this->fock_space.makeONV(0);  // onv with address 0
 
@@ -196,11 +201,11 @@ VectorX<double> DOCI::calculateDiagonal(const HamiltonianParameters<double>& ham
         double double_I = 0;
         for (size_t e1 = 0; e1 < this->fock_space.get_N(); e1++) {  // e1 (electron 1) loops over the (number of) electrons
             size_t p = onv.get_occupation_index(e1);  // retrieve the index of the orbital the electron occupies
-            double_I += 2 * hamiltonian_parameters.get_h()(p,p) + hamiltonian_parameters.get_g()(p,p,p,p);
+            double_I += 2 * h(p,p) + coulomb(p,p);
             for (size_t e2 = 0; e2 < e1; e2++) {  // e2 (electron 2) loops over the (number of) electrons
                 // Since we are doing a restricted summation q<p (and thus e2<e1), we should multiply by 2 since the summand argument is symmetric.
                 size_t q = onv.get_occupation_index(e2);  // retrieve the index of the orbital the electron occupies
-                double_I += 2 * (2*hamiltonian_parameters.get_g()(p,p,q,q) - hamiltonian_parameters.get_g()(p,q,q,p));
+                double_I += 2 * (2*coulomb(p,q) - exchange(p,q));
             }  // q or e2 loop
         } // p or e1 loop
 
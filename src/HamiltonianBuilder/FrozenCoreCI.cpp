@@ -118,40 +118,18 @@ HamiltonianParameters<double> FrozenCoreCI::freezeHamiltonianParameters(const Ha
     size_t K_active = K - X;  // number of non-frozen orbitals
 
 
-    // Copy one-electron integrals from the non-frozen orbitals
+    // Copy the overlap integrals from the non-frozen orbitals
     OneElectronOperator<double> S (ham_par.get_S().block(X, X, K_active, K_active));  // active
-    OneElectronOperator<double> h (ham_par.get_h().block(X, X, K_active, K_active));  // active
-
-    // Copy two-electron integrals from the non-frozen orbitals
-    const auto& g = ham_par.get_g();  // total
 
     // 'Freeze' the Hamiltonian parameters
-    // This amounts to modifying the (active) one-electron integrals using derived formulas
-    for (size_t i = 0; i < K_active; i++) {  // iterate over the active orbitals
-
-        size_t q = i + X;  // map active orbitals indexes to total orbital indexes (those including the frozen orbitals)
-
-        for (size_t l = 0; l < X; l++) {  // iterate over the frozen orbitals
-            h(i,i) += g(q,q,l,l) + g(l,l,q,q) - g(q,l,l,q)/2 - g(l,q,q,l)/2;
-        }
-
-        for (size_t j = i+1; j < K_active; j++) {  // iterate over the active orbitals
-
-            size_t p = j + X;  // map active orbitals indexes to total orbital indexes (those including the frozen orbitals)
-
-            for (size_t l = 0; l < X; l++) {  // iterate over the frozen orbitals
-
-                h(i,j) += g(q,p,l,l) + g(l,l,q,p) - g(q,l,l,p)/2 - g(l,p,q,l)/2;
-                h(j,i) += g(p,q,l,l) + g(l,l,p,q) - g(p,l,l,q)/2 - g(l,q,p,l)/2;
-            }
-        }
-    }
+    // This amounts to modifying the (active) one-electron integrals using derived formulas, which are memoized by the Hamiltonian parameters themselves
+    OneElectronOperator<double> h = ham_par.calculateFrozenCoreFockMatrix(X);
 
     std::shared_ptr<AOBasis> ao_basis;  // nullptr
     auto g_new = TwoElectronOperator<double>::FromBlock(ham_par.get_g(), X, X, X, X);
     SquareMatrix<double> T = ham_par.get_T_total().block(X, X, K_active, K_active);
 
-    return HamiltonianParameters<double>(ao_basis, S, h, g_new, T);
+    return HamiltonianParameters<double>(ao_basis, S, h, std::move(g_new), T);
 }
 
 
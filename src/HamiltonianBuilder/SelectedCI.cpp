@@ -29,8 +29,8 @@ void SelectedCI::evaluateHamiltonianElements(const HamiltonianParameters<double>
     size_t dim = fock_space.get_dimension();
     size_t K = fock_space.get_K();
 
-    auto h = hamiltonian_parameters.get_h();
-    auto g = hamiltonian_parameters.get_g();
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
 
     for (size_t I = 0; I < dim; I++) {  // loop over all addresses (1)
         Configuration configuration_I = this->fock_space.get_configuration(I);
@@ -274,8 +274,8 @@ VectorX<double> SelectedCI::calculateDiagonal(const HamiltonianParameters<double
 
     auto dim = fock_space.get_dimension();
 
-    auto h = hamiltonian_parameters.get_h();
-    auto g = hamiltonian_parameters.get_g();
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
 
     // Diagonal contributions
     VectorX<double> diagonal = VectorX<double>::Zero(dim);
@@ -0,0 +1,321 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "HamiltonianParameters/AOIntegralCache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace GQCP {
+
+
+/*
+ *  The layout of an integral file, in native byte order:
+ *      - the magic string "GQCPAOI1" (8 bytes)
+ *      - the length of the key (uint64) and the key itself, padded with zeros to a multiple of 8 bytes so that the integrals are aligned in a memory-mapped file
+ *      - the number of basis functions K (uint64) and the number of packed two-electron integrals (uint64)
+ *      - S, T and V (K^2 doubles each, column-major) and the eight-fold packed two-electron integrals
+ */
+constexpr char aointegralcache_magic[] = "GQCPAOI1";
+constexpr size_t aointegralcache_magic_size = 8;
+constexpr size_t aointegralcache_alignment = 8;
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param directory        the (existing) directory in which the integral files should be stored
+ *  @param tolerance        the spacing (in bohr) of the grid on which the coordinates of the atoms are rounded, so that geometries that only differ by numerical noise share their integrals
+ */
+AOIntegralCache::AOIntegralCache(const std::string& directory, double tolerance) :
+    directory (directory),
+    tolerance (tolerance)
+{
+    if (tolerance <= 0.0) {
+        throw std::invalid_argument("AOIntegralCache::AOIntegralCache(std::string, double): The tolerance must be positive.");
+    }
+
+    struct stat status;
+    if ((stat(directory.c_str(), &status) != 0) || !S_ISDIR(status.st_mode)) {
+        throw std::invalid_argument("AOIntegralCache::AOIntegralCache(std::string, double): The directory " + directory + " does not exist.");
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param molecule                 the molecule on whose atoms the basis functions are centered
+ *  @param basisset_name            the name of the basis set, e.g. "STO-3G"
+ *  @param screening_threshold      the threshold for the Schwarz screening of the two-electron integrals, or 0 (the default) for exact integrals, as in HamiltonianParameters::Molecular()
+ *
+ *  @return the key that describes the AO integrals: the rounded geometry, the (case-insensitive) basis set name and the integral options. The charge of the molecule is irrelevant for the integrals, so it isn't part of the key
+ */
+std::string AOIntegralCache::key(const Molecule& molecule, const std::string& basisset_name, double screening_threshold) const {
+
+    std::string lowercase_basisset_name = basisset_name;
+    std::transform(lowercase_basisset_name.begin(), lowercase_basisset_name.end(), lowercase_basisset_name.begin(), [] (unsigned char c) { return std::tolower(c); });
+
+    std::ostringstream key_stream;
+    key_stream << "basis=" << lowercase_basisset_name;
+    key_stream << ";screening=" << std::scientific << std::setprecision(6) << screening_threshold;
+    key_stream << ";tolerance=" << this->tolerance;
+
+    // The coordinates are written as integer multiples of the tolerance, so that their representation is exact
+    key_stream << ";atoms=";
+    for (const auto& atom : molecule.get_atoms()) {
+        key_stream << atom.atomic_number;
+        for (size_t i = 0; i < 3; i++) {
+            key_stream << ((i == 0) ? ':' : ',') << std::llround(atom.position(i) / this->tolerance);
+        }
+        key_stream << ';';
+    }
+
+    return key_stream.str();
+}
+
+
+/**
+ *  @param key      the key that describes the AO integrals
+ *
+ *  @return the name of the file in which the AO integrals with the given key are (or would be) stored
+ */
+std::string AOIntegralCache::filename(const std::string& key) const {
+
+    // Use the 64-bit FNV-1a hash of the key
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream filename_stream;
+    filename_stream << this->directory << "/gqcp_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".aoints";
+    return filename_stream.str();
+}
+
+
+/**
+ *  @param key      the key that describes the AO integrals
+ *
+ *  @return if integrals with the given key are stored in this cache
+ */
+bool AOIntegralCache::contains(const std::string& key) const {
+
+    std::ifstream input_file (this->filename(key), std::ios::binary);
+    if (!input_file.good()) {
+        return false;
+    }
+
+    // Only the header has to be checked: if the hashes of two keys collide, the stored key is different
+    char magic[aointegralcache_magic_size];
+    uint64_t key_length = 0;
+    input_file.read(magic, aointegralcache_magic_size);
+    input_file.read(reinterpret_cast<char*>(&key_length), sizeof(uint64_t));
+    if (!input_file.good() || (std::memcmp(magic, aointegralcache_magic, aointegralcache_magic_size) != 0) || (key_length != key.size())) {
+        return false;
+    }
+
+    std::string stored_key (key_length, '\0');
+    input_file.read(&stored_key[0], key_length);
+    return input_file.good() && (stored_key == key);
+}
+
+
+/**
+ *  @param key      the key that describes the AO integrals
+ *
+ *  @return the AO integrals with the given key, read by memory-mapping their file
+ */
+AOIntegrals AOIntegralCache::read(const std::string& key) const {
+
+    const auto filename = this->filename(key);
+    int file_descriptor = open(filename.c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        throw std::runtime_error("AOIntegralCache::read(std::string): The AO integral cache has no file " + filename);
+    }
+
+    struct stat status;
+    if ((fstat(file_descriptor, &status) != 0) || (status.st_size == 0)) {
+        close(file_descriptor);
+        throw std::runtime_error("AOIntegralCache::read(std::string): The file " + filename + " is empty.");
+    }
+    const auto file_size = static_cast<size_t>(status.st_size);
+
+    void* address = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);  // the mapping stays valid
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("AOIntegralCache::read(std::string): Could not memory-map the file " + filename);
+    }
+    posix_madvise(address, file_size, POSIX_MADV_SEQUENTIAL);
+
+
+    // Walk through the file, checking that every field fits inside it
+    const char* const begin = static_cast<const char*>(address);
+    size_t position = 0;
+    auto fits = [&position, file_size] (size_t number_of_bytes) { return number_of_bytes <= file_size - position; };
+    auto readSize = [begin, &position] () {
+        uint64_t value;
+        std::memcpy(&value, begin + position, sizeof(uint64_t));
+        position += sizeof(uint64_t);
+        return static_cast<size_t>(value);
+    };
+
+    bool valid = fits(aointegralcache_magic_size + sizeof(uint64_t)) && (std::memcmp(begin, aointegralcache_magic, aointegralcache_magic_size) == 0);
+    size_t K = 0;
+    size_t number_of_packed_integrals = 0;
+    if (valid) {
+        position += aointegralcache_magic_size;
+        const auto key_length = readSize();
+        const auto padded_key_length = (key_length + aointegralcache_alignment - 1) / aointegralcache_alignment * aointegralcache_alignment;
+        valid = fits(padded_key_length + 2 * sizeof(uint64_t)) && (key_length == key.size()) && (std::memcmp(begin + position, key.data(), key_length) == 0);
+        position += padded_key_length;
+    }
+    if (valid) {
+        K = readSize();
+        number_of_packed_integrals = readSize();
+        const auto number_of_pairs = K * (K + 1) / 2;
+        valid = (number_of_packed_integrals == number_of_pairs * (number_of_pairs + 1) / 2) && fits((3 * K * K + number_of_packed_integrals) * sizeof(double));
+    }
+
+    if (!valid) {
+        munmap(address, file_size);
+        throw std::runtime_error("AOIntegralCache::read(std::string): The file " + filename + " does not contain valid AO integrals for the key " + key);
+    }
+
+
+    // Copy the integrals out of the mapping
+    AOIntegrals integrals;
+    for (auto* M : {&integrals.S, &integrals.T, &integrals.V}) {
+        *M = OneElectronOperator<double>(K);
+        std::memcpy(M->data(), begin + position, K * K * sizeof(double));
+        position += K * K * sizeof(double);
+    }
+
+    integrals.g = PackedTwoElectronOperator(K, PackedSymmetry::EIGHTFOLD, reinterpret_cast<const double*>(begin + position));  // the page-aligned mapping and the padded header align the integrals
+
+    munmap(address, file_size);
+    return integrals;
+}
+
+
+/**
+ *  Store AO integrals in this cache. The file is written under a temporary name and then renamed, so that other runs never see a partially written file
+ *
+ *  @param key          the key that describes the AO integrals
+ *  @param integrals    the AO integrals that should be stored
+ */
+void AOIntegralCache::write(const std::string& key, const AOIntegrals& integrals) const {
+
+    const auto K = static_cast<size_t>(integrals.S.cols());
+    if ((integrals.T.cols() != K) || (integrals.V.cols() != K) || (integrals.g.get_K() != K)) {
+        throw std::invalid_argument("AOIntegralCache::write(std::string, AOIntegrals): The dimensions of the given integrals are not compatible.");
+    }
+    if (integrals.g.get_symmetry() != PackedSymmetry::EIGHTFOLD) {
+        throw std::invalid_argument("AOIntegralCache::write(std::string, AOIntegrals): The two-electron integrals should be packed with eight-fold symmetry.");
+    }
+
+
+    const auto filename = this->filename(key);
+    const auto temporary_filename = filename + ".tmp" + std::to_string(getpid());
+    std::ofstream output_file (temporary_filename, std::ios::binary | std::ios::trunc);
+    if (!output_file.good()) {
+        throw std::runtime_error("AOIntegralCache::write(std::string, AOIntegrals): Could not create the file " + temporary_filename);
+    }
+
+    auto writeSize = [&output_file] (size_t value) {
+        const auto value_64 = static_cast<uint64_t>(value);
+        output_file.write(reinterpret_cast<const char*>(&value_64), sizeof(uint64_t));
+    };
+
+    output_file.write(aointegralcache_magic, aointegralcache_magic_size);
+    writeSize(key.size());
+    output_file.write(key.data(), key.size());
+    const auto padding = (aointegralcache_alignment - key.size() % aointegralcache_alignment) % aointegralcache_alignment;
+    const char zeros[aointegralcache_alignment] = {};
+    output_file.write(zeros, padding);
+
+    writeSize(K);
+    writeSize(integrals.g.size());
+    for (const auto* M : {&integrals.S, &integrals.T, &integrals.V}) {
+        output_file.write(reinterpret_cast<const char*>(M->data()), K * K * sizeof(double));
+    }
+    output_file.write(reinterpret_cast<const char*>(integrals.g.get_data().data()), integrals.g.size() * sizeof(double));
+
+    output_file.close();
+    if (!output_file.good() || (std::rename(temporary_filename.c_str(), filename.c_str()) != 0)) {
+        std::remove(temporary_filename.c_str());
+        throw std::runtime_error("AOIntegralCache::write(std::string, AOIntegrals): Could not write the file " + filename);
+    }
+}
+
+
+/**
+ *  @param molecule                 the molecule for which the Hamiltonian parameters should be calculated
+ *  @param basisset_name            the name of the basis set corresponding to the AO basis
+ *  @param screening_threshold      the threshold for the Schwarz screening of the two-electron integrals, or 0 (the default) for exact integrals, as in HamiltonianParameters::Molecular()
+ *
+ *  @return the molecular Hamiltonian parameters in the AO basis (see HamiltonianParameters::Molecular()), whose integrals are read from this cache if possible and are calculated and stored otherwise
+ */
+HamiltonianParameters<double> AOIntegralCache::molecularHamiltonianParameters(const Molecule& molecule, const std::string& basisset_name, double screening_threshold) const {
+
+    auto ao_basis = std::make_shared<AOBasis>(molecule, basisset_name);
+    const auto key = this->key(molecule, basisset_name, screening_threshold);
+
+    AOIntegrals integrals;
+    if (this->contains(key)) {
+        integrals = this->read(key);
+    } else {
+        const auto one_electron_integrals = ao_basis->calculateOneElectronIntegrals();
+        integrals.S = one_electron_integrals[0];
+        integrals.T = one_electron_integrals[1];
+        integrals.V = one_electron_integrals[2];
+        integrals.g = ao_basis->calculatePackedCoulombRepulsionIntegrals(screening_threshold);
+
+        this->write(key, integrals);
+    }
+
+
+    OneElectronOperator<double> H = integrals.T + integrals.V;
+    auto nbf = ao_basis->numberOfBasisFunctions();
+    SquareMatrix<double> T_total = SquareMatrix<double>::Identity(nbf, nbf);
+
+    return HamiltonianParameters<double>(ao_basis, integrals.S, H, integrals.g.toDense(), T_total, molecule.calculateInternuclearRepulsionEnergy());  // the orbital transformations need the dense integrals
+}
+
+
+}  // namespace GQCP
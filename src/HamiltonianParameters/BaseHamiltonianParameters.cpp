@@ -21,6 +21,14 @@
 namespace GQCP {
 
 
+/*
+ *  STATIC MEMBERS
+ */
+
+std::atomic<size_t> BaseHamiltonianParameters::number_of_deep_copies (0);
+
+
+
 /*
  *  CONSTRUCTORS
  */
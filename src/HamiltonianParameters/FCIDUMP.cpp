@@ -0,0 +1,488 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "HamiltonianParameters/FCIDUMP.hpp"
+
+#include "utilities/miscellaneous.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace GQCP {
+
+
+/*
+ *  The layout of a binary FCIDUMP file, in native byte order:
+ *      - the magic string "GQCPFCI1" (8 bytes)
+ *      - the number of orbitals K (uint64) and the scalar (double)
+ *      - the one-electron integrals (K^2 doubles, column-major)
+ *      - the number of packed two-electron integrals (uint64) and the eight-fold packed two-electron integrals
+ */
+constexpr char binary_fcidump_magic[] = "GQCPFCI1";
+constexpr size_t binary_fcidump_magic_size = 8;
+
+constexpr size_t fcidump_minimum_block_size = 1 << 20;  // the minimum number of bytes of an FCIDUMP file that is worth its own thread
+
+
+
+/**
+ *  Parse a floating point number in C or Fortran notation, e.g. -1.5e-03 or 0.25D+01
+ *
+ *  @param position     the position at which parsing starts (leading blanks are skipped), which is moved past the number
+ *  @param end          the end of the text
+ *  @param value        the parsed number
+ *
+ *  @return if a number could be parsed
+ *
+ *  Numbers with a decimal exponent up to 22 in absolute value are converted with one integer-to-double conversion and one multiplication or division by an exact power of ten, so they are accurate to about one unit in the last place. Other numbers are handed to std::strtod
+ */
+bool parseFCIDUMPDouble(const char*& position, const char* end, double& value) {
+
+    static const double powers_of_ten[] = {1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10, 1.0e11,
+                                           1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22};
+
+    const char* p = position;
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) {
+        p++;
+    }
+    const char* start = p;
+
+    bool negative = false;
+    if ((p < end) && ((*p == '-') || (*p == '+'))) {
+        negative = (*p == '-');
+        p++;
+    }
+
+
+    // Collect (at most) 19 significant digits in an integer mantissa, so that value = mantissa * 10^exponent
+    uint64_t mantissa = 0;
+    size_t number_of_significant_digits = 0;
+    int exponent = 0;
+    bool has_digits = false;
+
+    while ((p < end) && std::isdigit(static_cast<unsigned char>(*p))) {
+        has_digits = true;
+        if (number_of_significant_digits < 19) {
+            mantissa = 10 * mantissa + static_cast<uint64_t>(*p - '0');
+            number_of_significant_digits += (mantissa > 0) ? 1 : 0;
+        } else {
+            exponent++;  // a digit of the integer part that doesn't fit in the mantissa
+        }
+        p++;
+    }
+
+    if ((p < end) && (*p == '.')) {
+        p++;
+        while ((p < end) && std::isdigit(static_cast<unsigned char>(*p))) {
+            has_digits = true;
+            if (number_of_significant_digits < 19) {
+                mantissa = 10 * mantissa + static_cast<uint64_t>(*p - '0');
+                number_of_significant_digits += (mantissa > 0) ? 1 : 0;
+                exponent--;
+            }
+            p++;
+        }
+    }
+
+    if (!has_digits) {
+        return false;
+    }
+
+
+    // Fortran writes exponents with a D
+    if ((p < end) && ((*p == 'e') || (*p == 'E') || (*p == 'd') || (*p == 'D'))) {
+        const char* exponent_start = p;
+        p++;
+
+        bool negative_exponent = false;
+        if ((p < end) && ((*p == '-') || (*p == '+'))) {
+            negative_exponent = (*p == '-');
+            p++;
+        }
+
+        if ((p < end) && std::isdigit(static_cast<unsigned char>(*p))) {
+            int explicit_exponent = 0;
+            while ((p < end) && std::isdigit(static_cast<unsigned char>(*p))) {
+                explicit_exponent = std::min(10 * explicit_exponent + (*p - '0'), 100000);  // anything larger over- or underflows anyway
+                p++;
+            }
+            exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+        } else {
+            p = exponent_start;  // the letter doesn't start an exponent
+        }
+    }
+
+
+    if (mantissa == 0) {
+        value = negative ? -0.0 : 0.0;
+    } else if ((exponent >= -22) && (exponent <= 22)) {
+        value = static_cast<double>(mantissa);
+        value = (exponent < 0) ? value / powers_of_ten[-exponent] : value * powers_of_ten[exponent];
+        value = negative ? -value : value;
+    } else {
+        std::string number (start, p);
+        std::replace(number.begin(), number.end(), 'd', 'e');
+        std::replace(number.begin(), number.end(), 'D', 'e');
+        value = std::strtod(number.c_str(), nullptr);
+    }
+
+    position = p;
+    return true;
+}
+
+
+/**
+ *  Parse an unsigned integer
+ *
+ *  @param position     the position at which parsing starts (leading blanks are skipped), which is moved past the number
+ *  @param end          the end of the text
+ *  @param value        the parsed number
+ *
+ *  @return if a number could be parsed
+ */
+bool parseFCIDUMPIndex(const char*& position, const char* end, size_t& value) {
+
+    const char* p = position;
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) {
+        p++;
+    }
+
+    if ((p == end) || !std::isdigit(static_cast<unsigned char>(*p))) {
+        return false;
+    }
+
+    value = 0;
+    while ((p < end) && std::isdigit(static_cast<unsigned char>(*p))) {
+        value = 10 * value + static_cast<size_t>(*p - '0');
+        p++;
+    }
+
+    position = p;
+    return true;
+}
+
+
+/**
+ *  Read a (text) FCIDUMP file by memory-mapping it and parsing blocks of lines on several threads
+ *
+ *  @param fcidump_file             the name of the FCIDUMP file
+ *  @param number_of_threads        the number of threads that parse the file, or 0 to use all available hardware threads
+ *
+ *  @return the integrals in the FCIDUMP file
+ *
+ *  The threads write the two-electron integrals straight into the packed storage, resolving symmetry-equivalent integrals that are listed more than once in the order of the file, so that such files are read as in a serial pass
+ */
+FCIDUMPIntegrals readFCIDUMP(const std::string& fcidump_file, size_t number_of_threads) {
+
+    int file_descriptor = open(fcidump_file.c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        throw std::runtime_error("readFCIDUMP(std::string, size_t): The provided FCIDUMP file is illegible. Maybe you specified a wrong path?");
+    }
+
+    struct stat status;
+    if ((fstat(file_descriptor, &status) != 0) || (status.st_size == 0)) {
+        close(file_descriptor);
+        throw std::invalid_argument("readFCIDUMP(std::string, size_t): The provided FCIDUMP file is empty.");
+    }
+    const auto file_size = static_cast<size_t>(status.st_size);
+
+    void* address = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);  // the mapping stays valid
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("readFCIDUMP(std::string, size_t): Could not memory-map the FCIDUMP file.");
+    }
+    posix_madvise(address, file_size, POSIX_MADV_WILLNEED);
+
+    const char* const begin = static_cast<const char*>(address);
+    const char* const end = begin + file_size;
+    auto nextLine = [end] (const char* line) {
+        const auto* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        return (newline == nullptr) ? end : newline + 1;
+    };
+
+
+    // Read the number of orbitals from the namelist header, which is closed by &END, $END or /
+    size_t K = 0;
+    const char* data_begin = nullptr;
+    for (const char* line = begin; line < end; ) {
+        const char* next_line = nextLine(line);
+
+        std::string uppercase_line (line, next_line);
+        std::transform(uppercase_line.begin(), uppercase_line.end(), uppercase_line.begin(), [] (unsigned char c) { return std::toupper(c); });
+
+        const auto norb_position = uppercase_line.find("NORB");
+        const auto equals_position = uppercase_line.find('=', norb_position);
+        if ((K == 0) && (norb_position != std::string::npos) && (equals_position != std::string::npos)) {
+            K = std::strtoul(uppercase_line.c_str() + equals_position + 1, nullptr, 10);
+        }
+
+        line = next_line;
+        if ((uppercase_line.find("&END") != std::string::npos) || (uppercase_line.find("$END") != std::string::npos) || (uppercase_line.find('/') != std::string::npos)) {
+            data_begin = line;
+            break;
+        }
+    }
+
+    if ((K == 0) || (data_begin == nullptr)) {
+        munmap(address, file_size);
+        throw std::invalid_argument("readFCIDUMP(std::string, size_t): The .FCIDUMP-file is invalid: could not read a number of orbitals.");
+    }
+
+
+    // Parse blocks of lines in parallel: a block parses every line that starts inside it
+    FCIDUMPIntegrals integrals;
+    integrals.h = OneElectronOperator<double>::Zero(K, K);
+    integrals.g = PackedTwoElectronOperator(K, PackedSymmetry::EIGHTFOLD);
+
+    const auto data_size = static_cast<size_t>(end - data_begin);
+    if (number_of_threads == 0) {
+        number_of_threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), 1 + data_size / fcidump_minimum_block_size);  // small files aren't worth many threads
+    }
+    const size_t number_of_blocks = std::max<size_t>(std::min(number_of_threads, data_size), 1);
+
+
+    // The two-electron integrals are written straight into the packed storage. Files may list symmetry-equivalent integrals more than once, so every packed integral records the (latest) block that wrote it: a block only overwrites integrals of earlier blocks, and within a block, later lines overwrite earlier ones, so that the last line in the file wins as in a serial pass
+    //  An owner is 2 * (block + 1), or that plus 1 while the block is writing the integral
+    const double* const packed_begin = integrals.g.get_data().data();
+    std::vector<std::atomic<uint32_t>> owners ((number_of_blocks > 1) ? integrals.g.size() : 0);
+    for (auto& owner : owners) {
+        owner.store(0, std::memory_order_relaxed);
+    }
+
+    auto storeTwoElectronIntegral = [&owners, packed_begin] (double& element, double value, size_t block) {
+        if (owners.empty()) {  // a single block is a serial pass
+            element = value;
+            return;
+        }
+
+        auto& owner = owners[&element - packed_begin];
+        const auto block_owner = static_cast<uint32_t>(2 * (block + 1));
+        uint32_t current_owner = owner.load(std::memory_order_acquire);
+        while (current_owner <= block_owner + 1) {  // stop if a later block has already written the integral
+            if (current_owner % 2 == 1) {  // another block is writing the integral
+                current_owner = owner.load(std::memory_order_acquire);
+            } else if (owner.compare_exchange_weak(current_owner, block_owner + 1, std::memory_order_acquire)) {
+                element = value;
+                owner.store(block_owner, std::memory_order_release);
+                break;
+            }
+        }
+    };
+
+
+    // The (few) one-electron integrals and scalars are collected per block, so that they can be stored in the order of the file
+    struct BlockEntries {
+        std::vector<std::tuple<size_t, size_t, double>> one_electron_integrals;
+        std::vector<double> scalars;
+    };
+    std::vector<BlockEntries> block_entries (number_of_blocks);
+
+    auto parseBlock = [&] (size_t block) {
+        const auto block_start = block * data_size / number_of_blocks;
+        const auto block_end = (block + 1) * data_size / number_of_blocks;
+
+        const char* line = data_begin + block_start;
+        if ((block_start > 0) && (*(line - 1) != '\n')) {
+            line = nextLine(line);  // the line that contains the start of this block belongs to the previous block
+        }
+
+        auto& entries = block_entries[block];
+        for ( ; line < data_begin + block_end; line = nextLine(line)) {
+            const auto* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            line_end = (line_end == nullptr) ? end : line_end;
+
+            const char* position = line;
+            while ((position < line_end) && std::isspace(static_cast<unsigned char>(*position))) {
+                position++;
+            }
+            if (position == line_end) {  // skip blank lines
+                continue;
+            }
+
+            // Based on what the values of the indices are, we can read one-electron integrals, two-electron integrals and the scalar (e.g. the internuclear repulsion energy)
+            //  See also (http://hande.readthedocs.io/en/latest/manual/integrals.html). FCIDUMP files give the two-electron integrals in CHEMIST'S notation
+            double x;
+            size_t i, a, j, b;
+            if (!(parseFCIDUMPDouble(position, line_end, x) && parseFCIDUMPIndex(position, line_end, i) && parseFCIDUMPIndex(position, line_end, a) && parseFCIDUMPIndex(position, line_end, j) && parseFCIDUMPIndex(position, line_end, b))) {
+                throw std::invalid_argument("readFCIDUMP(std::string, size_t): The line '" + std::string(line, line_end) + "' is not a valid FCIDUMP line.");
+            }
+            if ((i > K) || (a > K) || (j > K) || (b > K)) {
+                throw std::invalid_argument("readFCIDUMP(std::string, size_t): The line '" + std::string(line, line_end) + "' contains an orbital index that is larger than the number of orbitals.");
+            }
+
+            if ((i == 0) && (a == 0) && (j == 0) && (b == 0)) {  // the scalar
+                entries.scalars.push_back(x);
+            } else if ((a == 0) && (j == 0) && (b == 0)) {  // single-particle eigenvalues (skipped)
+                continue;
+            } else if ((i > 0) && (a > 0) && (j == 0) && (b == 0)) {  // one-electron integrals (h_core)
+                entries.one_electron_integrals.emplace_back(i - 1, a - 1, x);
+            } else if ((i > 0) && (a > 0) && (j > 0) && (b > 0)) {  // two-electron integrals
+                storeTwoElectronIntegral(integrals.g(i - 1, a - 1, j - 1, b - 1), x, block);  // the packed storage applies the permutational symmetries for real orbitals
+            }
+        }
+    };
+
+    try {
+        parallelFor(number_of_blocks, number_of_threads, [&parseBlock] (size_t start, size_t end) {
+            for (size_t block = start; block < end; block++) {
+                parseBlock(block);
+            }
+        });
+    } catch (...) {
+        munmap(address, file_size);
+        throw;
+    }
+    munmap(address, file_size);
+
+
+    for (const auto& entries : block_entries) {
+        for (const auto& one_electron_integral : entries.one_electron_integrals) {
+            const auto p = std::get<0>(one_electron_integral);
+            const auto q = std::get<1>(one_electron_integral);
+            integrals.h(p,q) = std::get<2>(one_electron_integral);
+            integrals.h(q,p) = std::get<2>(one_electron_integral);  // apply the permutational symmetry for real orbitals
+        }
+
+        for (const auto& scalar : entries.scalars) {
+            integrals.scalar = scalar;
+        }
+    }
+
+    return integrals;
+}
+
+
+/**
+ *  Read a binary FCIDUMP file that was written by writeBinaryFCIDUMP()
+ *
+ *  @param filename         the name of the binary FCIDUMP file
+ *
+ *  @return the integrals in the binary FCIDUMP file
+ */
+FCIDUMPIntegrals readBinaryFCIDUMP(const std::string& filename) {
+
+    int file_descriptor = open(filename.c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        throw std::runtime_error("readBinaryFCIDUMP(std::string): The provided binary FCIDUMP file is illegible. Maybe you specified a wrong path?");
+    }
+
+    struct stat status;
+    if ((fstat(file_descriptor, &status) != 0) || (status.st_size == 0)) {
+        close(file_descriptor);
+        throw std::invalid_argument("readBinaryFCIDUMP(std::string): The provided binary FCIDUMP file is empty.");
+    }
+    const auto file_size = static_cast<size_t>(status.st_size);
+
+    void* address = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);  // the mapping stays valid
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("readBinaryFCIDUMP(std::string): Could not memory-map the binary FCIDUMP file.");
+    }
+    posix_madvise(address, file_size, POSIX_MADV_SEQUENTIAL);
+
+
+    // Check the header before copying the integrals, which are aligned because every field has a size that is a multiple of 8 bytes
+    const char* const begin = static_cast<const char*>(address);
+    const size_t header_size = binary_fcidump_magic_size + sizeof(uint64_t) + sizeof(double);
+    uint64_t K = 0;
+    uint64_t number_of_packed_integrals = 0;
+
+    bool valid = (file_size >= header_size) && (std::memcmp(begin, binary_fcidump_magic, binary_fcidump_magic_size) == 0);
+    if (valid) {
+        std::memcpy(&K, begin + binary_fcidump_magic_size, sizeof(uint64_t));
+        valid = (K > 0) && (file_size >= header_size + (K * K + 1) * sizeof(double));
+    }
+    if (valid) {
+        std::memcpy(&number_of_packed_integrals, begin + header_size + K * K * sizeof(double), sizeof(uint64_t));
+        const auto number_of_pairs = K * (K + 1) / 2;
+        valid = (number_of_packed_integrals == number_of_pairs * (number_of_pairs + 1) / 2) && (file_size == header_size + (K * K + 1 + number_of_packed_integrals) * sizeof(double));
+    }
+
+    if (!valid) {
+        munmap(address, file_size);
+        throw std::invalid_argument("readBinaryFCIDUMP(std::string): The provided file is not a valid binary FCIDUMP file.");
+    }
+
+
+    FCIDUMPIntegrals integrals;
+    std::memcpy(&integrals.scalar, begin + binary_fcidump_magic_size + sizeof(uint64_t), sizeof(double));
+
+    integrals.h = OneElectronOperator<double>(K);
+    std::memcpy(integrals.h.data(), begin + header_size, K * K * sizeof(double));
+
+    const auto* packed_integrals = reinterpret_cast<const double*>(begin + header_size + (K * K + 1) * sizeof(double));
+    integrals.g = PackedTwoElectronOperator(K, PackedSymmetry::EIGHTFOLD, packed_integrals);
+
+    munmap(address, file_size);
+    return integrals;
+}
+
+
+/**
+ *  Write integrals to a binary FCIDUMP file, which stores a small header followed by the one-electron integrals and the packed unique two-electron integrals, without any loss of precision
+ *
+ *  @param filename         the name of the binary FCIDUMP file
+ *  @param integrals        the integrals that should be written
+ */
+void writeBinaryFCIDUMP(const std::string& filename, const FCIDUMPIntegrals& integrals) {
+
+    const auto K = integrals.g.get_K();
+    if ((integrals.h.cols() != K) || (K == 0)) {
+        throw std::invalid_argument("writeBinaryFCIDUMP(std::string, FCIDUMPIntegrals): The dimensions of the one- and two-electron integrals are not compatible.");
+    }
+    if (integrals.g.get_symmetry() != PackedSymmetry::EIGHTFOLD) {
+        throw std::invalid_argument("writeBinaryFCIDUMP(std::string, FCIDUMPIntegrals): The two-electron integrals should be packed with eight-fold symmetry.");
+    }
+
+    std::ofstream output_file (filename, std::ios::binary | std::ios::trunc);
+    if (!output_file.good()) {
+        throw std::runtime_error("writeBinaryFCIDUMP(std::string, FCIDUMPIntegrals): The binary FCIDUMP file could not be opened for writing.");
+    }
+
+    const auto K_64 = static_cast<uint64_t>(K);
+    const auto number_of_packed_integrals = static_cast<uint64_t>(integrals.g.size());
+
+    output_file.write(binary_fcidump_magic, binary_fcidump_magic_size);
+    output_file.write(reinterpret_cast<const char*>(&K_64), sizeof(uint64_t));
+    output_file.write(reinterpret_cast<const char*>(&integrals.scalar), sizeof(double));
+    output_file.write(reinterpret_cast<const char*>(integrals.h.data()), K * K * sizeof(double));
+    output_file.write(reinterpret_cast<const char*>(&number_of_packed_integrals), sizeof(uint64_t));
+    output_file.write(reinterpret_cast<const char*>(integrals.g.get_data().data()), integrals.g.size() * sizeof(double));
+
+    output_file.close();
+    if (!output_file.good()) {
+        throw std::runtime_error("writeBinaryFCIDUMP(std::string, FCIDUMPIntegrals): The binary FCIDUMP file could not be written.");
+    }
+}
+
+
+}  // namespace GQCP
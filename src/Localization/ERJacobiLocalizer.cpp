@@ -52,7 +52,7 @@ ERJacobiLocalizer::ERJacobiLocalizer(size_t N_P, double threshold, size_t maximu
  */
 void ERJacobiLocalizer::calculateJacobiCoefficients(const HamiltonianParameters<double>& ham_par, size_t i, size_t j) {
 
-    auto g = ham_par.get_g();  // two-electron integrals
+    const auto& g = ham_par.get_g();  // two-electron integrals
 
     this->A = 0.25 * (2*g(i,i,j,j) + 4*g(i,j,i,j) - g(i,i,i,i) - g(j,j,j,j));
     this->B = -this->A;
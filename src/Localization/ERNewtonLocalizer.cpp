@@ -40,7 +40,7 @@ namespace GQCP {
  */
 double ERNewtonLocalizer::calculateGradientElement(const HamiltonianParameters<double>& ham_par, size_t i, size_t j) const {
 
-    auto g = ham_par.get_g();
+    const auto& g = ham_par.get_g();
 
     return 4 * (g(j,i,i,i) - g(i,j,j,j));
 }
@@ -76,7 +76,7 @@ SquareMatrix<double> ERNewtonLocalizer::calculateGradient(const HamiltonianParam
  */
 double ERNewtonLocalizer::calculateHessianElement(const HamiltonianParameters<double>& ham_par, size_t i, size_t j, size_t k, size_t l) const {
 
-    auto g = ham_par.get_g();
+    const auto& g = ham_par.get_g();
 
     // KISS-implementation of the Hessian element for the Edmiston-Ruedenberg localization index
     double value = 0.0;
@@ -0,0 +1,139 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "Observer/JSONLinesObserver.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param output       the stream to which the records are written, which should outlive this observer
+ */
+JSONLinesObserver::JSONLinesObserver(std::ostream& output) :
+    output (output)
+{}
+
+
+/**
+ *  @param filename     the name of the file to which the records are appended
+ */
+JSONLinesObserver::JSONLinesObserver(const std::string& filename) :
+    file (filename, std::ios::app),
+    output (this->file)
+{
+    if (!this->file.is_open()) {
+        throw std::runtime_error("JSONLinesObserver::JSONLinesObserver(std::string): Could not open the file " + filename);
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param record       the diagnostics of the iteration that just finished
+ */
+void JSONLinesObserver::update(const IterationRecord& record) {
+    this->output << JSONLinesObserver::toJSON(record) << '\n';
+    this->output.flush();  // a solver that crashes shouldn't take its diagnostics with it
+}
+
+
+
+/*
+ *  PUBLIC STATIC METHODS
+ */
+
+/**
+ *  @param record       an iteration record
+ *
+ *  @return the record as a single-line JSON object
+ */
+std::string JSONLinesObserver::toJSON(const IterationRecord& record) {
+
+    std::ostringstream json;
+    json << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    // JSON has no representation for NaN or infinity
+    auto write_number = [&json](double number) {
+        if (std::isfinite(number)) {
+            json << number;
+        } else {
+            json << "null";
+        }
+    };
+
+    auto write_array = [&json, &write_number](const std::vector<double>& numbers) {
+        json << '[';
+        for (size_t i = 0; i < numbers.size(); i++) {
+            if (i > 0) {
+                json << ',';
+            }
+            write_number(numbers[i]);
+        }
+        json << ']';
+    };
+
+
+    // Solver names are plain identifiers, but escape them anyway
+    json << "{\"solver\":\"";
+    for (const char c : record.solver) {
+        if ((c == '"') || (c == '\\')) {
+            json << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            json << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+        } else {
+            json << c;
+        }
+    }
+    json << "\"";
+
+    json << ",\"iteration\":" << record.iteration;
+    json << ",\"residual_norms\":";
+    write_array(record.residual_norms);
+    json << ",\"eigenvalues\":";
+    write_array(record.eigenvalues);
+    json << ",\"subspace_dimension\":" << record.subspace_dimension;
+    json << ",\"collapsed\":" << (record.collapsed ? "true" : "false");
+    json << ",\"number_of_matvecs\":" << record.number_of_matvecs;
+    json << ",\"matvec_time\":";
+    write_number(record.matvec_time);
+    json << ",\"subspace_time\":";
+    write_number(record.subspace_time);
+    json << ",\"allocated_bytes\":" << record.allocated_bytes;
+    json << ",\"number_of_computed_quartets\":" << record.number_of_computed_quartets;
+    json << ",\"number_of_skipped_quartets\":" << record.number_of_skipped_quartets;
+    json << '}';
+
+    return json.str();
+}
+
+
+}  // namespace GQCP
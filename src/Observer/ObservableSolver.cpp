@@ -0,0 +1,76 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "Observer/ObservableSolver.hpp"
+
+#include <stdexcept>
+
+
+namespace GQCP {
+
+
+/*
+ *  PROTECTED METHODS
+ */
+
+/**
+ *  Notify all attached observers
+ *
+ *  @param record       the diagnostics of the iteration that just finished
+ */
+void ObservableSolver::notify(const IterationRecord& record) const {
+
+    for (const auto& observer : this->observers) {
+        observer->update(record);
+    }
+}
+
+
+/**
+ *  Set the time spent in the subspace algebra, i.e. the wall time since the start of the iteration that wasn't spent in the expensive operator applications, and notify all attached observers
+ *
+ *  @param record       the diagnostics of the iteration that just finished
+ *  @param start        the time at which the iteration started
+ */
+void ObservableSolver::finishIteration(IterationRecord& record, const std::chrono::steady_clock::time_point& start) const {
+
+    auto stop = std::chrono::steady_clock::now();
+    record.subspace_time = std::chrono::duration<double>(stop - start).count() - record.matvec_time;
+
+    this->notify(record);
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param observer     an observer that should be notified after every iteration
+ */
+void ObservableSolver::attach(const std::shared_ptr<BaseIterationObserver>& observer) {
+
+    if (!observer) {
+        throw std::invalid_argument("ObservableSolver::attach(std::shared_ptr<BaseIterationObserver>): Can't attach an empty observer.");
+    }
+
+    this->observers.push_back(observer);
+}
+
+
+}  // namespace GQCP
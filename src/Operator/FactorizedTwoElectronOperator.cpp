@@ -0,0 +1,347 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "Operator/FactorizedTwoElectronOperator.hpp"
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param K        the number of orbitals
+ *  @param B        the (K^2 x N)-matrix whose P-th column holds the factor matrix B_P in column-major order
+ */
+FactorizedTwoElectronOperator::FactorizedTwoElectronOperator(size_t K, const MatrixX<double>& B) :
+    K (K),
+    B (B)
+{
+    if (B.rows() != K * K) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::FactorizedTwoElectronOperator(size_t, MatrixX<double>): The number of rows of the factor matrix should be the square of the number of orbitals.");
+    }
+}
+
+
+
+/*
+ *  NAMED CONSTRUCTORS
+ */
+
+/**
+ *  @param three_center_integrals       the (K^2 x N_aux)-matrix of the three-center integrals (pq|Q), in which the compound index pq is p + K q
+ *  @param two_center_integrals         the (N_aux x N_aux)-matrix of the two-center integrals (P|Q) of the auxiliary basis
+ *  @param eigenvalue_threshold         the threshold on the eigenvalues of the two-center integrals below which the corresponding linear combinations of auxiliary functions are discarded
+ *
+ *  @return the density-fitted two-electron integrals (pq|rs) ~ (pq|P) [(P|Q)^-1] (Q|rs), factorized with the inverse square root of the two-center integrals
+ */
+FactorizedTwoElectronOperator FactorizedTwoElectronOperator::DensityFitted(const MatrixX<double>& three_center_integrals, const SquareMatrix<double>& two_center_integrals, double eigenvalue_threshold) {
+
+    if (three_center_integrals.cols() != two_center_integrals.cols()) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::DensityFitted(MatrixX<double>, SquareMatrix<double>, double): The three-center and two-center integrals belong to different auxiliary bases.");
+    }
+
+    const auto K = static_cast<size_t>(std::lround(std::sqrt(three_center_integrals.rows())));
+    if (K * K != three_center_integrals.rows()) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::DensityFitted(MatrixX<double>, SquareMatrix<double>, double): The number of rows of the three-center integrals should be the square of the number of orbitals.");
+    }
+
+
+    // With (P|Q) = U diag(lambda) U^T, the factor matrices are B = (pq|Q) U diag(lambda)^(-1/2), only keeping the numerically significant eigenvalues
+    // Discarding the (nearly) linearly dependent combinations of auxiliary functions also reduces the number of factor matrices
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (two_center_integrals);
+    const auto& eigenvalues = eigensolver.eigenvalues();  // in ascending order
+    const auto& eigenvectors = eigensolver.eigenvectors();
+
+    size_t first_kept = 0;
+    while ((first_kept < eigenvalues.size()) && (eigenvalues(first_kept) < eigenvalue_threshold)) {
+        first_kept++;
+    }
+    const size_t number_of_kept = eigenvalues.size() - first_kept;
+
+    Eigen::MatrixXd inverse_root = eigenvectors.rightCols(number_of_kept);
+    for (size_t i = 0; i < number_of_kept; i++) {
+        inverse_root.col(i) /= std::sqrt(eigenvalues(first_kept + i));
+    }
+
+    MatrixX<double> B = three_center_integrals * inverse_root;
+    return FactorizedTwoElectronOperator(K, B);
+}
+
+
+/**
+ *  @param diagonal             the K^2 diagonal integrals (pq|pq), in which the compound index pq is p + K q
+ *  @param calculateColumn      a function that calculates the K^2 integrals (rs|pq) for a given compound index pq
+ *  @param tolerance            the tolerance on the largest remaining diagonal element, which bounds the error on every reconstructed integral
+ *  @param maximum_rank         the maximum number of Cholesky vectors, or 0 for no limit
+ *
+ *  @return the pivoted (incomplete) Cholesky decomposition of the two-electron integrals (pq|rs) ~ sum_J L_J(p,q) L_J(r,s), which only needs one column of integrals per Cholesky vector
+ */
+FactorizedTwoElectronOperator FactorizedTwoElectronOperator::PivotedCholesky(const VectorX<double>& diagonal, const std::function<VectorX<double>(size_t)>& calculateColumn, double tolerance, size_t maximum_rank) {
+
+    const auto dim = static_cast<size_t>(diagonal.size());
+    const auto K = static_cast<size_t>(std::lround(std::sqrt(dim)));
+    if (K * K != dim) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::PivotedCholesky(VectorX<double>, std::function<VectorX<double>(size_t)>, double, size_t): The number of diagonal elements should be the square of the number of orbitals.");
+    }
+
+    if ((maximum_rank == 0) || (maximum_rank > dim)) {
+        maximum_rank = dim;
+    }
+
+
+    // The supermatrix G(pq, rs) = (pq|rs) is positive semidefinite, so its residual diagonal d = diag(G - L L^T) bounds the error on every element: |(G - L L^T)(pq, rs)| <= sqrt(d(pq) d(rs))
+    // In every step, the column of the largest residual diagonal element is calculated and turned into a new Cholesky vector
+    VectorX<double> residual_diagonal = diagonal;
+    MatrixX<double> L (dim, std::min<size_t>(maximum_rank, 16));  // the Cholesky vectors, whose capacity is doubled when needed
+    size_t rank = 0;
+
+    size_t pivot;
+    while ((rank < maximum_rank) && (residual_diagonal.maxCoeff(&pivot) > tolerance)) {
+
+        if (rank == L.cols()) {
+            L.conservativeResize(Eigen::NoChange, std::min<size_t>(maximum_rank, 2 * L.cols()));
+        }
+
+        VectorX<double> column = calculateColumn(pivot);
+        if (column.size() != dim) {
+            throw std::invalid_argument("FactorizedTwoElectronOperator::PivotedCholesky(VectorX<double>, std::function<VectorX<double>(size_t)>, double, size_t): The calculated column has an incompatible dimension.");
+        }
+
+        // L_J = (G(:, pivot) - sum_I L_I L_I(pivot)) / sqrt(d(pivot))
+        column.noalias() -= L.leftCols(rank) * L.row(pivot).head(rank).transpose();
+        L.col(rank) = column / std::sqrt(residual_diagonal(pivot));
+
+        residual_diagonal -= L.col(rank).cwiseAbs2();
+        residual_diagonal(pivot) = 0.0;  // avoid round-off from selecting the same pivot again
+        rank++;
+    }
+
+    return FactorizedTwoElectronOperator(K, L.leftCols(rank));
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  In-place transform the factor matrices to another orbital basis, i.e. B_P -> T^T B_P T, which takes O(K^3 N) operations instead of the O(K^5) of a transformation of the dense integrals
+ *
+ *  @param T    the transformation matrix between the old and the new orbital basis, it is used as (current orbitals) T = (new orbitals)
+ */
+void FactorizedTwoElectronOperator::transform(const SquareMatrix<double>& T) {
+
+    if (T.cols() != this->K) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::transform(SquareMatrix<double>): The transformation matrix has an incompatible dimension.");
+    }
+
+    Eigen::MatrixXd intermediate (this->K, this->K);
+    for (size_t P = 0; P < this->get_number_of_vectors(); P++) {
+        Eigen::Map<Eigen::MatrixXd> B_P (this->B.col(P).data(), this->K, this->K);
+
+        intermediate.noalias() = B_P * T;
+        B_P.noalias() = T.transpose() * intermediate;
+    }
+}
+
+
+/**
+ *  In-place rotate the factor matrices using a Jacobi rotation, which only changes two rows and columns of every factor matrix
+ *
+ *  @param jacobi_rotation_parameters       the Jacobi rotation parameters (p, q, angle) that are used to specify a Jacobi rotation: we use the (cos, sin, -sin, cos) definition for the Jacobi rotation matrix
+ */
+void FactorizedTwoElectronOperator::rotate(const JacobiRotationParameters& jacobi_rotation_parameters) {
+
+    const auto p = jacobi_rotation_parameters.get_p();
+    const auto q = jacobi_rotation_parameters.get_q();
+    Eigen::JacobiRotation<double> jacobi_rotation (std::cos(jacobi_rotation_parameters.get_angle()), std::sin(jacobi_rotation_parameters.get_angle()));
+
+    // B_P -> J^T B_P J, with J the Jacobi rotation matrix as constructed by SquareMatrix::FromJacobi
+    for (size_t P = 0; P < this->get_number_of_vectors(); P++) {
+        Eigen::Map<Eigen::MatrixXd> B_P (this->B.col(P).data(), this->K, this->K);
+
+        B_P.applyOnTheRight(p, q, jacobi_rotation);
+        B_P.applyOnTheLeft(p, q, jacobi_rotation.adjoint());
+    }
+}
+
+
+/**
+ *  @return the dense representation of these two-electron integrals
+ */
+TwoElectronOperator<double> FactorizedTwoElectronOperator::toDense() const {
+
+    // The supermatrix G(pq, rs) = (pq|rs) is the product B B^T, whose column-major storage coincides with the storage of the dense tensor
+    Eigen::MatrixXd G = this->B * this->B.transpose();
+
+    TwoElectronOperator<double> g (this->K);
+    std::copy(G.data(), G.data() + G.size(), g.data());
+
+    return g;
+}
+
+
+/**
+ *  @param r        the third orbital index
+ *  @param s        the fourth orbital index
+ *
+ *  @return the Coulomb slice M(p,q) = (pq|rs)
+ */
+SquareMatrix<double> FactorizedTwoElectronOperator::coulombSlice(size_t r, size_t s) const {
+
+    Eigen::VectorXd slice = this->B * this->B.row(r + this->K * s).transpose();
+    return SquareMatrix<double>(Eigen::Map<Eigen::MatrixXd>(slice.data(), this->K, this->K));
+}
+
+
+/**
+ *  @param q        the second orbital index
+ *  @param s        the fourth orbital index
+ *
+ *  @return the exchange slice M(p,r) = (pq|rs)
+ */
+SquareMatrix<double> FactorizedTwoElectronOperator::exchangeSlice(size_t q, size_t s) const {
+
+    // The q-th and s-th columns of all factor matrices are gathered in (K x N)-matrices, so that M = B_q B_s^T
+    Eigen::MatrixXd B_q (this->K, this->get_number_of_vectors());
+    Eigen::MatrixXd B_s (this->K, this->get_number_of_vectors());
+    for (size_t P = 0; P < this->get_number_of_vectors(); P++) {
+        B_q.col(P) = this->factor(P).col(q);
+        B_s.col(P) = this->factor(P).col(s);
+    }
+
+    return SquareMatrix<double>(B_q * B_s.transpose());
+}
+
+
+/**
+ *  @param D        a (density) matrix
+ *
+ *  @return the Coulomb matrix J(p,q) = (pq|rs) D(s,r), calculated in O(K^2 N) operations
+ */
+SquareMatrix<double> FactorizedTwoElectronOperator::calculateCoulomb(const SquareMatrix<double>& D) const {
+
+    if (D.cols() != this->K) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::calculateCoulomb(SquareMatrix<double>): The given matrix has an incompatible dimension.");
+    }
+
+    // gamma_P = B_P(r,s) D(s,r) and J = B_P gamma_P
+    Eigen::MatrixXd D_transpose = D.transpose();
+    Eigen::VectorXd gamma = this->B.transpose() * Eigen::Map<const Eigen::VectorXd>(D_transpose.data(), D_transpose.size());
+    Eigen::VectorXd J = this->B * gamma;
+
+    return SquareMatrix<double>(Eigen::Map<Eigen::MatrixXd>(J.data(), this->K, this->K));
+}
+
+
+/**
+ *  @param D        a (density) matrix
+ *
+ *  @return the exchange matrix K(p,q) = (pr|sq) D(r,s), calculated in O(K^3 N) operations
+ */
+SquareMatrix<double> FactorizedTwoElectronOperator::calculateExchange(const SquareMatrix<double>& D) const {
+
+    if (D.cols() != this->K) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::calculateExchange(SquareMatrix<double>): The given matrix has an incompatible dimension.");
+    }
+
+    // K = sum_P B_P D B_P
+    SquareMatrix<double> K_ = SquareMatrix<double>::Zero(this->K, this->K);
+    Eigen::MatrixXd intermediate (this->K, this->K);
+    for (size_t P = 0; P < this->get_number_of_vectors(); P++) {
+        const auto B_P = this->factor(P);
+
+        intermediate.noalias() = D * B_P;
+        K_.noalias() += B_P * intermediate;
+    }
+
+    return K_;
+}
+
+
+/**
+ *  Write these two-electron integrals together with the given one-electron integrals to an FCIDUMP file, reconstructing every unique integral (pq|rs) on the fly
+ *
+ *  @param fcidump_file     the name of the FCIDUMP file
+ *  @param h                the one-electron integrals
+ *  @param scalar           the scalar interaction term
+ *  @param N                the number of electrons
+ *  @param threshold        the threshold below which integrals aren't written
+ */
+void FactorizedTwoElectronOperator::writeFCIDUMP(const std::string& fcidump_file, const OneElectronOperator<double>& h, double scalar, size_t N, double threshold) const {
+
+    if (h.get_dim() != this->K) {
+        throw std::invalid_argument("FactorizedTwoElectronOperator::writeFCIDUMP(std::string, OneElectronOperator<double>, double, size_t, double): The one-electron integrals have an incompatible dimension.");
+    }
+
+    std::ofstream output_file_stream (fcidump_file);
+    if (!output_file_stream.good()) {
+        throw std::runtime_error("FactorizedTwoElectronOperator::writeFCIDUMP(std::string, OneElectronOperator<double>, double, size_t, double): The FCIDUMP file could not be opened for writing.");
+    }
+
+
+    // The header, without orbital symmetry information
+    output_file_stream << " &FCI NORB=" << this->K << ",NELEC=" << N << ",MS2=0," << std::endl;
+    output_file_stream << "  ORBSYM=";
+    for (size_t p = 0; p < this->K; p++) {
+        output_file_stream << "1,";
+    }
+    output_file_stream << std::endl << "  ISYM=1," << std::endl << " &END" << std::endl;
+
+    output_file_stream << std::scientific << std::setprecision(16);
+
+
+    // The unique two-electron integrals (p >= q, r >= s, pq >= rs) in chemist's notation
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            for (size_t r = 0; r <= p; r++) {
+                const auto s_max = (r == p) ? q : r;
+                for (size_t s = 0; s <= s_max; s++) {
+                    const double value = (*this)(p, q, r, s);
+                    if (std::abs(value) > threshold) {
+                        output_file_stream << value << ' ' << p+1 << ' ' << q+1 << ' ' << r+1 << ' ' << s+1 << '\n';
+                    }
+                }
+            }
+        }
+    }
+
+    // The one-electron integrals and the scalar term
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            if (std::abs(h(p, q)) > threshold) {
+                output_file_stream << h(p, q) << ' ' << p+1 << ' ' << q+1 << " 0 0\n";
+            }
+        }
+    }
+    output_file_stream << scalar << " 0 0 0 0" << std::endl;
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,366 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "Operator/PackedTwoElectronOperator.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "utilities/miscellaneous.hpp"
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  Initialize all integrals to zero
+ *
+ *  @param K            the number of orbitals
+ *  @param symmetry     the permutational symmetry that should be exploited
+ */
+PackedTwoElectronOperator::PackedTwoElectronOperator(size_t K, PackedSymmetry symmetry) :
+    K (K),
+    number_of_pairs (K * (K + 1) / 2),
+    symmetry (symmetry)
+{
+    const auto number_of_integrals = (symmetry == PackedSymmetry::EIGHTFOLD) ? this->number_of_pairs * (this->number_of_pairs + 1) / 2 : this->number_of_pairs * this->number_of_pairs;
+    this->data = std::vector<double>(number_of_integrals, 0.0);
+}
+
+
+/**
+ *  @param K                    the number of orbitals
+ *  @param symmetry             the permutational symmetry that should be exploited
+ *  @param unique_integrals     the unique integrals in their packed order (i.e. as returned by get_data()), which are copied
+ */
+PackedTwoElectronOperator::PackedTwoElectronOperator(size_t K, PackedSymmetry symmetry, const double* unique_integrals) :
+    PackedTwoElectronOperator(K, symmetry)
+{
+    std::copy(unique_integrals, unique_integrals + this->data.size(), this->data.begin());
+}
+
+
+
+/*
+ *  NAMED CONSTRUCTORS
+ */
+
+/**
+ *  @param g            the dense two-electron integrals, which should have the given permutational symmetry
+ *  @param symmetry     the permutational symmetry that should be exploited
+ *
+ *  @return the packed two-electron integrals, in which the symmetry-related elements of g are represented by the one with the canonical (largest) indices
+ */
+PackedTwoElectronOperator PackedTwoElectronOperator::FromDense(const TwoElectronOperator<double>& g, PackedSymmetry symmetry) {
+
+    const auto K = static_cast<size_t>(g.dimension(0));
+    PackedTwoElectronOperator packed_g (K, symmetry);
+
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s <= r; s++) {
+                    packed_g(p, q, r, s) = g(p, q, r, s);
+                }
+            }
+        }
+    }
+
+    return packed_g;
+}
+
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  @return the orbital indices (p, q) with p >= q of every compound pair index
+ */
+std::vector<std::pair<size_t, size_t>> PackedTwoElectronOperator::orbitalPairs() const {
+
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(this->number_of_pairs);
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            pairs.emplace_back(p, q);
+        }
+    }
+
+    return pairs;
+}
+
+
+/**
+ *  @param i        an index in the range [0, number_of_pairs)
+ *
+ *  @return the compound pair index that is handled at position i, in an order in which short and long rows of the eight-fold packed storage alternate
+ */
+size_t PackedTwoElectronOperator::balancedPairIndex(size_t i) const {
+
+    if (this->symmetry == PackedSymmetry::FOURFOLD) {  // all rows are equally long
+        return i;
+    }
+    return (i % 2 == 0) ? i / 2 : this->number_of_pairs - 1 - i / 2;
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @return the dense representation of these two-electron integrals
+ */
+TwoElectronOperator<double> PackedTwoElectronOperator::toDense() const {
+
+    TwoElectronOperator<double> g (this->K);
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q < this->K; q++) {
+            for (size_t r = 0; r < this->K; r++) {
+                for (size_t s = 0; s < this->K; s++) {
+                    g(p, q, r, s) = (*this)(p, q, r, s);
+                }
+            }
+        }
+    }
+
+    return g;
+}
+
+
+/**
+ *  @param r        the third orbital index
+ *  @param s        the fourth orbital index
+ *
+ *  @return the Coulomb slice M(p,q) = (pq|rs)
+ */
+SquareMatrix<double> PackedTwoElectronOperator::coulombSlice(size_t r, size_t s) const {
+
+    SquareMatrix<double> M (this->K);
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            M(p, q) = (*this)(p, q, r, s);
+            M(q, p) = M(p, q);
+        }
+    }
+
+    return M;
+}
+
+
+/**
+ *  @param q        the second orbital index
+ *  @param s        the fourth orbital index
+ *
+ *  @return the exchange slice M(p,r) = (pq|rs)
+ */
+SquareMatrix<double> PackedTwoElectronOperator::exchangeSlice(size_t q, size_t s) const {
+
+    SquareMatrix<double> M (this->K);
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t r = 0; r < this->K; r++) {
+            M(p, r) = (*this)(p, q, r, s);
+        }
+    }
+
+    return M;
+}
+
+
+/**
+ *  @return the Coulomb pair diagonal J(p,q) = (pp|qq)
+ */
+SquareMatrix<double> PackedTwoElectronOperator::coulombDiagonal() const {
+
+    SquareMatrix<double> J (this->K);
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q < this->K; q++) {
+            J(p, q) = (*this)(p, p, q, q);
+        }
+    }
+
+    return J;
+}
+
+
+/**
+ *  @return the exchange pair diagonal K(p,q) = (pq|qp)
+ */
+SquareMatrix<double> PackedTwoElectronOperator::exchangeDiagonal() const {
+
+    SquareMatrix<double> K_ (this->K);
+    for (size_t p = 0; p < this->K; p++) {
+        for (size_t q = 0; q < this->K; q++) {
+            K_(p, q) = (*this)(p, q, q, p);
+        }
+    }
+
+    return K_;
+}
+
+
+/**
+ *  @param D                    a (density) matrix
+ *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+ *
+ *  @return the Coulomb matrix J(p,q) = (pq|rs) D(s,r), calculated in one pass over the unique integrals
+ *
+ *  The compound pair indices pq are distributed over the threads, which accumulate their contributions in their own matrices that are summed in a fixed order afterwards
+ */
+SquareMatrix<double> PackedTwoElectronOperator::calculateCoulomb(const SquareMatrix<double>& D, size_t number_of_threads) const {
+
+    if (D.cols() != this->K) {
+        throw std::invalid_argument("PackedTwoElectronOperator::calculateCoulomb(SquareMatrix<double>, size_t): The given matrix has an incompatible dimension.");
+    }
+
+    const auto pairs = this->orbitalPairs();
+    std::map<size_t, SquareMatrix<double>> block_contributions;  // the contributions of every block of pair indices, keyed by the start of the block
+    std::mutex mutex;
+
+    parallelFor(this->number_of_pairs, number_of_threads, [this, &D, &pairs, &block_contributions, &mutex] (size_t start, size_t end) {
+        SquareMatrix<double> J = SquareMatrix<double>::Zero(this->K, this->K);
+
+        for (size_t i = start; i < end; i++) {
+            const auto pq = this->balancedPairIndex(i);
+            const auto p = pairs[pq].first;
+            const auto q = pairs[pq].second;
+            const double D_pq = (p == q) ? D(p, p) : D(p, q) + D(q, p);  // (pq|rs) = (qp|rs), so both D(p,q) and D(q,p) are contracted with it, unless p == q
+
+            const bool eightfold = (this->symmetry == PackedSymmetry::EIGHTFOLD);
+            const auto offset = eightfold ? pq * (pq + 1) / 2 : pq * this->number_of_pairs;
+            const auto number_of_rs = eightfold ? pq + 1 : this->number_of_pairs;
+
+            double J_pq = 0.0;
+            for (size_t rs = 0; rs < number_of_rs; rs++) {
+                const auto r = pairs[rs].first;
+                const auto s = pairs[rs].second;
+                const double value = this->data[offset + rs];
+
+                J_pq += value * ((r == s) ? D(r, r) : D(r, s) + D(s, r));
+
+                if (eightfold && (rs != pq)) {  // (rs|pq) is a different dense element
+                    J(r, s) += value * D_pq;
+                    if (r != s) {
+                        J(s, r) += value * D_pq;
+                    }
+                }
+            }
+
+            J(p, q) += J_pq;
+            if (p != q) {
+                J(q, p) += J_pq;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock (mutex);
+        block_contributions.emplace(start, std::move(J));
+    });
+
+    SquareMatrix<double> J = SquareMatrix<double>::Zero(this->K, this->K);
+    for (const auto& block_contribution : block_contributions) {
+        J += block_contribution.second;
+    }
+
+    return J;
+}
+
+
+/**
+ *  @param D                    a (density) matrix
+ *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+ *
+ *  @return the exchange matrix K(p,q) = (pr|sq) D(r,s), calculated in one pass over the unique integrals
+ *
+ *  The compound pair indices pq are distributed over the threads, which accumulate their contributions in their own matrices that are summed in a fixed order afterwards
+ */
+SquareMatrix<double> PackedTwoElectronOperator::calculateExchange(const SquareMatrix<double>& D, size_t number_of_threads) const {
+
+    if (D.cols() != this->K) {
+        throw std::invalid_argument("PackedTwoElectronOperator::calculateExchange(SquareMatrix<double>, size_t): The given matrix has an incompatible dimension.");
+    }
+
+    const auto pairs = this->orbitalPairs();
+    std::map<size_t, SquareMatrix<double>> block_contributions;  // the contributions of every block of pair indices, keyed by the start of the block
+    std::mutex mutex;
+
+    parallelFor(this->number_of_pairs, number_of_threads, [this, &D, &pairs, &block_contributions, &mutex] (size_t start, size_t end) {
+        SquareMatrix<double> K_ = SquareMatrix<double>::Zero(this->K, this->K);
+
+        for (size_t i = start; i < end; i++) {
+            const auto pq = this->balancedPairIndex(i);
+            const auto p = pairs[pq].first;
+            const auto q = pairs[pq].second;
+
+            const bool eightfold = (this->symmetry == PackedSymmetry::EIGHTFOLD);
+            const auto offset = eightfold ? pq * (pq + 1) / 2 : pq * this->number_of_pairs;
+            const auto number_of_rs = eightfold ? pq + 1 : this->number_of_pairs;
+
+            for (size_t rs = 0; rs < number_of_rs; rs++) {
+                const auto r = pairs[rs].first;
+                const auto s = pairs[rs].second;
+                const double value = this->data[offset + rs];
+
+                // Every distinct dense element (t0 t1|t2 t3) contributes to K(t0, t3) with D(t1, t2): swapping p and q or r and s only gives a different element if the indices differ
+                K_(p, s) += value * D(q, r);
+                if (p != q) {
+                    K_(q, s) += value * D(p, r);
+                }
+                if (r != s) {
+                    K_(p, r) += value * D(q, s);
+                }
+                if ((p != q) && (r != s)) {
+                    K_(q, r) += value * D(p, s);
+                }
+
+                if (eightfold && (rs != pq)) {  // the elements (rs|pq), (sr|pq), (rs|qp) and (sr|qp)
+                    K_(r, q) += value * D(s, p);
+                    if (r != s) {
+                        K_(s, q) += value * D(r, p);
+                    }
+                    if (p != q) {
+                        K_(r, p) += value * D(s, q);
+                    }
+                    if ((p != q) && (r != s)) {
+                        K_(s, p) += value * D(r, q);
+                    }
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock (mutex);
+        block_contributions.emplace(start, std::move(K_));
+    });
+
+    SquareMatrix<double> K_ = SquareMatrix<double>::Zero(this->K, this->K);
+    for (const auto& block_contribution : block_contributions) {
+        K_ += block_contribution.second;
+    }
+
+    return K_;
+}
+
+
+}  // namespace GQCP
@@ -34,10 +34,10 @@ namespace GQCP {
  */
 OneElectronOperator<double> DIISRHFSCFSolver::calculateNewFockMatrix(const OneRDM<double>& D_AO) {
 
-    auto S = this->ham_par.get_S();
+    const auto& S = this->S;
 
     // Calculate the Fock matrix based off the density matrix
-    auto f_AO = calculateRHFAOFockMatrix(D_AO, this->ham_par);
+    auto f_AO = this->calculateFockMatrix(D_AO);
 
 
     // Update deques for the DIIS procedure
@@ -110,4 +110,24 @@ DIISRHFSCFSolver::DIISRHFSCFSolver(HamiltonianParameters<double> ham_par, Molecu
 {}
 
 
+/**
+ *  Set up an integral-direct DIIS SCF calculation, which only needs O(K^2) memory
+ *
+ *  @param ao_basis                         the AO basis in which the SCF calculation is done
+ *  @param molecule                         the molecule used for the SCF calculation
+ *  @param minimum_subspace_dimension       the minimum number of Fock matrices that have to be in the subspace before enabling DIIS
+ *  @param maximum_subspace_dimension       the maximum DIIS subspace dimension before the oldest Fock matrices get discarded (one at a time)
+ *  @param threshold                        the convergence treshold on the Frobenius norm on the AO density matrix
+ *  @param maximum_number_of_iterations     the maximum number of iterations for the SCF procedure
+ *  @param screening_threshold              the threshold on the product of the Schwarz bounds of two shell pairs and the largest density matrix element they are contracted with, below which their shell quartet isn't computed
+ *  @param number_of_threads                the number of threads that calculate the shell quartets, or 0 to use all available hardware threads
+ *  @param maximum_incremental_builds       the maximum number of consecutive incremental (difference-density) Fock matrix builds before the Fock matrix is rebuilt from the full density matrix, or 0 to always do full builds
+ */
+DIISRHFSCFSolver::DIISRHFSCFSolver(std::shared_ptr<AOBasis> ao_basis, const Molecule& molecule, size_t minimum_subspace_dimension, size_t maximum_subspace_dimension, double threshold, size_t maximum_number_of_iterations, double screening_threshold, size_t number_of_threads, size_t maximum_incremental_builds) :
+    RHFSCFSolver(std::move(ao_basis), molecule, threshold, maximum_number_of_iterations, screening_threshold, number_of_threads, maximum_incremental_builds),
+    minimum_subspace_dimension (minimum_subspace_dimension),
+    maximum_subspace_dimension (maximum_subspace_dimension)
+{}
+
+
 }  // namespace GQCP
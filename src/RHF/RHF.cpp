@@ -96,34 +96,36 @@ OneRDM<double> calculateRHFAO1RDM(const SquareMatrix<double>& C, size_t N) {
 /**
  *  Calculate the RHF Fock matrix F = H_core + G, in which G is a contraction of the density matrix and the two-electron integrals
  *
- *  @param D_AO     the RHF density matrix in AO basis
- *  @param ham_par  The Hamiltonian parameters in AO basis
+ *  @param D_AO                 the RHF density matrix in AO basis
+ *  @param ham_par              The Hamiltonian parameters in AO basis
+ *  @param number_of_threads    the number of threads for the contractions, or 0 to use all available hardware threads
  *
  *  @return the RHF Fock matrix expressed in the AO basis
  */
-OneElectronOperator<double> calculateRHFAOFockMatrix(const OneRDM<double>& D_AO, const HamiltonianParameters<double>& ham_par) {
+OneElectronOperator<double> calculateRHFAOFockMatrix(const OneRDM<double>& D_AO, const HamiltonianParameters<double>& ham_par, size_t number_of_threads) {
 
-    // To perform the contraction, we will first have to convert the MatrixX<double> D_AO to an Eigen::Tensor<const double, 2> D_AO_tensor, as contractions are only implemented for Eigen::Tensors
-    Eigen::TensorMap<Eigen::Tensor<const double, 2>> D_AO_tensor (D_AO.data(), D_AO.rows(), D_AO.cols());
-
-    // Specify the contraction pairs
-    // To calculate G, we must perform two double contractions
-    //      1. (mu nu|rho lambda) P(lambda rho)
-    Eigen::array<Eigen::IndexPair<int>, 2> direct_contraction_pair = {Eigen::IndexPair<int>(3, 0), Eigen::IndexPair<int>(2, 1)};
-    //      2. -0.5 (mu lambda|rho nu) P(lambda rho)
-    Eigen::array<Eigen::IndexPair<int>, 2> exchange_contraction_pair = {Eigen::IndexPair<int>(1, 0), Eigen::IndexPair<int>(2, 1)};
+    // G(mu nu) = (mu nu|rho lambda) P(lambda rho) - 0.5 (mu lambda|rho nu) P(lambda rho), in which the stored two-electron integrals are contracted through matrix products without being copied
+    const auto& g = ham_par.get_g();
+    auto J = g.calculateCoulomb(D_AO, number_of_threads);
+    auto K = g.calculateExchange(D_AO, number_of_threads);
 
-    // Calculate both contractions (and incorporate prefactors)
-    auto g = ham_par.get_g();
-    Tensor<double, 2> direct_contraction = g.contract(D_AO_tensor, direct_contraction_pair);
-    Tensor<double, 2> exchange_contraction = -0.5 * g.contract(D_AO_tensor, exchange_contraction_pair);
+    return ham_par.get_h() + J - 0.5 * K;
+}
 
-    // The previous contractions are Eigen::Tensor<double 2> instances. In order to calculate the total G matrix, we will convert them back into MatrixX<double>
-    Eigen::Map<Eigen::MatrixXd> G1 (direct_contraction.data(), direct_contraction.dimension(0), direct_contraction.dimension(1));
-    Eigen::Map<Eigen::MatrixXd> G2 (exchange_contraction.data(), exchange_contraction.dimension(0), exchange_contraction.dimension(1));
 
+/**
+ *  Calculate the RHF Fock matrix F = H_core + G from factorized (density-fitted or Cholesky-decomposed) two-electron integrals
+ *
+ *  @param D_AO         the RHF density matrix in AO basis
+ *  @param H_core_AO    the core Hamiltonian parameters in AO basis
+ *  @param g_AO         the factorized two-electron integrals in AO basis
+ *
+ *  @return the RHF Fock matrix expressed in the AO basis
+ */
+OneElectronOperator<double> calculateRHFAOFockMatrix(const OneRDM<double>& D_AO, const OneElectronOperator<double>& H_core_AO, const FactorizedTwoElectronOperator& g_AO) {
 
-    return ham_par.get_h() + G1 + G2;
+    // G = (mu nu|rho lambda) P(lambda rho) - 0.5 (mu lambda|rho nu) P(lambda rho), without forming the dense two-electron integrals
+    return H_core_AO + g_AO.calculateCoulomb(D_AO) - 0.5 * g_AO.calculateExchange(D_AO);
 }
 
 
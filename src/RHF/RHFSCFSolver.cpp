@@ -17,6 +17,8 @@
 // 
 #include "RHF/RHFSCFSolver.hpp"
 
+#include <chrono>
+
 
 namespace GQCP {
 
@@ -31,7 +33,36 @@ namespace GQCP {
  *  @param maximum_number_of_iterations     the maximum number of iterations for the SCF procedure
  */
 RHFSCFSolver::RHFSCFSolver(const HamiltonianParameters<double>& ham_par, const Molecule& molecule, double threshold, size_t maximum_number_of_iterations) :
-    ham_par (ham_par),
+    S (ham_par.get_S()),
+    H_core (ham_par.get_h()),
+    ham_par (std::make_shared<const HamiltonianParameters<double>>(ham_par)),
+    molecule (molecule),
+    maximum_number_of_iterations (maximum_number_of_iterations),
+    threshold (threshold)
+{
+    // Check if the given molecule has an even number of electrons
+    if ((molecule.get_N() % 2) != 0) {
+        throw std::invalid_argument("RHFSCFSolver::RHFSCFSolver(): The given molecule has an odd number of electrons.");
+    }
+}
+
+
+/**
+ *  Set up an integral-direct SCF calculation, which only needs O(K^2) memory
+ *
+ *  @param ao_basis                         the AO basis in which the SCF calculation is done
+ *  @param molecule                         the molecule used for the SCF calculation
+ *  @param threshold                        the convergence treshold on the Frobenius norm on the AO density matrix
+ *  @param maximum_number_of_iterations     the maximum number of iterations for the SCF procedure
+ *  @param screening_threshold              the threshold on the product of the Schwarz bounds of two shell pairs and the largest density matrix element they are contracted with, below which their shell quartet isn't computed
+ *  @param number_of_threads                the number of threads that calculate the shell quartets, or 0 to use all available hardware threads
+ *  @param maximum_incremental_builds       the maximum number of consecutive incremental (difference-density) Fock matrix builds before the Fock matrix is rebuilt from the full density matrix, or 0 to always do full builds
+ */
+RHFSCFSolver::RHFSCFSolver(std::shared_ptr<AOBasis> ao_basis, const Molecule& molecule, double threshold, size_t maximum_number_of_iterations, double screening_threshold, size_t number_of_threads, size_t maximum_incremental_builds) :
+    ao_basis (std::move(ao_basis)),
+    screening_threshold (screening_threshold),
+    number_of_threads (number_of_threads),
+    maximum_incremental_builds (maximum_incremental_builds),
     molecule (molecule),
     maximum_number_of_iterations (maximum_number_of_iterations),
     threshold (threshold)
@@ -40,6 +71,54 @@ RHFSCFSolver::RHFSCFSolver(const HamiltonianParameters<double>& ham_par, const M
     if ((molecule.get_N() % 2) != 0) {
         throw std::invalid_argument("RHFSCFSolver::RHFSCFSolver(): The given molecule has an odd number of electrons.");
     }
+
+    // Calculate the overlap, kinetic and nuclear attraction integrals in one sweep over the shell pairs
+    const auto one_electron_integrals = this->ao_basis->calculateOneElectronIntegrals(number_of_threads);
+    this->S = one_electron_integrals[0];
+    this->H_core = one_electron_integrals[1] + one_electron_integrals[2];
+}
+
+
+
+/*
+ *  PROTECTED METHODS
+ */
+
+/**
+ *  @param D_AO     the RHF density matrix in AO basis
+ *
+ *  @return the RHF Fock matrix F = H_core + G (expressed in AO basis), in which G is calculated (incrementally) integral-direct if no in-core Hamiltonian parameters were given
+ */
+OneElectronOperator<double> RHFSCFSolver::calculateFockMatrix(const OneRDM<double>& D_AO) {
+
+    if (this->ham_par) {
+        return calculateRHFAOFockMatrix(D_AO, *this->ham_par);
+    }
+
+
+    // Since G is linear in the density matrix, the previous Fock matrix can be updated with the two-electron matrix of the (small) density difference
+    OneElectronOperator<double> F_AO;
+    bool incremental = (this->number_of_incremental_builds < this->maximum_incremental_builds) && (this->D_AO_last_build.cols() == D_AO.cols());
+    if (incremental) {
+        SquareMatrix<double> delta_D_AO = D_AO - this->D_AO_last_build;
+        F_AO = this->F_AO_last_build + this->ao_basis->calculateDirectRHFTwoElectronMatrix(delta_D_AO, this->screening_threshold, this->number_of_threads);
+        this->number_of_incremental_builds++;
+    } else {
+        F_AO = this->H_core + this->ao_basis->calculateDirectRHFTwoElectronMatrix(D_AO, this->screening_threshold, this->number_of_threads);
+        this->number_of_incremental_builds = 0;
+    }
+
+    this->D_AO_last_build = D_AO;
+    this->F_AO_last_build = F_AO;
+
+
+    // Keep track of the number of (canonical) shell quartets that were calculated
+    auto number_of_shells = this->ao_basis->get_shell_set().numberOfShells();
+    auto number_of_shell_pairs = number_of_shells * (number_of_shells + 1) / 2;
+    this->number_of_skipped_quartets = this->ao_basis->get_number_of_skipped_quartets();
+    this->number_of_computed_quartets = number_of_shell_pairs * (number_of_shell_pairs + 1) / 2 - this->number_of_skipped_quartets;
+
+    return F_AO;
 }
 
 
@@ -49,11 +128,17 @@ RHFSCFSolver::RHFSCFSolver(const HamiltonianParameters<double>& ham_par, const M
  */
 /**
  *  Solve the RHF SCF equations
+ *
+ *  After every iteration, the attached observers are notified with the change in the density matrix, the electronic energy and the time spent in the Fock matrix build
  */
 void RHFSCFSolver::solve() {
 
-    auto H_core = this->ham_par.get_h();
-    auto S = this->ham_par.get_S();
+    const auto& H_core = this->H_core;
+    const auto& S = this->S;
+
+    // Every SCF procedure starts with a full Fock matrix build
+    this->D_AO_last_build = OneRDM<double>();
+    this->number_of_incremental_builds = 0;
 
 
     // Obtain an initial guess for the AO density matrix by solving the generalized eigenvalue problem for H_core
@@ -64,7 +149,9 @@ void RHFSCFSolver::solve() {
 
     size_t iteration_counter = 0;
     while (!(this->is_converged)) {
+        auto start = std::chrono::steady_clock::now();
         auto F_AO = this->calculateNewFockMatrix(D_AO);
+        auto fock_stop = std::chrono::steady_clock::now();  // the Fock matrix build plays the role of the expensive operator application
 
         // Solve the generalized eigenvalue problem for the Fock matrix to get an improved density matrix
         Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> generalized_eigensolver (F_AO, S);
@@ -74,8 +161,24 @@ void RHFSCFSolver::solve() {
         D_AO = calculateRHFAO1RDM(C, this->molecule.get_N());
 
 
+        // Report the diagnostics of this iteration to the attached observers
+        double density_change = (D_AO - D_AO_previous).norm();
+
+        IterationRecord record;
+        record.solver = "RHFSCFSolver";
+        record.iteration = iteration_counter;
+        record.residual_norms = {density_change};
+        record.eigenvalues = {calculateRHFElectronicEnergy(D_AO_previous, H_core, F_AO)};  // the energy of the density that was used to build the Fock matrix
+        record.number_of_matvecs = 1;  // one Fock matrix build
+        record.matvec_time = std::chrono::duration<double>(fock_stop - start).count();
+        record.allocated_bytes = 4 * F_AO.size() * sizeof(double);  // F, C and both density matrices
+        record.number_of_computed_quartets = this->number_of_computed_quartets;
+        record.number_of_skipped_quartets = this->number_of_skipped_quartets;
+        this->finishIteration(record, start);
+
+
         // Check for convergence on the AO density matrix
-        if ((D_AO - D_AO_previous).norm() <= this->threshold) {
+        if (density_change <= this->threshold) {
             this->is_converged = true;
 
             // After the SCF procedure, we end up with canonical spatial orbitals, i.e. the Fock matrix should be diagonal in this basis
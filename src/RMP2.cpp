@@ -37,7 +37,7 @@ double calculateRMP2EnergyCorrection(const HamiltonianParameters<double>& ham_pa
     size_t LUMO_index = RHFLUMOIndex(K, N);
 
 
-    auto g = ham_par.get_g();
+    const auto& g = ham_par.get_g();
 
     double E = 0.0;
     //  loop over all occupied orbitals (0 <= HOMO )
@@ -64,4 +64,53 @@ double calculateRMP2EnergyCorrection(const HamiltonianParameters<double>& ham_pa
 }
 
 
+/**
+ *  @param g            the two-electron integrals in the (AO) basis in which the RHF SCF equations were solved
+ *  @param molecule     the molecule for which the energy correction should be calculated
+ *  @param rhf          the converged solution to the RHF SCF equations
+ *
+ *  @return the RMP2 energy correction, for which only the integrals (ia|jb) are transformed to the RHF MO basis
+ */
+double calculateRMP2EnergyCorrection(const TwoElectronOperator<double>& g, const Molecule& molecule, const RHF& rhf) {
+
+    size_t N = molecule.get_N();
+    size_t K = g.dimension(0);
+
+    size_t number_of_occupied_orbitals = RHFHOMOIndex(N) + 1;
+    size_t LUMO_index = RHFLUMOIndex(K, N);
+    size_t number_of_virtual_orbitals = K - LUMO_index;
+
+
+    // Only transform the integrals (ia|jb) to the RHF MO basis
+    const auto& C = rhf.get_C();
+    MatrixX<double> C_occupied = C.leftCols(number_of_occupied_orbitals);
+    MatrixX<double> C_virtual = C.rightCols(number_of_virtual_orbitals);
+    const auto g_ovov = g.calculateTransformedBlock(C_occupied, C_virtual, C_occupied, C_virtual);  // g_ovov(i,a,j,b) = (ia|jb)
+
+    double E = 0.0;
+    //  loop over all occupied orbitals (0 <= HOMO )
+    for (size_t i = 0; i < number_of_occupied_orbitals; i++) {
+        for (size_t j = 0; j < number_of_occupied_orbitals; j++) {
+
+            //  loop over all virtual orbitals (LUMO < K)
+            for (size_t a = 0; a < number_of_virtual_orbitals; a++) {
+                for (size_t b = 0; b < number_of_virtual_orbitals; b++) {
+
+                    double epsilon_a = rhf.get_orbital_energies(LUMO_index + a);
+                    double epsilon_b = rhf.get_orbital_energies(LUMO_index + b);
+                    double epsilon_i = rhf.get_orbital_energies(i);
+                    double epsilon_j = rhf.get_orbital_energies(j);
+
+                    // For real orbitals, (ai|bj) = (ia|jb)
+                    E -= g_ovov(i,a,j,b) * (2 * g_ovov(i,a,j,b) - g_ovov(i,b,j,a)) / (epsilon_a + epsilon_b - epsilon_i - epsilon_j);
+                }
+            }  // end of summation over virtual orbitals
+
+        }
+    }  // end of summation over occupied orbitals
+
+    return E;
+}
+
+
 }  // namespace GQCP
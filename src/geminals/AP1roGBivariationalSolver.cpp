@@ -83,7 +83,7 @@ AP1roGBivariationalSolver::AP1roGBivariationalSolver(const Molecule& molecule, c
  */
 void AP1roGBivariationalSolver::solve() {
 
-    auto g = this->ham_par.get_g();
+    const auto& g = this->ham_par.get_g();
 
 
     // Solve the PSEs and set part of the solutions
@@ -17,6 +17,7 @@
 // 
 #include "geminals/AP1roGJacobiOrbitalOptimizer.hpp"
 
+#include <chrono>
 #include <cmath>
 #include <queue>
 
@@ -80,8 +81,8 @@ AP1roGJacobiOrbitalOptimizer::AP1roGJacobiOrbitalOptimizer(const Molecule& molec
  */
 void AP1roGJacobiOrbitalOptimizer::calculateJacobiCoefficients(size_t p, size_t q, const AP1roGGeminalCoefficients& G) {
 
-    auto h = this->ham_par.get_h();
-    auto g = this->ham_par.get_g();
+    const auto& h = this->ham_par.get_h();
+    const auto& g = this->ham_par.get_g();
 
 
     // Implementation of the Jacobi rotation coefficients with disjoint cases for p and q
@@ -298,6 +299,8 @@ double AP1roGJacobiOrbitalOptimizer::findOptimalRotationAngle(size_t p, size_t q
  *  Optimize the AP1roG energy by consequently
  *      - solving the AP1roG equations
  *      - finding the optimal Jacobi transformation (i.e. the one that yields the lowest energy)
+ *
+ *  After every iteration, the attached observers are notified with the energy change, the AP1roG energy and the time spent in the PSE solver
  */
 void AP1roGJacobiOrbitalOptimizer::solve() {
 
@@ -309,6 +312,12 @@ void AP1roGJacobiOrbitalOptimizer::solve() {
 
     size_t iterations = 0;
     while (!(this->is_converged)) {
+        auto start = std::chrono::steady_clock::now();
+
+        IterationRecord record;  // the diagnostics of this iteration
+        record.solver = "AP1roGJacobiOrbitalOptimizer";
+        record.iteration = iterations;
+
 
         // Find the Jacobi parameters (p,q,theta) that minimize the energy
         std::priority_queue<JacobiRotationEnergy> min_q;  // an ascending queue (on energy) because we have implemented the 'reverse' JacobiRotationEnergy::operator<
@@ -339,11 +348,18 @@ void AP1roGJacobiOrbitalOptimizer::solve() {
 
 
         // Solve the PSEs in the rotated spatial orbital basis
+        auto pse_start = std::chrono::steady_clock::now();
         AP1roGPSESolver pse_solver (this->N_P, this->ham_par, G);  // use the unrotated solution G as initial guess for the PSEs in the rotated basis
         pse_solver.solve();
         G = pse_solver.get_geminal_coefficients();
         double E = calculateAP1roGEnergy(G, this->ham_par);
 
+        record.number_of_matvecs = 1;  // the PSE solve plays the role of the expensive operator application
+        record.matvec_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - pse_start).count();
+        record.residual_norms = {std::abs(E - E_old)};
+        record.eigenvalues = {E};
+        this->finishIteration(record, start);
+
         // Check for convergence
         if (std::abs(E - E_old) < this->oo_threshold) {
             this->is_converged = true;
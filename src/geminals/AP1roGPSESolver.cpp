@@ -87,8 +87,8 @@ AP1roGPSESolver::AP1roGPSESolver(const Molecule& molecule, const HamiltonianPara
  */
 double AP1roGPSESolver::calculateJacobianElement(const AP1roGGeminalCoefficients& G, size_t i, size_t a, size_t k, size_t c) const {
 
-    auto h = this->ham_par.get_h();
-    auto g = this->ham_par.get_g();
+    const auto& h = this->ham_par.get_h();
+    const auto& g = this->ham_par.get_g();
 
     double j_el = 0.0;
 
@@ -189,8 +189,8 @@ SquareMatrix<double> AP1roGPSESolver::calculateJacobian(const VectorX<double>& g
  */
 double AP1roGPSESolver::calculateCoordinateFunction(const AP1roGGeminalCoefficients& G, size_t i, size_t a) const {
 
-    auto h = this->ham_par.get_h();
-    auto g = this->ham_par.get_g();
+    const auto& h = this->ham_par.get_h();
+    const auto& g = this->ham_par.get_g();
 
     double f = 0.0;
 
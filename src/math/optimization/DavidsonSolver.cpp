@@ -16,10 +16,14 @@
 // along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
 // 
 #include "math/optimization/DavidsonSolver.hpp"
+
+#include "math/optimization/DavidsonSubspace.hpp"
+
 #include <iostream>
 
 
 
+#include <algorithm>
 #include <chrono>
 
 
@@ -41,8 +45,12 @@ namespace GQCP {
  *  @param maximum_subspace_dimension           the maximum dimension of the Davidson subspace before collapsing
  *  @param collapsed_subspace_dimension         the dimension of the subspace after collapse
  *  @param maximum_number_of_iterations         the maximum number of Davidson iterations
+ *  @param subspace_precision                   the precision in which the subspace vectors are stored
+ *  @param refinement_threshold                 the residual norm at which single-precision iterations hand over to the double-precision refinement
+ *  @param subspace_storage                     where the (double-precision) subspace vectors are stored
+ *  @param scratch_directory                    the directory for the scratch files of a memory-mapped subspace
  */
-DavidsonSolver::DavidsonSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs, double convergence_threshold, double correction_threshold, size_t maximum_subspace_dimension, size_t collapsed_subspace_dimension, size_t maximum_number_of_iterations) :
+DavidsonSolver::DavidsonSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs, double convergence_threshold, double correction_threshold, size_t maximum_subspace_dimension, size_t collapsed_subspace_dimension, size_t maximum_number_of_iterations, SubspacePrecision subspace_precision, double refinement_threshold, SubspaceStorage subspace_storage, const std::string& scratch_directory) :
     BaseEigenproblemSolver(static_cast<size_t>(V_0.rows()), number_of_requested_eigenpairs),
     matrixVectorProduct (matrixVectorProduct),
     diagonal (diagonal),
@@ -51,18 +59,22 @@ DavidsonSolver::DavidsonSolver(const VectorFunction& matrixVectorProduct, const
     correction_threshold (correction_threshold),
     maximum_subspace_dimension (maximum_subspace_dimension),
     collapsed_subspace_dimension (collapsed_subspace_dimension),
-    maximum_number_of_iterations (maximum_number_of_iterations)
+    maximum_number_of_iterations (maximum_number_of_iterations),
+    subspace_precision (subspace_precision),
+    refinement_threshold (refinement_threshold),
+    subspace_storage (subspace_storage),
+    scratch_directory (scratch_directory)
 {
     if (V_0.cols() < this->number_of_requested_eigenpairs) {
-        throw std::invalid_argument("DavidsonSolver::DavidsonSolver(VectorFunction, VectorX<double>, MatrixX<double>, size_t, double, double, size_t, size_t, size_t): You have to specify at least as many initial guesses as number of requested eigenpairs.");
+        throw std::invalid_argument("DavidsonSolver::DavidsonSolver(VectorFunction, VectorX<double>, MatrixX<double>, size_t, double, double, size_t, size_t, size_t, SubspacePrecision, double, SubspaceStorage, std::string): You have to specify at least as many initial guesses as number of requested eigenpairs.");
     }
 
     if (this->collapsed_subspace_dimension < this->number_of_requested_eigenpairs) {
-        throw std::invalid_argument("DavidsonSolver::DavidsonSolver(VectorFunction, VectorX<double>, MatrixX<double>, size_t, double, double, size_t, size_t, size_t): The collapsed subspace dimension must be at least the number of requested eigenpairs.");
+        throw std::invalid_argument("DavidsonSolver::DavidsonSolver(VectorFunction, VectorX<double>, MatrixX<double>, size_t, double, double, size_t, size_t, size_t, SubspacePrecision, double, SubspaceStorage, std::string): The collapsed subspace dimension must be at least the number of requested eigenpairs.");
     }
 
     if (this->collapsed_subspace_dimension >= this->maximum_subspace_dimension) {
-        throw std::invalid_argument("DavidsonSolver::DavidsonSolver(VectorFunction, VectorX<double>, MatrixX<double>, size_t, double, double, size_t, size_t, size_t): The collapsed subspace dimension must be smaller than the maximum subspace dimension.");
+        throw std::invalid_argument("DavidsonSolver::DavidsonSolver(VectorFunction, VectorX<double>, MatrixX<double>, size_t, double, double, size_t, size_t, size_t, SubspacePrecision, double, SubspaceStorage, std::string): The collapsed subspace dimension must be smaller than the maximum subspace dimension.");
     }
 }
 
@@ -76,10 +88,14 @@ DavidsonSolver::DavidsonSolver(const VectorFunction& matrixVectorProduct, const
  *  @param maximum_subspace_dimension           the maximum dimension of the Davidson subspace before collapsing
  *  @param collapsed_subspace_dimension         the dimension of the subspace after collapse
  *  @param maximum_number_of_iterations         the maximum number of Davidson iterations
+ *  @param subspace_precision                   the precision in which the subspace vectors are stored
+ *  @param refinement_threshold                 the residual norm at which single-precision iterations hand over to the double-precision refinement
+ *  @param subspace_storage                     where the (double-precision) subspace vectors are stored
+ *  @param scratch_directory                    the directory for the scratch files of a memory-mapped subspace
  */
-DavidsonSolver::DavidsonSolver(const SquareMatrix<double>& A, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs, double convergence_threshold, double correction_threshold, size_t maximum_subspace_dimension, size_t collapsed_subspace_dimension, size_t maximum_number_of_iterations) :
+DavidsonSolver::DavidsonSolver(const SquareMatrix<double>& A, const MatrixX<double>& V_0, size_t number_of_requested_eigenpairs, double convergence_threshold, double correction_threshold, size_t maximum_subspace_dimension, size_t collapsed_subspace_dimension, size_t maximum_number_of_iterations, SubspacePrecision subspace_precision, double refinement_threshold, SubspaceStorage subspace_storage, const std::string& scratch_directory) :
     DavidsonSolver([A](const VectorX<double>& x) { return A * x; },  // lambda matrix-vector product function created from the given matrix A
-                   A.diagonal(), V_0, number_of_requested_eigenpairs, convergence_threshold, correction_threshold, maximum_subspace_dimension, collapsed_subspace_dimension, maximum_number_of_iterations)
+                   A.diagonal(), V_0, number_of_requested_eigenpairs, convergence_threshold, correction_threshold, maximum_subspace_dimension, collapsed_subspace_dimension, maximum_number_of_iterations, subspace_precision, refinement_threshold, subspace_storage, scratch_directory)
 {}
 
 
@@ -90,8 +106,12 @@ DavidsonSolver::DavidsonSolver(const SquareMatrix<double>& A, const MatrixX<doub
  */
 DavidsonSolver::DavidsonSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal,
                                const DavidsonSolverOptions& davidson_solver_options) :
-   DavidsonSolver(matrixVectorProduct, diagonal, davidson_solver_options.X_0, davidson_solver_options.number_of_requested_eigenpairs, davidson_solver_options.convergence_threshold, davidson_solver_options.correction_threshold, davidson_solver_options.maximum_subspace_dimension, davidson_solver_options.collapsed_subspace_dimension, davidson_solver_options.maximum_number_of_iterations)
-{}
+   DavidsonSolver(matrixVectorProduct, diagonal, davidson_solver_options.X_0, davidson_solver_options.number_of_requested_eigenpairs, davidson_solver_options.convergence_threshold, davidson_solver_options.correction_threshold, davidson_solver_options.maximum_subspace_dimension, davidson_solver_options.collapsed_subspace_dimension, davidson_solver_options.maximum_number_of_iterations, davidson_solver_options.subspace_precision, davidson_solver_options.refinement_threshold, davidson_solver_options.subspace_storage, davidson_solver_options.scratch_directory)
+{
+    for (const auto& observer : davidson_solver_options.observers) {
+        this->attach(observer);
+    }
+}
 
 
 /**
@@ -105,6 +125,252 @@ DavidsonSolver::DavidsonSolver(const SquareMatrix<double>& A, const DavidsonSolv
 
 
 
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  @param r            a residual vector
+ *  @param lambda       the corresponding eigenvalue estimate
+ *
+ *  @return the normalized correction vector, i.e. the solution of the (diagonally approximated) residue correction equation
+ */
+VectorX<double> DavidsonSolver::calculateCorrectionVector(const VectorX<double>& r, double lambda) const {
+
+    // The implementation of these equations is adapted from Klaas Gunst's DOCI code (https://github.com/klgunst/doci)
+    VectorX<double> denominator = this->diagonal - VectorX<double>::Constant(this->dim, lambda);
+    VectorX<double> delta = (denominator.array().abs() > this->correction_threshold).select(r.array() / denominator.array().abs(),
+                                                                                            r / this->correction_threshold);
+    delta.normalize();
+
+    return delta;
+}
+
+
+/**
+ *  @param x            the vector that should be multiplied
+ *  @param record       the record of the current iteration, in which the cost of the matrix-vector product is accumulated
+ *
+ *  @return the (expensive) matrix-vector product of the matrix with x
+ */
+VectorX<double> DavidsonSolver::calculateMatrixVectorProduct(const VectorX<double>& x, IterationRecord& record) const {
+
+    auto start = std::chrono::steady_clock::now();
+    VectorX<double> product = this->matrixVectorProduct(x);
+    auto stop = std::chrono::steady_clock::now();
+
+    record.number_of_matvecs++;
+    record.matvec_time += std::chrono::duration<double>(stop - start).count();
+
+    return product;
+}
+
+
+/**
+ *  Finish the record of the current iteration, notify the attached observers and prepare the record and start time for the next iteration
+ *
+ *  @param record       the record of the current iteration
+ *  @param start        the time at which the current iteration started
+ */
+void DavidsonSolver::notifyIteration(IterationRecord& record, std::chrono::steady_clock::time_point& start) const {
+
+    this->finishIteration(record, start);
+
+    record = IterationRecord();
+    record.solver = "DavidsonSolver";
+    start = std::chrono::steady_clock::now();
+}
+
+
+/**
+ *  Do Davidson iterations with the subspace vectors and their matrix-vector products stored in single precision, until all residual norms drop below the refinement threshold
+ *
+ *  @return the (dim x number_of_requested_eigenpairs)-matrix of Ritz vectors, which serve as initial guesses for the double-precision refinement
+ */
+MatrixX<double> DavidsonSolver::iterateInSinglePrecision() {
+
+    // Single precision can't resolve residuals much below 1.0e-06, so we never ask for more than the convergence threshold
+    const double threshold = std::max(this->refinement_threshold, this->convergence_threshold);
+
+
+    IterationRecord record;  // the diagnostics of the current iteration
+    record.solver = "DavidsonSolver";
+    auto start = std::chrono::steady_clock::now();
+
+
+    // Calculate the expensive matrix-vector products for all given initial guesses in double precision, but store them in single precision
+    MatrixX<float> V = this->V_0.cast<float>();
+    MatrixX<float> VA (this->dim, this->V_0.cols());
+    for (size_t j = 0; j < this->V_0.cols(); j++) {
+        VA.col(j) = this->calculateMatrixVectorProduct(this->V_0.col(j), record).cast<float>();
+    }
+
+
+    // The stored subspace vectors are only orthonormal up to single precision, so we keep track of their overlap matrix M and solve the generalized subspace eigenvalue problem S z = lambda M z
+    MatrixX<double> S = DavidsonSolver::transposeMultiply(V, VA);
+    MatrixX<double> M = DavidsonSolver::transposeMultiply(V, V);
+
+    while (true) {
+        Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (S, M);
+        VectorX<double> Lambda = eigensolver.eigenvalues().head(this->number_of_requested_eigenpairs);
+        MatrixX<double> Z = eigensolver.eigenvectors().topLeftCorner(S.cols(), this->number_of_requested_eigenpairs);
+
+
+        // Calculate the Ritz vectors and the residual vectors, accumulating in double precision
+        MatrixX<double> X = DavidsonSolver::multiply(V, Z);
+        MatrixX<double> R = DavidsonSolver::multiply(VA, Z) - X * Lambda.asDiagonal();
+        VectorX<double> residual_norms = R.colwise().norm();
+
+        record.iteration = this->number_of_iterations;
+        record.residual_norms = std::vector<double>(residual_norms.data(), residual_norms.data() + residual_norms.size());
+        record.eigenvalues = std::vector<double>(Lambda.data(), Lambda.data() + Lambda.size());
+        record.subspace_dimension = V.cols();
+        record.allocated_bytes = 2 * V.size() * sizeof(float) + 2 * X.size() * sizeof(double);  // V, VA, X and R
+
+        if (!((residual_norms.array() > threshold).any())) {
+            this->notifyIteration(record, start);
+
+            // The Ritz vectors are only orthonormal up to single precision, so we re-orthonormalize them for the double-precision refinement
+            Eigen::HouseholderQR<Eigen::MatrixXd> qr (X);
+            return qr.householderQ() * MatrixX<double>::Identity(this->dim, X.cols());
+        }
+
+        this->number_of_iterations++;
+        if (this->number_of_iterations >= this->maximum_number_of_iterations) {
+            this->notifyIteration(record, start);
+            throw std::runtime_error("DavidsonSolver::iterateInSinglePrecision(): The single-precision Davidson iterations did not reach the refinement threshold.");
+        }
+
+
+        // If the new correction vectors wouldn't fit, do a subspace collapse onto the lowest Ritz vectors first
+        //  A subspace that isn't larger than the collapsed dimension (e.g. because of many initial guesses) can't be collapsed, and it can't exceed the maximum dimension by more than the number of requested eigenpairs
+        if ((V.cols() + R.cols() > this->maximum_subspace_dimension) && (V.cols() > this->collapsed_subspace_dimension)) {
+            MatrixX<double> lowest_eigenvectors = eigensolver.eigenvectors().leftCols(this->collapsed_subspace_dimension);
+
+            V = DavidsonSolver::collapse(V, lowest_eigenvectors);
+            VA = DavidsonSolver::collapse(VA, lowest_eigenvectors);
+
+            S = DavidsonSolver::transposeMultiply(V, VA);
+            M = DavidsonSolver::transposeMultiply(V, V);
+            record.collapsed = true;
+        }
+
+
+        // Calculate new subspace vectors by projecting the correction vectors onto the orthogonal complement of V
+        auto previous_subspace_dimension = static_cast<size_t>(S.cols());
+        for (size_t column_index = 0; column_index < R.cols(); column_index++) {
+            VectorX<double> v = this->calculateCorrectionVector(R.col(column_index), Lambda(column_index));
+
+            // Since V is only orthonormal up to single precision, we project twice
+            for (size_t pass = 0; pass < 2; pass++) {
+                v -= DavidsonSolver::multiply(V, DavidsonSolver::transposeMultiply(V, v));
+            }
+
+            double norm = v.norm();
+            v.normalize();
+
+            if (norm > 1.0e-03) {  // include in the new subspace
+                V.conservativeResize(Eigen::NoChange, V.cols()+1);
+                V.col(V.cols()-1) = v.cast<float>();
+
+                VectorX<double> vA = this->calculateMatrixVectorProduct(v, record);
+                VA.conservativeResize(Eigen::NoChange, VA.cols()+1);
+                VA.col(VA.cols()-1) = vA.cast<float>();
+            }
+        }
+
+
+        // Only calculate the rows of S and M that haven't been calculated yet
+        auto current_subspace_dimension = static_cast<size_t>(V.cols());
+        S.conservativeResize(current_subspace_dimension, current_subspace_dimension);
+        M.conservativeResize(current_subspace_dimension, current_subspace_dimension);
+
+        for (auto j = previous_subspace_dimension; j < current_subspace_dimension; j++) {
+            VectorX<double> s_j = DavidsonSolver::transposeMultiply(V, VA.col(j));
+            S.col(j) = s_j;
+            S.row(j) = s_j;
+
+            VectorX<double> m_j = DavidsonSolver::transposeMultiply(V, V.col(j));
+            M.col(j) = m_j;
+            M.row(j) = m_j;
+        }
+
+        this->notifyIteration(record, start);
+    }
+}
+
+
+
+/*
+ *  PRIVATE STATIC METHODS - SINGLE-PRECISION KERNELS
+ */
+
+constexpr size_t DavidsonSolver::block_size;
+
+
+/**
+ *  @param V        a (dim x m)-matrix stored in single precision
+ *  @param Z        a (m x n)-matrix
+ *
+ *  @return the product V * Z, accumulated in double precision over blocks of rows of V
+ */
+template <typename Derived>
+MatrixX<double> DavidsonSolver::multiply(const MatrixX<float>& V, const Eigen::MatrixBase<Derived>& Z) {
+
+    const auto rows = static_cast<size_t>(V.rows());
+
+    MatrixX<double> result (rows, Z.cols());
+    for (size_t start = 0; start < rows; start += DavidsonSolver::block_size) {
+        const auto block_rows = std::min(DavidsonSolver::block_size, rows - start);
+        result.middleRows(start, block_rows).noalias() = V.middleRows(start, block_rows).cast<double>() * Z.template cast<double>();
+    }
+
+    return result;
+}
+
+
+/**
+ *  @param V        a (dim x m)-matrix stored in single precision
+ *  @param W        a (dim x n)-matrix
+ *
+ *  @return the product V^T * W, accumulated in double precision over blocks of rows of V and W
+ */
+template <typename Derived>
+MatrixX<double> DavidsonSolver::transposeMultiply(const MatrixX<float>& V, const Eigen::MatrixBase<Derived>& W) {
+
+    const auto rows = static_cast<size_t>(V.rows());
+
+    MatrixX<double> result = MatrixX<double>::Zero(V.cols(), W.cols());
+    for (size_t start = 0; start < rows; start += DavidsonSolver::block_size) {
+        const auto block_rows = std::min(DavidsonSolver::block_size, rows - start);
+        result.noalias() += V.middleRows(start, block_rows).cast<double>().transpose() * W.middleRows(start, block_rows).template cast<double>();
+    }
+
+    return result;
+}
+
+
+/**
+ *  @param V        a (dim x m)-matrix stored in single precision
+ *  @param Y        a (m x c)-matrix whose columns define the collapsed subspace
+ *
+ *  @return the collapsed (dim x c)-matrix V * Y in single precision, calculated without a full double-precision intermediate
+ */
+MatrixX<float> DavidsonSolver::collapse(const MatrixX<float>& V, const MatrixX<double>& Y) {
+
+    const auto rows = static_cast<size_t>(V.rows());
+
+    MatrixX<float> result (rows, Y.cols());
+    for (size_t start = 0; start < rows; start += DavidsonSolver::block_size) {
+        const auto block_rows = std::min(DavidsonSolver::block_size, rows - start);
+        result.middleRows(start, block_rows) = (V.middleRows(start, block_rows).cast<double>() * Y).cast<float>();
+    }
+
+    return result;
+}
+
+
+
 /*
  *  GETTERS
  */
@@ -133,16 +399,30 @@ size_t DavidsonSolver::get_number_of_iterations() const {
  */
 void DavidsonSolver::solve() {
 
-    // Calculate the expensive matrix-vector products for all given initial guesses, and store them in VA
-    MatrixX<double> VA = MatrixX<double>::Zero(this->dim, this->V_0.cols());
+    // For a single-precision subspace, the double-precision iterations only have to refine the resulting Ritz vectors
+    MatrixX<double> V_initial = (this->subspace_precision == SubspacePrecision::SINGLE) ? this->iterateInSinglePrecision() : this->V_0;
 
-    for (size_t j = 0; j < this->V_0.cols(); j++) {
-        VA.col(j) = this->matrixVectorProduct(this->V_0.col(j));
+    // The subspace vectors (V) and their matrix-vector products (VA) are stored in core or in memory-mapped scratch files
+    //  The subspace collapses before it would exceed the maximum dimension, so its capacity is known beforehand. Only the columns that are actually used occupy memory, which keeps e.g. a refinement after single-precision iterations, which usually needs only a few columns, cheap
+    const size_t capacity = std::max({this->maximum_subspace_dimension, static_cast<size_t>(V_initial.cols()), this->collapsed_subspace_dimension + this->number_of_requested_eigenpairs});
+    DavidsonSubspace V (this->dim, capacity, this->subspace_storage, this->scratch_directory);
+    DavidsonSubspace VA (this->dim, capacity, this->subspace_storage, this->scratch_directory);
+
+    IterationRecord record;  // the diagnostics of the current iteration
+    record.solver = "DavidsonSolver";
+    auto start = std::chrono::steady_clock::now();
+
+    // Calculate the expensive matrix-vector products for all initial subspace vectors, and store them in VA
+    for (size_t j = 0; j < V_initial.cols(); j++) {
+        V.append(V_initial.col(j));
+        VA.append(this->calculateMatrixVectorProduct(V_initial.col(j), record));
     }
 
     // Calculate the initial subspace matrix S
-    MatrixX<double> V = this->V_0;
-    MatrixX<double> S = V.transpose() * VA;
+    MatrixX<double> S (V.cols(), V.cols());
+    for (size_t j = 0; j < V.cols(); j++) {
+        S.col(j) = V.transposeMultiply(VA.column(j));
+    }
 
 
     // this->number_of_iterations starts at 0
@@ -157,33 +437,35 @@ void DavidsonSolver::solve() {
 
         // Calculate new guesses for the eigenvectors
         // X is a (dim x number_of_requested_eigenpairs)-matrix
-        MatrixX<double> X = V * Z;
+        MatrixX<double> X = V.multiply(Z);
 
 
         // Calculate the residual vectors and solve the residual equations
         //  Calculate the residual vectors in the matrix R (dim x number_of_requested_eigenpairs)
         //  Calculate the correction vectors in the matrix Delta (dim x number_of_requested_eigenpairs)
-        MatrixX<double> R = MatrixX<double>::Zero(this->dim, this->number_of_requested_eigenpairs);
+        MatrixX<double> R = VA.multiply(Z) - X * Lambda.asDiagonal();
+        VectorX<double> residual_norms = R.colwise().norm();
         MatrixX<double> Delta = MatrixX<double>::Zero(this->dim, this->number_of_requested_eigenpairs);
         for (size_t column_index = 0; column_index < R.cols(); column_index++) {
 
-            // Calculate the residual vectors
-            R.col(column_index) = VA * Z.col(column_index) - Lambda(column_index) * X.col(column_index);
-
             // Solve the residual equations
-            // The implementation of these equations is adapted from Klaas Gunst's DOCI code (https://github.com/klgunst/doci)
-            VectorX<double> denominator = this->diagonal - VectorX<double>::Constant(this->dim, Lambda(column_index));
-            Delta.col(column_index) = (denominator.array().abs() > this->correction_threshold).select(R.col(column_index).array() / denominator.array().abs(),
-                                                                                                      R.col(column_index) / this->correction_threshold);
-            Delta.col(column_index).normalize();
+            Delta.col(column_index) = this->calculateCorrectionVector(R.col(column_index), Lambda(column_index));
         }
 
 
+        record.iteration = this->number_of_iterations;
+        record.residual_norms = std::vector<double>(residual_norms.data(), residual_norms.data() + residual_norms.size());
+        record.eigenvalues = std::vector<double>(Lambda.data(), Lambda.data() + Lambda.size());
+        record.subspace_dimension = V.cols();
+        record.allocated_bytes = V.allocated_bytes() + VA.allocated_bytes() + 3 * this->number_of_requested_eigenpairs * this->dim * sizeof(double);  // V, VA, X, R and Delta
+
+
         // Check for convergence on each of the residual vectors
         //  If all residual norms are smaller than the threshold, the algorithm is considered converging
         //  We use !any() because it's possibly smaller than all()
-        if (!((R.colwise().norm().array() > this->convergence_threshold).any())) {  // CLion can give errors that .any() is not found, but it compiles
+        if (!((residual_norms.array() > this->convergence_threshold).any())) {  // CLion can give errors that .any() is not found, but it compiles
             this->_is_solved = true;
+            this->notifyIteration(record, start);
 
             // Set the eigenvalues and eigenvectors in this->eigenpairs
             for (size_t i = 0; i < this->number_of_requested_eigenpairs; i++) {
@@ -201,41 +483,47 @@ void DavidsonSolver::solve() {
 
             // If we reach more than this->maximum_number_of_iterations, the system is considered not to be converging
             if (this->number_of_iterations >= this->maximum_number_of_iterations) {
+                this->notifyIteration(record, start);
                 throw std::runtime_error("DavidsonSolver::solve(): The Davidson algorithm did not converge.");
             }
         }
 
 
+        // If needed, do a subspace collapse
+        //  We collapse before adding any new vectors, since S (and its eigenvectors) only describe the subspace at the start of this iteration
+        //  A subspace that isn't larger than the collapsed dimension (e.g. because of many initial guesses) can't be collapsed, but then the new vectors still fit in the capacity
+        if ((V.cols() + Delta.cols() > this->maximum_subspace_dimension) && (V.cols() > this->collapsed_subspace_dimension)) {
+            MatrixX<double> lowest_eigenvectors = eigensolver.eigenvectors().leftCols(this->collapsed_subspace_dimension);
+
+            // The new subspace vectors are linear combinations of current subspace vectors, with coefficients found in the lowest eigenvectors of the subspace matrix
+            V.collapse(lowest_eigenvectors);
+            VA.collapse(lowest_eigenvectors);
+
+            // In the orthonormal basis of the lowest eigenvectors, the subspace matrix is diagonal
+            S = eigensolver.eigenvalues().head(this->collapsed_subspace_dimension).asDiagonal();
+            record.collapsed = true;
+        }
+
+
         // Calculate new subspace vectors by projecting the correction vectors (in Delta) onto the orthogonal complement of V
         for (size_t column_index = 0; column_index < Delta.cols(); column_index++) {
 
             // Project the correction vectors on the orthogonal complement of V
-            VectorX<double> v = Delta.col(column_index) - V * (V.transpose() * Delta.col(column_index));
+            VectorX<double> v = Delta.col(column_index) - V.multiply(V.transposeMultiply(Delta.col(column_index)));
+
+            // If most of the (normalized) correction vector lay inside the subspace, one projection loses orthogonality: project once more
+            if (v.norm() < 1.0 / std::sqrt(2.0)) {
+                v -= V.multiply(V.transposeMultiply(v));
+            }
 
             double norm = v.norm();  // calculate the norm before normalizing: if the norm is large enough, we include it in the subspace
             v.normalize();
 
             if (norm > 1.0e-03) {  // include in the new subspace
-
-                // If needed, do a subspace collapse
-                if (V.cols() == this->maximum_subspace_dimension) {
-                    MatrixX<double> lowest_eigenvectors = eigensolver.eigenvectors().topLeftCorner(S.cols(), this->collapsed_subspace_dimension);
-
-                    // The new subspace vectors are linear combinations of current subspace vectors, with coefficients found in the lowest eigenvectors of the subspace matrix
-                    V = V * lowest_eigenvectors;
-                    VA = VA * lowest_eigenvectors;
-
-                    S = V.transpose() * VA;
-                }
-
-                V.conservativeResize(Eigen::NoChange, V.cols()+1);
-                V.col(V.cols()-1) = v;
-
-                VectorX<double> vA = this->matrixVectorProduct(v);  // calculate the expensive matrix-vector product if a new vector is added to the subspace
-                VA.conservativeResize(Eigen::NoChange, VA.cols()+1);
-                VA.col(VA.cols()-1) = vA;
+                V.append(v);
+                VA.append(this->calculateMatrixVectorProduct(v, record));  // calculate the expensive matrix-vector product if a new vector is added to the subspace
             }
-            assert((V.transpose() * V).isApprox(MatrixX<double>::Identity(V.cols(), V.cols()), 1.0e-08));  // make sure that the subspace vectors are orthonormal
+            assert((V.matrix().transpose() * V.matrix()).isApprox(MatrixX<double>::Identity(V.cols(), V.cols()), 1.0e-08));  // make sure that the subspace vectors are orthonormal
         }
 
         // Calculate the new subspace matrix
@@ -249,10 +537,12 @@ void DavidsonSolver::solve() {
 
         for (auto j = previous_subspace_dimension-1; j < current_subspace_dimension; j++) {  // -1 because of computers
             // Only calculate the rows of S that haven't been calculated yet
-            VectorX<double> s_j = V.transpose() * VA.col(j);  // s_j = V^T vA_j
+            VectorX<double> s_j = V.transposeMultiply(VA.column(j));  // s_j = V^T vA_j
             S.col(j) = s_j;
             S.row(j) = s_j;
         }
+
+        this->notifyIteration(record, start);
     }
 }
 
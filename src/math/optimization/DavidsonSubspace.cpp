@@ -0,0 +1,299 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "math/optimization/DavidsonSubspace.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param dim                  the dimension of the column vectors
+ *  @param capacity             the maximum number of columns that can be stored
+ *  @param storage              where the columns should be stored
+ *  @param scratch_directory    the directory in which the scratch file is created for memory-mapped storage, preferably on a fast local disk
+ *
+ *  A memory-mapped scratch file is removed from the file system right after its creation, so it disappears together with this subspace
+ */
+DavidsonSubspace::DavidsonSubspace(size_t dim, size_t capacity, SubspaceStorage storage, const std::string& scratch_directory) :
+    dim (dim),
+    capacity (capacity)
+{
+    // Only reserve the in-core storage: the columns are written (and thus allocated by the operating system) as they are appended. Since the reserved storage is never exceeded, the data pointer doesn't change
+    if (storage == SubspaceStorage::IN_CORE) {
+        this->buffer.reserve(dim * capacity);
+        this->data = this->buffer.data();
+        return;
+    }
+
+
+    // Create a unique scratch file and unlink it immediately: the storage is released as soon as the file descriptor is closed
+    std::string filename = scratch_directory + "/gqcp_davidson_XXXXXX";
+    std::vector<char> filename_template (filename.begin(), filename.end());
+    filename_template.push_back('\0');
+
+    this->file_descriptor = mkstemp(filename_template.data());
+    if (this->file_descriptor == -1) {
+        throw std::runtime_error("DavidsonSubspace::DavidsonSubspace(size_t, size_t, SubspaceStorage, std::string): Could not create a scratch file in " + scratch_directory);
+    }
+    unlink(filename_template.data());
+
+    const auto number_of_bytes = static_cast<off_t>(dim * capacity * sizeof(double));
+    if (ftruncate(this->file_descriptor, number_of_bytes) != 0) {
+        close(this->file_descriptor);
+        throw std::runtime_error("DavidsonSubspace::DavidsonSubspace(size_t, size_t, SubspaceStorage, std::string): Could not allocate the scratch file in " + scratch_directory);
+    }
+
+    void* address = mmap(nullptr, dim * capacity * sizeof(double), PROT_READ | PROT_WRITE, MAP_SHARED, this->file_descriptor, 0);
+    if (address == MAP_FAILED) {
+        close(this->file_descriptor);
+        throw std::runtime_error("DavidsonSubspace::DavidsonSubspace(size_t, size_t, SubspaceStorage, std::string): Could not memory-map the scratch file.");
+    }
+    this->data = static_cast<double*>(address);
+
+    // All kernels stream through the columns, so the kernel may read ahead aggressively
+    posix_madvise(address, dim * capacity * sizeof(double), POSIX_MADV_SEQUENTIAL);
+}
+
+
+
+/*
+ *  DESTRUCTOR
+ */
+
+DavidsonSubspace::~DavidsonSubspace() {
+
+    if (this->is_memory_mapped()) {
+        munmap(this->data, this->dim * this->capacity * sizeof(double));
+        close(this->file_descriptor);
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+constexpr size_t DavidsonSubspace::block_size;
+
+
+/**
+ *  @return a read-only view on the stored columns
+ */
+Eigen::Map<const Eigen::MatrixXd> DavidsonSubspace::matrix() const {
+    return Eigen::Map<const Eigen::MatrixXd>(this->data, this->dim, this->number_of_columns);
+}
+
+
+/**
+ *  @param j            the index of the column
+ *
+ *  @return a copy of the j-th column
+ */
+VectorX<double> DavidsonSubspace::column(size_t j) const {
+
+    if (j >= this->number_of_columns) {
+        throw std::invalid_argument("DavidsonSubspace::column(size_t): The given column index is out of bounds.");
+    }
+
+    return Eigen::Map<const Eigen::VectorXd>(this->data + j * this->dim, this->dim);
+}
+
+
+/**
+ *  @param j            the index of the column
+ *  @param v            the (dim)-dimensional vector in which a copy of the j-th column is stored, without allocating
+ */
+void DavidsonSubspace::column(size_t j, VectorX<double>& v) const {
+
+    if (j >= this->number_of_columns) {
+        throw std::invalid_argument("DavidsonSubspace::column(size_t, VectorX<double>): The given column index is out of bounds.");
+    }
+
+    if (v.size() != this->dim) {
+        throw std::invalid_argument("DavidsonSubspace::column(size_t, VectorX<double>): The given vector has an incompatible dimension.");
+    }
+
+    v = Eigen::Map<const Eigen::VectorXd>(this->data + j * this->dim, this->dim);
+}
+
+
+/**
+ *  Append a (scaled) column vector
+ *
+ *  @param v            the column vector that should be appended
+ *  @param scaling      the factor with which v is multiplied before it is stored
+ */
+void DavidsonSubspace::append(const VectorX<double>& v, double scaling) {
+
+    if (v.size() != this->dim) {
+        throw std::invalid_argument("DavidsonSubspace::append(VectorX<double>, double): The given vector has an incompatible dimension.");
+    }
+
+    if (this->number_of_columns == this->capacity) {
+        throw std::invalid_argument("DavidsonSubspace::append(VectorX<double>, double): The subspace is already filled to capacity.");
+    }
+
+    if (this->number_of_columns == this->number_of_allocated_columns) {
+        if (!this->is_memory_mapped()) {
+            this->buffer.resize(this->buffer.size() + this->dim);
+        }
+        this->number_of_allocated_columns++;
+    }
+
+    Eigen::Map<Eigen::VectorXd>(this->data + this->number_of_columns * this->dim, this->dim) = scaling * v;
+    this->number_of_columns++;
+}
+
+
+/**
+ *  @param w            a (dim)-dimensional vector
+ *
+ *  @return the product V^T w, streaming once over every stored column
+ */
+VectorX<double> DavidsonSubspace::transposeMultiply(const VectorX<double>& w) const {
+
+    VectorX<double> result (this->number_of_columns);
+    this->transposeMultiply(w, result);
+
+    return result;
+}
+
+
+/**
+ *  @param w            a (dim)-dimensional vector
+ *  @param result       the vector in which the product V^T w is stored, without allocating; its size should be the number of stored columns
+ */
+void DavidsonSubspace::transposeMultiply(const VectorX<double>& w, Eigen::Ref<Eigen::VectorXd> result) const {
+
+    if ((w.size() != this->dim) || (result.size() != this->number_of_columns)) {
+        throw std::invalid_argument("DavidsonSubspace::transposeMultiply(VectorX<double>, Eigen::Ref<Eigen::VectorXd>): The given vectors have incompatible dimensions.");
+    }
+
+    const auto V = this->matrix();
+
+    result.setZero();
+    for (size_t start = 0; start < this->dim; start += DavidsonSubspace::block_size) {
+        const auto block_rows = std::min(DavidsonSubspace::block_size, this->dim - start);
+        result.noalias() += V.middleRows(start, block_rows).transpose() * w.segment(start, block_rows);
+    }
+}
+
+
+/**
+ *  @param Z            a (cols x n)-matrix
+ *
+ *  @return the (dim x n)-matrix V Z, streaming over blocks of rows
+ */
+MatrixX<double> DavidsonSubspace::multiply(const MatrixX<double>& Z) const {
+
+    if (Z.rows() != this->number_of_columns) {
+        throw std::invalid_argument("DavidsonSubspace::multiply(MatrixX<double>): The given matrix has an incompatible number of rows.");
+    }
+
+    const auto V = this->matrix();
+
+    MatrixX<double> result (this->dim, Z.cols());
+    for (size_t start = 0; start < this->dim; start += DavidsonSubspace::block_size) {
+        const auto block_rows = std::min(DavidsonSubspace::block_size, this->dim - start);
+        result.middleRows(start, block_rows).noalias() = V.middleRows(start, block_rows) * Z;
+    }
+
+    return result;
+}
+
+
+/**
+ *  @param z            a vector whose size is at most the number of stored columns
+ *  @param result       the (dim)-dimensional vector in which the product of the first z.size() columns with z is stored, without allocating
+ */
+void DavidsonSubspace::multiply(const Eigen::Ref<const Eigen::VectorXd>& z, VectorX<double>& result) const {
+
+    if ((z.size() > this->number_of_columns) || (result.size() != this->dim)) {
+        throw std::invalid_argument("DavidsonSubspace::multiply(Eigen::Ref<const Eigen::VectorXd>, VectorX<double>): The given vectors have incompatible dimensions.");
+    }
+
+    const auto V = this->matrix().leftCols(z.size());
+
+    for (size_t start = 0; start < this->dim; start += DavidsonSubspace::block_size) {
+        const auto block_rows = std::min(DavidsonSubspace::block_size, this->dim - start);
+        result.segment(start, block_rows).noalias() = V.middleRows(start, block_rows) * z;
+    }
+}
+
+
+/**
+ *  Subtract the product of the first z.size() columns with z from the given vector, streaming over blocks of rows
+ *
+ *  @param z            a vector whose size is at most the number of stored columns
+ *  @param w            the (dim)-dimensional vector from which V z is subtracted
+ */
+void DavidsonSubspace::subtractProduct(const Eigen::Ref<const Eigen::VectorXd>& z, VectorX<double>& w) const {
+
+    if ((z.size() > this->number_of_columns) || (w.size() != this->dim)) {
+        throw std::invalid_argument("DavidsonSubspace::subtractProduct(Eigen::Ref<const Eigen::VectorXd>, VectorX<double>): The given vectors have incompatible dimensions.");
+    }
+
+    const auto V = this->matrix().leftCols(z.size());
+
+    for (size_t start = 0; start < this->dim; start += DavidsonSubspace::block_size) {
+        const auto block_rows = std::min(DavidsonSubspace::block_size, this->dim - start);
+        w.segment(start, block_rows).noalias() -= V.middleRows(start, block_rows) * z;
+    }
+}
+
+
+/**
+ *  Replace the stored columns by the linear combinations V Y, in place and streaming over blocks of rows
+ *
+ *  @param Y            a (cols x c)-matrix whose columns define the collapsed subspace
+ */
+void DavidsonSubspace::collapse(const MatrixX<double>& Y) {
+
+    if ((Y.rows() != this->number_of_columns) || (Y.cols() > this->number_of_columns)) {
+        throw std::invalid_argument("DavidsonSubspace::collapse(MatrixX<double>): The given matrix has incompatible dimensions.");
+    }
+
+    const auto collapsed_dimension = static_cast<size_t>(Y.cols());
+    Eigen::Map<Eigen::MatrixXd> V (this->data, this->dim, this->number_of_columns);
+
+    // Every block of rows of the collapsed columns only depends on the same block of rows of the current columns, so we can overwrite them block by block
+    for (size_t start = 0; start < this->dim; start += DavidsonSubspace::block_size) {
+        const auto block_rows = std::min(DavidsonSubspace::block_size, this->dim - start);
+
+        MatrixX<double> collapsed_block = V.middleRows(start, block_rows) * Y;
+        V.block(start, 0, block_rows, collapsed_dimension) = collapsed_block;
+    }
+
+    this->number_of_columns = collapsed_dimension;
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,545 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "math/optimization/IterativeLinearSolver.hpp"
+
+#include "math/optimization/DavidsonSubspace.hpp"
+
+#include <cmath>
+#include <limits>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param matrixVectorProduct              a vector function that returns the matrix-vector product of A (i.e. the matrix-vector product representation of A)
+ *  @param diagonal                         the diagonal of A
+ *  @param shift                            the shift that is subtracted from A, e.g. an eigenvalue E
+ *  @param reference                        the reference vector whose orthogonal complement contains the solutions, or an empty vector if no projection is needed
+ *  @param method                           the Krylov method that is used
+ *  @param convergence_threshold            the tolerance on the norm of the residual vector
+ *  @param maximum_number_of_iterations     the maximum number of iterations per right-hand side
+ *  @param restart_dimension                the maximum dimension of the Krylov subspace in GMRES before a restart
+ *  @param subspace_storage                 where the GMRES Krylov vectors are stored
+ *  @param scratch_directory                the directory for the scratch files of memory-mapped Krylov vectors
+ */
+IterativeLinearSolver::IterativeLinearSolver(const VectorFunction& matrixVectorProduct, const VectorX<double>& diagonal, double shift, const VectorX<double>& reference, KrylovMethod method, double convergence_threshold, size_t maximum_number_of_iterations, size_t restart_dimension, SubspaceStorage subspace_storage, const std::string& scratch_directory) :
+    method (method),
+    convergence_threshold (convergence_threshold),
+    maximum_number_of_iterations (maximum_number_of_iterations),
+    restart_dimension (restart_dimension),
+    subspace_storage (subspace_storage),
+    scratch_directory (scratch_directory),
+    matrixVectorProduct (matrixVectorProduct),
+    shift (shift),
+    dim (static_cast<size_t>(diagonal.size())),
+    inverse_preconditioner (diagonal.size())
+{
+    if (restart_dimension == 0) {
+        throw std::invalid_argument("IterativeLinearSolver::IterativeLinearSolver(VectorFunction, VectorX<double>, double, VectorX<double>, KrylovMethod, double, size_t, size_t, SubspaceStorage, std::string): The restart dimension must be at least 1.");
+    }
+
+
+    // MINRES requires a positive definite preconditioner, so it uses the absolute values of the shifted diagonal
+    for (size_t i = 0; i < this->dim; i++) {
+        double m = diagonal(i) - shift;
+        if (method == KrylovMethod::MINRES) {
+            m = std::abs(m);
+        }
+        if (std::abs(m) < IterativeLinearSolver::preconditioner_threshold) {
+            m = (m < 0.0) ? -IterativeLinearSolver::preconditioner_threshold : IterativeLinearSolver::preconditioner_threshold;
+        }
+        this->inverse_preconditioner(i) = 1.0 / m;
+    }
+
+
+    if (reference.size() > 0) {
+        if ((reference.size() != diagonal.size()) || (reference.norm() < 1.0e-12)) {
+            throw std::invalid_argument("IterativeLinearSolver::IterativeLinearSolver(VectorFunction, VectorX<double>, double, VectorX<double>, KrylovMethod, double, size_t, size_t, SubspaceStorage, std::string): The reference vector must be a non-zero vector with the dimension of the diagonal.");
+        }
+
+        this->reference = reference.normalized();
+        this->preconditioned_reference = this->inverse_preconditioner.cwiseProduct(this->reference);
+        this->reference_overlap = this->reference.dot(this->preconditioned_reference);
+    }
+}
+
+
+/**
+ *  @param A                                the matrix
+ *  @param shift                            the shift that is subtracted from A, e.g. an eigenvalue E
+ *  @param reference                        the reference vector whose orthogonal complement contains the solutions, or an empty vector if no projection is needed
+ *  @param method                           the Krylov method that is used
+ *  @param convergence_threshold            the tolerance on the norm of the residual vector
+ *  @param maximum_number_of_iterations     the maximum number of iterations per right-hand side
+ *  @param restart_dimension                the maximum dimension of the Krylov subspace in GMRES before a restart
+ *  @param subspace_storage                 where the GMRES Krylov vectors are stored
+ *  @param scratch_directory                the directory for the scratch files of memory-mapped Krylov vectors
+ */
+IterativeLinearSolver::IterativeLinearSolver(const SquareMatrix<double>& A, double shift, const VectorX<double>& reference, KrylovMethod method, double convergence_threshold, size_t maximum_number_of_iterations, size_t restart_dimension, SubspaceStorage subspace_storage, const std::string& scratch_directory) :
+    IterativeLinearSolver([A](const VectorX<double>& x) { return A * x; },  // lambda matrix-vector product function created from the given matrix A
+                          A.diagonal(), shift, reference, method, convergence_threshold, maximum_number_of_iterations, restart_dimension, subspace_storage, scratch_directory)
+{}
+
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+constexpr double IterativeLinearSolver::preconditioner_threshold;
+
+
+/**
+ *  @param x            a vector in the orthogonal complement of the reference vector
+ *  @param y            the vector in which P (A - shift) x is stored
+ *  @param record       the record of the current iteration, in which the cost of the matrix-vector product is accumulated
+ */
+void IterativeLinearSolver::applyOperator(const VectorX<double>& x, VectorX<double>& y, IterationRecord& record) const {
+
+    auto start = std::chrono::steady_clock::now();
+    y = this->matrixVectorProduct(x);
+    auto stop = std::chrono::steady_clock::now();
+
+    record.number_of_matvecs++;
+    record.matvec_time += std::chrono::duration<double>(stop - start).count();
+
+    y -= this->shift * x;
+    this->project(y);
+}
+
+
+/**
+ *  @param r            a vector in the orthogonal complement of the reference vector
+ *  @param z            the vector in which the preconditioned vector is stored, which is again orthogonal to the reference vector
+ */
+void IterativeLinearSolver::applyPreconditioner(const VectorX<double>& r, VectorX<double>& z) const {
+
+    z.noalias() = this->inverse_preconditioner.cwiseProduct(r);
+
+    if (this->reference.size() > 0) {
+
+        // Use M^(-1) - M^(-1) c c^T M^(-1) / (c^T M^(-1) c), i.e. the inverse of the preconditioner in the orthogonal complement of c, and fall back to a plain projection if it is ill-defined
+        if (std::abs(this->reference_overlap) > IterativeLinearSolver::preconditioner_threshold) {
+            z -= (this->reference.dot(z) / this->reference_overlap) * this->preconditioned_reference;
+        } else {
+            this->project(z);
+        }
+    }
+}
+
+
+/**
+ *  @param v            the vector from which the component along the reference vector should be removed
+ */
+void IterativeLinearSolver::project(VectorX<double>& v) const {
+
+    if (this->reference.size() > 0) {
+        v -= this->reference.dot(v) * this->reference;
+    }
+}
+
+
+/**
+ *  Finish the record of the current iteration, notify the attached observers and prepare the record and start time for the next iteration
+ *
+ *  @param record       the record of the current iteration
+ *  @param start        the time at which the current iteration started
+ */
+void IterativeLinearSolver::notifyIteration(IterationRecord& record, std::chrono::steady_clock::time_point& start) const {
+
+    this->finishIteration(record, start);
+
+    IterationRecord next_record;
+    next_record.solver = record.solver;
+    next_record.iteration = record.iteration + 1;
+    next_record.allocated_bytes = record.allocated_bytes;
+    record = next_record;
+    start = std::chrono::steady_clock::now();
+}
+
+
+/**
+ *  @param b            the (projected) right-hand side
+ *  @param x            the solution, which should be initialized to zero
+ *
+ *  @return the number of iterations that were needed
+ */
+size_t IterativeLinearSolver::solveCG(const VectorX<double>& b, VectorX<double>& x) const {
+
+    IterationRecord record;  // the diagnostics of the current iteration
+    record.solver = "IterativeLinearSolver::CG";
+    record.allocated_bytes = 5 * this->dim * sizeof(double);  // x, r, z, p and Ap
+    auto start = std::chrono::steady_clock::now();
+
+
+    // All work vectors are allocated once, before the iterations
+    VectorX<double> r = b;  // the residual
+    VectorX<double> z (this->dim);  // the preconditioned residual
+    VectorX<double> p (this->dim);  // the search direction
+    VectorX<double> Ap (this->dim);
+
+    this->applyPreconditioner(r, z);
+    p = z;
+    double rz = r.dot(z);
+
+    double residual_norm = r.norm();
+    size_t iteration = 0;
+    while (residual_norm >= this->convergence_threshold) {
+
+        if (iteration == this->maximum_number_of_iterations) {
+            throw std::runtime_error("IterativeLinearSolver::solveCG(VectorX<double>, VectorX<double>): The CG algorithm did not converge.");
+        }
+
+        this->applyOperator(p, Ap, record);
+        double pAp = p.dot(Ap);
+        if (pAp <= 0.0) {
+            throw std::runtime_error("IterativeLinearSolver::solveCG(VectorX<double>, VectorX<double>): The matrix is not positive definite. Use MINRES or GMRES instead.");
+        }
+
+        double alpha = rz / pAp;
+        x += alpha * p;
+        r -= alpha * Ap;
+        residual_norm = r.norm();
+
+        this->applyPreconditioner(r, z);
+        double rz_new = r.dot(z);
+        p *= rz_new / rz;
+        p += z;
+        rz = rz_new;
+
+        record.residual_norms = {residual_norm};
+        this->notifyIteration(record, start);
+        iteration++;
+    }
+
+    return iteration;
+}
+
+
+/**
+ *  @param b            the (projected) right-hand side
+ *  @param x            the solution, which should be initialized to zero
+ *
+ *  @return the number of iterations that were needed
+ */
+size_t IterativeLinearSolver::solveMINRES(const VectorX<double>& b, VectorX<double>& x) const {
+
+    // The implementation follows the preconditioned MINRES algorithm of Paige and Saunders, in which we additionally update the unpreconditioned residual with A w, so that every method uses the same convergence criterion without extra matrix-vector products
+    IterationRecord record;  // the diagnostics of the current iteration
+    record.solver = "IterativeLinearSolver::MINRES";
+    record.allocated_bytes = 13 * this->dim * sizeof(double);  // x, r, r1, r2, y, v, Av, w, w1, w2, Aw, Aw1 and Aw2
+    auto start = std::chrono::steady_clock::now();
+
+
+    // All work vectors are allocated once, before the iterations
+    VectorX<double> r = b;  // the (unpreconditioned) residual
+    VectorX<double> r1 = b;
+    VectorX<double> r2 = b;
+    VectorX<double> y (this->dim);
+    VectorX<double> v (this->dim);  // the current Lanczos vector
+    VectorX<double> Av (this->dim);
+    VectorX<double> w = VectorX<double>::Zero(this->dim);  // the current search direction
+    VectorX<double> w1 = VectorX<double>::Zero(this->dim);
+    VectorX<double> w2 = VectorX<double>::Zero(this->dim);
+    VectorX<double> Aw = VectorX<double>::Zero(this->dim);
+    VectorX<double> Aw1 = VectorX<double>::Zero(this->dim);
+    VectorX<double> Aw2 = VectorX<double>::Zero(this->dim);
+
+    this->applyPreconditioner(r1, y);
+    double beta = std::sqrt(r1.dot(y));
+    double old_beta = 0.0;
+    double phibar = beta;
+    double dbar = 0.0;
+    double epsilon = 0.0;
+    double cs = -1.0;
+    double sn = 0.0;
+
+    double residual_norm = r.norm();
+    size_t iteration = 0;
+    while (residual_norm >= this->convergence_threshold) {
+
+        if ((iteration == this->maximum_number_of_iterations) || (beta < std::numeric_limits<double>::min())) {
+            throw std::runtime_error("IterativeLinearSolver::solveMINRES(VectorX<double>, VectorX<double>): The MINRES algorithm did not converge.");
+        }
+
+        // Do a (preconditioned) Lanczos step
+        v = y / beta;
+        this->applyOperator(v, Av, record);
+        y = Av;
+        if (iteration > 0) {
+            y -= (beta / old_beta) * r1;
+        }
+        double alpha = v.dot(y);
+        y -= (alpha / beta) * r2;
+        r1.swap(r2);
+        r2 = y;
+        this->applyPreconditioner(r2, y);
+        old_beta = beta;
+        beta = std::sqrt(r2.dot(y));
+
+
+        // Apply the previous and the current Givens rotation to the tridiagonal Lanczos matrix
+        double old_epsilon = epsilon;
+        double delta = cs * dbar + sn * alpha;
+        double gbar = sn * dbar - cs * alpha;
+        epsilon = sn * beta;
+        dbar = -cs * beta;
+        double gamma = std::max(std::hypot(gbar, beta), std::numeric_limits<double>::epsilon());
+        cs = gbar / gamma;
+        sn = beta / gamma;
+        double phi = cs * phibar;
+        phibar = sn * phibar;
+
+
+        // Update the search direction, the solution and the residual, cycling through the buffers instead of allocating new ones
+        w1.swap(w2);
+        w2.swap(w);
+        w = (v - old_epsilon * w1 - delta * w2) / gamma;
+        Aw1.swap(Aw2);
+        Aw2.swap(Aw);
+        Aw = (Av - old_epsilon * Aw1 - delta * Aw2) / gamma;
+
+        x += phi * w;
+        r -= phi * Aw;
+        residual_norm = r.norm();
+
+        record.residual_norms = {residual_norm};
+        this->notifyIteration(record, start);
+        iteration++;
+    }
+
+    return iteration;
+}
+
+
+/**
+ *  @param b            the (projected) right-hand side
+ *  @param x            the solution, which should be initialized to zero
+ *
+ *  @return the number of iterations that were needed
+ */
+size_t IterativeLinearSolver::solveGMRES(const VectorX<double>& b, VectorX<double>& x) const {
+
+    // The Krylov vectors are stored in the same streamed (and possibly memory-mapped) storage as the Davidson subspace, and GMRES is right-preconditioned so that the monitored residual is the unpreconditioned one
+    const auto m = this->restart_dimension;
+    DavidsonSubspace V (this->dim, m + 1, this->subspace_storage, this->scratch_directory);
+
+    IterationRecord record;  // the diagnostics of the current iteration
+    record.solver = "IterativeLinearSolver::GMRES";
+    record.allocated_bytes = (m + 6) * this->dim * sizeof(double);  // V, x, r, v, z and w
+    auto start = std::chrono::steady_clock::now();
+
+
+    // All work arrays are allocated once, before the iterations, and the Arnoldi steps use the non-allocating kernels of the Krylov subspace
+    VectorX<double> r = b;  // the residual
+    VectorX<double> v (this->dim);  // the current Krylov vector
+    VectorX<double> z (this->dim);
+    VectorX<double> w (this->dim);
+    MatrixX<double> H (m + 1, m);  // the (rotated) Hessenberg matrix
+    VectorX<double> g (m + 1);  // the (rotated) right-hand side of the least-squares problem
+    VectorX<double> h (m);  // the projections of the new Krylov vector
+    VectorX<double> h_correction (m);  // the projections of the reorthogonalized Krylov vector
+    VectorX<double> y (m);  // the solution of the least-squares problem
+    VectorX<double> cs (m);
+    VectorX<double> sn (m);
+
+    double residual_norm = r.norm();
+    size_t iteration = 0;
+    while (residual_norm >= this->convergence_threshold) {
+
+        // (Re)start from the current residual
+        V.clear();
+        V.append(r, 1.0 / residual_norm);
+        H.setZero();
+        g.setZero();
+        g(0) = residual_norm;
+
+        size_t j = 0;  // the number of Arnoldi steps in this cycle
+        while (j < m) {
+
+            if (iteration == this->maximum_number_of_iterations) {
+                throw std::runtime_error("IterativeLinearSolver::solveGMRES(VectorX<double>, VectorX<double>): The GMRES algorithm did not converge.");
+            }
+
+            record.subspace_dimension = V.cols();
+
+            // Do an Arnoldi step with classical Gram-Schmidt and one reorthogonalization, each of which streams once over the Krylov vectors
+            V.column(j, v);
+            this->applyPreconditioner(v, z);
+            this->applyOperator(z, w, record);
+
+            V.transposeMultiply(w, h.head(j + 1));
+            V.subtractProduct(h.head(j + 1), w);
+            V.transposeMultiply(w, h_correction.head(j + 1));
+            V.subtractProduct(h_correction.head(j + 1), w);
+            h.head(j + 1) += h_correction.head(j + 1);
+
+            H.col(j).head(j + 1) = h.head(j + 1);
+            double h_next = w.norm();
+            H(j + 1, j) = h_next;
+
+
+            // Apply the previous Givens rotations to the new column, and annihilate its subdiagonal element
+            for (size_t i = 0; i < j; i++) {
+                double temp = cs(i) * H(i, j) + sn(i) * H(i + 1, j);
+                H(i + 1, j) = -sn(i) * H(i, j) + cs(i) * H(i + 1, j);
+                H(i, j) = temp;
+            }
+            double denominator = std::hypot(H(j, j), H(j + 1, j));
+            cs(j) = H(j, j) / denominator;
+            sn(j) = H(j + 1, j) / denominator;
+            H(j, j) = denominator;
+            H(j + 1, j) = 0.0;
+            g(j + 1) = -sn(j) * g(j);
+            g(j) = cs(j) * g(j);
+
+            residual_norm = std::abs(g(j + 1));
+            j++;
+
+            record.residual_norms = {residual_norm};
+            this->notifyIteration(record, start);
+            iteration++;
+
+            if ((residual_norm < this->convergence_threshold) || (h_next < 1.0e-14 * g(0))) {
+                break;
+            }
+
+            if (j < m) {
+                V.append(w, 1.0 / h_next);
+            }
+        }
+
+
+        // Update the solution with the least-squares solution in the current Krylov subspace
+        y.head(j) = g.head(j);
+        H.topLeftCorner(j, j).triangularView<Eigen::Upper>().solveInPlace(y.head(j));
+        V.multiply(y.head(j), w);
+        this->applyPreconditioner(w, z);
+        x += z;
+
+
+        // Before a restart, calculate the true residual
+        if (residual_norm >= this->convergence_threshold) {
+            this->applyOperator(x, w, record);
+            r = b - w;
+            residual_norm = r.norm();
+        }
+    }
+
+    return iteration;
+}
+
+
+
+/*
+ *  GETTERS
+ */
+
+const MatrixX<double>& IterativeLinearSolver::get_solutions() const {
+
+    if (this->is_solved) {
+        return this->X;
+    } else {
+        throw std::logic_error("IterativeLinearSolver::get_solutions(): You are trying to get the solutions, but the linear systems haven't been solved (yet).");
+    }
+}
+
+
+VectorX<double> IterativeLinearSolver::get_solution(size_t index) const {
+
+    if (index >= static_cast<size_t>(this->get_solutions().cols())) {
+        throw std::invalid_argument("IterativeLinearSolver::get_solution(size_t): The given index is larger than the number of right-hand sides.");
+    }
+
+    return this->X.col(index);
+}
+
+
+const std::vector<size_t>& IterativeLinearSolver::get_number_of_iterations() const {
+
+    if (this->is_solved) {
+        return this->number_of_iterations;
+    } else {
+        throw std::logic_error("IterativeLinearSolver::get_number_of_iterations(): You are trying to get the number of iterations, but the linear systems haven't been solved (yet).");
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Solve the linear systems of equations for every right-hand side, one after the other
+ *
+ *  @param B            the right-hand side(s), specified as column(s) of the given vector/matrix. Their components along the reference vector are removed.
+ *
+ *  If successful, it sets
+ *      - is_solved to true
+ *      - the solutions, as columns
+ */
+void IterativeLinearSolver::solve(const MatrixX<double>& B) {
+
+    if (B.rows() != this->dim) {
+        throw std::invalid_argument("IterativeLinearSolver::solve(MatrixX<double>): The right-hand sides have an incompatible dimension.");
+    }
+
+    this->is_solved = false;
+    this->X = MatrixX<double>::Zero(this->dim, B.cols());
+    this->number_of_iterations.clear();
+
+    VectorX<double> b (this->dim);
+    VectorX<double> x (this->dim);
+    for (size_t k = 0; k < B.cols(); k++) {
+        b = B.col(k);
+        this->project(b);
+        x.setZero();
+
+        size_t iterations = 0;
+        switch (this->method) {
+            case KrylovMethod::CG: {
+                iterations = this->solveCG(b, x);
+                break;
+            }
+
+            case KrylovMethod::MINRES: {
+                iterations = this->solveMINRES(b, x);
+                break;
+            }
+
+            case KrylovMethod::GMRES: {
+                iterations = this->solveGMRES(b, x);
+                break;
+            }
+        }
+
+        this->X.col(k) = x;
+        this->number_of_iterations.push_back(iterations);
+    }
+
+    this->is_solved = true;
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,149 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "math/optimization/LimitedMemoryBFGS.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param maximum_history_size     the maximum number of (s, y)-pairs that is stored: when a new pair is added to a full history, the oldest one is discarded
+ */
+LimitedMemoryBFGS::LimitedMemoryBFGS(size_t maximum_history_size) :
+    maximum_history_size (maximum_history_size)
+{
+    if (maximum_history_size == 0) {
+        throw std::invalid_argument("LimitedMemoryBFGS::LimitedMemoryBFGS(size_t): The maximum history size should be at least 1.");
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Add a (s, y)-pair to the history
+ *
+ *  @param s                the step x_(k+1) - x_k
+ *  @param y                the corresponding gradient difference g_(k+1) - g_k
+ *
+ *  @return if the pair has been added. A pair that doesn't satisfy the curvature condition y^T s > 0 is skipped, so that the approximate inverse Hessian stays positive definite
+ */
+bool LimitedMemoryBFGS::update(const VectorX<double>& s, const VectorX<double>& y) {
+
+    if (s.size() != y.size()) {
+        throw std::invalid_argument("LimitedMemoryBFGS::update(VectorX<double>, VectorX<double>): The step and the gradient difference should have the same dimension.");
+    }
+
+    if (!this->steps.empty() && (s.size() != this->steps.back().size())) {
+        throw std::invalid_argument("LimitedMemoryBFGS::update(VectorX<double>, VectorX<double>): The dimension of the given pair is not compatible with the stored pairs.");
+    }
+
+
+    // Skip pairs with (numerically) non-positive curvature
+    double ys = y.dot(s);
+    if (ys <= 1.0e-10 * y.norm() * s.norm()) {
+        return false;
+    }
+
+    if (this->steps.size() == this->maximum_history_size) {
+        this->steps.pop_front();
+        this->gradient_differences.pop_front();
+        this->rhos.pop_front();
+    }
+
+    this->steps.push_back(s);
+    this->gradient_differences.push_back(y);
+    this->rhos.push_back(1.0 / ys);
+
+    return true;
+}
+
+
+/**
+ *  @param v                            a vector
+ *  @param initial_hessian_diagonal     the (positive) diagonal of the initial Hessian approximation, whose inverse is updated with the stored pairs
+ *
+ *  @return the product H v of the approximate inverse Hessian H with the given vector, calculated with the two-loop recursion
+ */
+VectorX<double> LimitedMemoryBFGS::inverseHessianProduct(const VectorX<double>& v, const VectorX<double>& initial_hessian_diagonal) const {
+
+    if ((v.size() != initial_hessian_diagonal.size()) || (!this->steps.empty() && (v.size() != this->steps.back().size()))) {
+        throw std::invalid_argument("LimitedMemoryBFGS::inverseHessianProduct(VectorX<double>, VectorX<double>): The given vectors are not compatible with the stored pairs.");
+    }
+
+    const auto m = this->steps.size();
+    std::vector<double> alphas (m);
+    VectorX<double> q = v;
+
+
+    // The first loop runs from the most recent pair to the oldest one
+    for (size_t j = m; j-- > 0; ) {
+        alphas[j] = this->rhos[j] * this->steps[j].dot(q);
+        q -= alphas[j] * this->gradient_differences[j];
+    }
+
+    VectorX<double> r = q.cwiseQuotient(initial_hessian_diagonal);
+
+
+    // The second loop runs from the oldest pair to the most recent one
+    for (size_t j = 0; j < m; j++) {
+        double beta = this->rhos[j] * this->gradient_differences[j].dot(r);
+        r += (alphas[j] - beta) * this->steps[j];
+    }
+
+    return r;
+}
+
+
+/**
+ *  @param v                            a vector
+ *
+ *  @return the product H v of the approximate inverse Hessian H with the given vector, in which the initial inverse Hessian is the identity scaled with y^T s / y^T y of the most recent pair (or the identity if there are no stored pairs)
+ */
+VectorX<double> LimitedMemoryBFGS::inverseHessianProduct(const VectorX<double>& v) const {
+
+    double scaling = 1.0;  // the initial Hessian is the identity divided by this scaling factor
+    if (!this->steps.empty()) {
+        scaling = this->gradient_differences.back().squaredNorm() * this->rhos.back();
+    }
+
+    return this->inverseHessianProduct(v, VectorX<double>::Constant(v.size(), scaling));
+}
+
+
+/**
+ *  Remove all stored pairs
+ */
+void LimitedMemoryBFGS::clear() {
+    this->steps.clear();
+    this->gradient_differences.clear();
+    this->rhos.clear();
+}
+
+
+}  // namespace GQCP
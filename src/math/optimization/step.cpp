@@ -19,6 +19,12 @@
 
 #include "math/SquareMatrix.hpp"
 
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 
 namespace GQCP {
 
@@ -42,4 +48,115 @@ VectorX<double> newtonStep(const VectorX<double>& x, const VectorFunction& f, co
 }
 
 
+/**
+ *  @param gradient                         the gradient g at the current point
+ *  @param hessianVectorProduct             a vector function that returns the product of the Hessian H at the current point with a given vector
+ *  @param radius                           the radius of the trust region
+ *  @param predicted_change                 the change g^T p + 1/2 p^T H p that the quadratic model predicts for the returned step p, which is set by this function
+ *  @param convergence_threshold            the tolerance on the norm of the residual g + H p of the Newton equations, relative to the norm of the gradient
+ *  @param maximum_number_of_iterations     the maximum number of conjugate gradient iterations
+ *
+ *  @return the truncated conjugate gradient (Steihaug-Toint) step, which approximately minimizes the quadratic model within the trust region ||p|| <= radius. The conjugate gradient iterations are stopped at the boundary of the trust region, or as soon as a direction of negative curvature is encountered, so that the Hessian is only needed through its matrix-vector products
+ */
+VectorX<double> trustRegionNewtonStep(const VectorX<double>& gradient, const VectorFunction& hessianVectorProduct, double radius, double& predicted_change, double convergence_threshold, size_t maximum_number_of_iterations) {
+
+    if (radius <= 0.0) {
+        throw std::invalid_argument("trustRegionNewtonStep(VectorX<double>, VectorFunction, double, double&, double, size_t): The radius of the trust region should be positive.");
+    }
+
+    const auto dim = gradient.size();
+    VectorX<double> p = VectorX<double>::Zero(dim);
+    VectorX<double> Hp = VectorX<double>::Zero(dim);  // the product of the Hessian with the current step, needed for the predicted change
+    VectorX<double> r = gradient;  // the residual g + H p
+    VectorX<double> d = -r;  // the search direction
+
+    const double tolerance = convergence_threshold * gradient.norm();
+    for (size_t iteration = 0; (iteration < maximum_number_of_iterations) && (r.norm() > tolerance); iteration++) {
+
+        VectorX<double> Hd = hessianVectorProduct(d);
+        double curvature = d.dot(Hd);
+
+        // Move along the search direction, up to the boundary of the trust region if the direction has negative curvature or if the conjugate gradient step would leave the trust region
+        double alpha = 0.0;
+        bool reaches_boundary = (curvature <= 0.0);
+        if (!reaches_boundary) {
+            alpha = r.squaredNorm() / curvature;
+            reaches_boundary = ((p + alpha * d).norm() >= radius);
+        }
+
+        if (reaches_boundary) {  // solve ||p + alpha d|| = radius for alpha >= 0
+            double dd = d.squaredNorm();
+            double pd = p.dot(d);
+            double pp = p.squaredNorm();
+            alpha = (-pd + std::sqrt(pd*pd + dd * (radius*radius - pp))) / dd;
+        }
+
+        p += alpha * d;
+        Hp += alpha * Hd;
+        if (reaches_boundary) {
+            break;
+        }
+
+
+        // Update the residual and the search direction
+        double rr = r.squaredNorm();
+        r += alpha * Hd;
+        d = -r + (r.squaredNorm() / rr) * d;
+    }
+
+    predicted_change = gradient.dot(p) + 0.5 * p.dot(Hp);
+    return p;
+}
+
+
+/**
+ *  @param matrixVectorProduct              a vector function that returns the product of a symmetric matrix A with a given vector
+ *  @param x0                               the start vector of the Krylov subspace
+ *  @param convergence_threshold            the tolerance on the norm of the residual A v - lambda v of the Ritz pair
+ *  @param maximum_number_of_iterations     the maximum dimension of the Krylov subspace
+ *
+ *  @return an estimate of the lowest eigenpair of A: the lowest Ritz pair in the Krylov subspace that is built by the Lanczos algorithm (with full reorthogonalization)
+ */
+Eigenpair lanczosLowestEigenpair(const VectorFunction& matrixVectorProduct, const VectorX<double>& x0, double convergence_threshold, size_t maximum_number_of_iterations) {
+
+    if (x0.norm() < 1.0e-12) {
+        throw std::invalid_argument("lanczosLowestEigenpair(VectorFunction, VectorX<double>, double, size_t): The start vector should not be zero.");
+    }
+
+    const auto dim = static_cast<size_t>(x0.size());
+    const size_t maximum_subspace_dimension = std::max<size_t>(std::min(maximum_number_of_iterations, dim), 1);
+
+    MatrixX<double> V = MatrixX<double>::Zero(dim, maximum_subspace_dimension);  // the orthonormal Lanczos vectors
+    VectorX<double> alpha = VectorX<double>::Zero(maximum_subspace_dimension);  // the diagonal of the tridiagonal projection of A
+    VectorX<double> beta = VectorX<double>::Zero(maximum_subspace_dimension);  // the subdiagonal of the tridiagonal projection of A
+    V.col(0) = x0.normalized();
+
+    for (size_t j = 0; ; j++) {
+
+        VectorX<double> w = matrixVectorProduct(V.col(j));
+        alpha(j) = V.col(j).dot(w);
+
+        // Orthogonalize against all previous Lanczos vectors (twice, to be safe), which also removes the alpha and beta components of the three-term recurrence
+        for (size_t pass = 0; pass < 2; pass++) {
+            w -= V.leftCols(j+1) * (V.leftCols(j+1).transpose() * w);
+        }
+        beta(j) = w.norm();
+
+
+        // Find the lowest Ritz pair in the current Krylov subspace
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> tridiagonal_solver;
+        tridiagonal_solver.computeFromTridiagonal(Eigen::VectorXd(alpha.head(j+1)), Eigen::VectorXd(beta.head(j)));
+        double ritz_value = tridiagonal_solver.eigenvalues()(0);
+        VectorX<double> y = tridiagonal_solver.eigenvectors().col(0);
+
+        double residual_norm = beta(j) * std::abs(y(j));  // the norm of A v - lambda v for the Ritz vector v = V y
+        if ((residual_norm < convergence_threshold) || (j+1 == maximum_subspace_dimension)) {
+            return Eigenpair(ritz_value, V.leftCols(j+1) * y);
+        }
+
+        V.col(j+1) = w / beta(j);
+    }
+}
+
+
 }  // namespace GQCP
@@ -21,7 +21,9 @@
 #include <boost/math/special_functions.hpp>
 
 #include <chrono>
+#include <exception>
 #include <iostream>
+#include <thread>
 
 
 namespace GQCP {
@@ -101,4 +103,60 @@ size_t vectorIndex(size_t i, size_t j, size_t cols, size_t skipped) {
 }
 
 
+/**
+ *  Call a function on contiguous blocks of the range [0, size) that are distributed over a number of threads
+ *
+ *  @param size                 the size of the range
+ *  @param number_of_threads    the number of threads, or 0 to use all available hardware threads
+ *  @param function             the function that is called as function(start, end) for every block [start, end)
+ *
+ *  The calling thread handles the last block itself, and an exception that is thrown in any of the blocks is rethrown after all threads have finished
+ */
+void parallelFor(size_t size, size_t number_of_threads, const std::function<void(size_t, size_t)>& function) {
+
+    if (number_of_threads == 0) {
+        number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    number_of_threads = std::max<size_t>(std::min(number_of_threads, size), 1);  // every thread should get at least one element
+
+    if (number_of_threads == 1) {
+        function(0, size);
+        return;
+    }
+
+
+    // Divide the range as evenly as possible: the first (size % number_of_threads) blocks get one element more
+    std::vector<std::exception_ptr> exceptions (number_of_threads);
+    auto callBlock = [&] (size_t thread_index) {
+        const auto block_size = size / number_of_threads;
+        const auto remainder = size % number_of_threads;
+        const auto start = thread_index * block_size + std::min(thread_index, remainder);
+        const auto end = start + block_size + ((thread_index < remainder) ? 1 : 0);
+
+        try {
+            function(start, end);
+        } catch (...) {
+            exceptions[thread_index] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(number_of_threads - 1);
+    for (size_t thread_index = 0; thread_index < number_of_threads - 1; thread_index++) {
+        threads.emplace_back(callBlock, thread_index);
+    }
+    callBlock(number_of_threads - 1);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+
 }  // namespace GQCP
@@ -21,6 +21,7 @@
 #include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
 
 #include "Basis/AOBasis.hpp"
+#include "Basis/LibintInterfacer.hpp"
 
 #include "Molecule.hpp"
 
@@ -120,3 +121,190 @@ BOOST_AUTO_TEST_CASE( HORTON_integrals_h2o_sto3g ) {
     BOOST_CHECK(V.isApprox(ref_V, 1.0e-07));
     BOOST_CHECK(g.isApprox(ref_g, 1.0e-06));
 }
+
+
+BOOST_AUTO_TEST_CASE ( Schwarz_screening_h_chain ) {
+
+    // Set up an AO basis for an elongated molecule, in which many shell quartets are negligible
+    auto h_chain = GQCP::Molecule::HChain(12, 2.0);
+    GQCP::AOBasis ao_basis (h_chain, "6-31G");
+    auto nbf = ao_basis.numberOfBasisFunctions();
+
+
+    // Check the Schwarz bounds: they are symmetric and bound the diagonal integrals
+    const auto& schwarz_bounds = ao_basis.get_schwarz_bounds();
+    BOOST_CHECK(schwarz_bounds.isApprox(schwarz_bounds.transpose(), 1.0e-12));
+
+    auto g_exact = ao_basis.calculateCoulombRepulsionIntegrals(0.0);
+    BOOST_CHECK_EQUAL(ao_basis.get_number_of_skipped_quartets(), 0);
+    for (size_t p = 0; p < nbf; p++) {
+        for (size_t q = 0; q < nbf; q++) {
+            BOOST_CHECK(std::sqrt(std::abs(g_exact(p,q,p,q))) <= schwarz_bounds.maxCoeff() + 1.0e-12);
+        }
+    }
+
+
+    // Check if the screened integrals are equal to the unscreened ones up to the screening threshold, while some shell quartets are skipped
+    double threshold = 1.0e-08;
+    auto g_screened = ao_basis.calculateCoulombRepulsionIntegrals(threshold);
+    BOOST_CHECK(ao_basis.get_number_of_skipped_quartets() > 0);
+
+    double maximum_deviation = 0.0;
+    for (size_t p = 0; p < nbf; p++) {
+        for (size_t q = 0; q < nbf; q++) {
+            for (size_t r = 0; r < nbf; r++) {
+                for (size_t s = 0; s < nbf; s++) {
+                    maximum_deviation = std::max(maximum_deviation, std::abs(g_exact(p,q,r,s) - g_screened(p,q,r,s)));
+                }
+            }
+        }
+    }
+    BOOST_CHECK(maximum_deviation < threshold);
+
+
+    // By default, the integrals aren't screened
+    auto g_default = ao_basis.calculateCoulombRepulsionIntegrals();
+    BOOST_CHECK_EQUAL(ao_basis.get_number_of_skipped_quartets(), 0);
+    BOOST_CHECK(g_default.isApprox(g_exact, 0.0));
+}
+
+
+BOOST_AUTO_TEST_CASE ( multithreaded_integrals_h2o ) {
+
+    // Check if the multithreaded calculation of the two-electron integrals gives the same result as the serial one
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    GQCP::AOBasis ao_basis (water, "6-31G**");
+    auto nbf = ao_basis.numberOfBasisFunctions();
+
+    auto g_serial = ao_basis.calculateCoulombRepulsionIntegrals(0.0, 1);
+    auto g_parallel = ao_basis.calculateCoulombRepulsionIntegrals(0.0, 4);
+
+    double maximum_deviation = 0.0;
+    for (size_t p = 0; p < nbf; p++) {
+        for (size_t q = 0; q < nbf; q++) {
+            for (size_t r = 0; r < nbf; r++) {
+                for (size_t s = 0; s < nbf; s++) {
+                    maximum_deviation = std::max(maximum_deviation, std::abs(g_serial(p,q,r,s) - g_parallel(p,q,r,s)));
+                }
+            }
+        }
+    }
+    BOOST_CHECK(maximum_deviation < 1.0e-14);
+}
+
+
+BOOST_AUTO_TEST_CASE ( density_fitted_integrals_h2o ) {
+
+    // Check if the density-fitted two-electron integrals are close to the exact ones
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    GQCP::AOBasis ao_basis (water, "cc-pVDZ");
+    GQCP::AOBasis auxiliary_basis (water, "cc-pVDZ-RI");
+    auto nbf = ao_basis.numberOfBasisFunctions();
+
+    auto g = ao_basis.calculateCoulombRepulsionIntegrals(0.0);
+    auto g_DF = ao_basis.calculateDensityFittedCoulombRepulsionIntegrals(auxiliary_basis);
+    BOOST_CHECK(g_DF.get_number_of_vectors() <= auxiliary_basis.numberOfBasisFunctions());
+
+    double maximum_deviation = 0.0;
+    for (size_t p = 0; p < nbf; p++) {
+        for (size_t q = 0; q < nbf; q++) {
+            for (size_t r = 0; r < nbf; r++) {
+                for (size_t s = 0; s < nbf; s++) {
+                    maximum_deviation = std::max(maximum_deviation, std::abs(g(p,q,r,s) - g_DF(p,q,r,s)));
+                }
+            }
+        }
+    }
+    BOOST_CHECK(maximum_deviation < 1.0e-02);  // the fitting error of an RI basis
+}
+
+
+BOOST_AUTO_TEST_CASE ( Cholesky_integrals_h2o ) {
+
+    // Check if the error of the Cholesky-decomposed two-electron integrals is bounded by the tolerance
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    GQCP::AOBasis ao_basis (water, "6-31G**");
+    auto nbf = ao_basis.numberOfBasisFunctions();
+
+    double tolerance = 1.0e-06;
+    auto g = ao_basis.calculateCoulombRepulsionIntegrals(0.0);
+    auto g_Cholesky = ao_basis.calculateCholeskyCoulombRepulsionIntegrals(tolerance);
+    BOOST_CHECK(g_Cholesky.get_number_of_vectors() < nbf * (nbf + 1) / 2);
+
+    double maximum_deviation = 0.0;
+    for (size_t p = 0; p < nbf; p++) {
+        for (size_t q = 0; q < nbf; q++) {
+            for (size_t r = 0; r < nbf; r++) {
+                for (size_t s = 0; s < nbf; s++) {
+                    maximum_deviation = std::max(maximum_deviation, std::abs(g(p,q,r,s) - g_Cholesky(p,q,r,s)));
+                }
+            }
+        }
+    }
+    BOOST_CHECK(maximum_deviation < tolerance);
+}
+
+
+BOOST_AUTO_TEST_CASE ( direct_RHF_two_electron_matrix_h2o ) {
+
+    // Check if the integral-direct two-electron part of the RHF Fock matrix matches the one that is contracted from the stored integrals
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    GQCP::AOBasis ao_basis (water, "6-31G**");
+    auto nbf = ao_basis.numberOfBasisFunctions();
+
+    GQCP::SquareMatrix<double> D = GQCP::SquareMatrix<double>::Random(nbf, nbf);
+    D = 0.5 * (D + D.transpose()).eval();
+
+    auto g = ao_basis.calculateCoulombRepulsionIntegrals(0.0);
+    GQCP::SquareMatrix<double> G_ref = GQCP::SquareMatrix<double>::Zero(nbf, nbf);
+    for (size_t p = 0; p < nbf; p++) {
+        for (size_t q = 0; q < nbf; q++) {
+            for (size_t r = 0; r < nbf; r++) {
+                for (size_t s = 0; s < nbf; s++) {
+                    G_ref(p,q) += D(s,r) * (g(p,q,r,s) - 0.5 * g(p,s,r,q));
+                }
+            }
+        }
+    }
+
+    BOOST_CHECK(ao_basis.calculateDirectRHFTwoElectronMatrix(D, 0.0, 1).isApprox(G_ref, 1.0e-12));
+    BOOST_CHECK(ao_basis.calculateDirectRHFTwoElectronMatrix(D, 0.0, 4).isApprox(G_ref, 1.0e-12));
+    BOOST_CHECK(ao_basis.calculateDirectRHFTwoElectronMatrix(D, 1.0e-12).isApprox(G_ref, 1.0e-08));
+}
+
+
+BOOST_AUTO_TEST_CASE ( fused_one_electron_integrals_h2o ) {
+
+    // Check if the one-electron integrals that are calculated in one (multithreaded) sweep over the unique shell pairs match the ones from the serial sweep over all shell pairs
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    GQCP::AOBasis ao_basis (water, "6-31G**");
+
+    auto libint_basisset = GQCP::LibintInterfacer::get().interface(ao_basis.get_shell_set());
+    auto libint_atoms = GQCP::LibintInterfacer::get().interface(water.get_atoms());
+    std::array<double, 3> origin {0.1, -0.2, 0.3};
+
+    auto S_ref = GQCP::LibintInterfacer::get().calculateOneElectronIntegrals<1>(libint2::Operator::overlap, libint_basisset)[0];
+    auto T_ref = GQCP::LibintInterfacer::get().calculateOneElectronIntegrals<1>(libint2::Operator::kinetic, libint_basisset)[0];
+    auto V_ref = GQCP::LibintInterfacer::get().calculateOneElectronIntegrals<1>(libint2::Operator::nuclear, libint_basisset, make_point_charges(libint_atoms))[0];
+    auto dipole_ref = GQCP::LibintInterfacer::get().calculateOneElectronIntegrals<4>(libint2::Operator::emultipole1, libint_basisset, origin);
+
+    for (size_t number_of_threads : {1, 4}) {
+        auto one_electron_integrals = ao_basis.calculateOneElectronIntegrals(number_of_threads);
+        BOOST_CHECK(one_electron_integrals[0].isApprox(S_ref, 1.0e-12));
+        BOOST_CHECK(one_electron_integrals[1].isApprox(T_ref, 1.0e-12));
+        BOOST_CHECK(one_electron_integrals[2].isApprox(V_ref, 1.0e-12));
+
+        auto all_integrals = ao_basis.calculateOneElectronAndDipoleIntegrals(GQCP::Vector<double, 3>(0.1, -0.2, 0.3), number_of_threads);
+        BOOST_CHECK(all_integrals[0].isApprox(S_ref, 1.0e-12));
+        BOOST_CHECK(all_integrals[1].isApprox(T_ref, 1.0e-12));
+        BOOST_CHECK(all_integrals[2].isApprox(V_ref, 1.0e-12));
+        for (size_t i = 0; i < 3; i++) {
+            BOOST_CHECK(all_integrals[3 + i].isApprox(-dipole_ref[1 + i], 1.0e-12));
+        }
+    }
+
+    // The calculations of the separate operators use the same sweep
+    BOOST_CHECK(ao_basis.calculateOverlapIntegrals().isApprox(S_ref, 1.0e-12));
+    BOOST_CHECK(ao_basis.calculateKineticIntegrals().isApprox(T_ref, 1.0e-12));
+    BOOST_CHECK(ao_basis.calculateNuclearIntegrals().isApprox(V_ref, 1.0e-12));
+}
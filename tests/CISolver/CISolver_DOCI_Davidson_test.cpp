@@ -299,6 +299,60 @@ BOOST_AUTO_TEST_CASE ( DOCI_h2o_631g_klaas_Davidson ) {
     BOOST_CHECK(std::abs(test_doci_energy - (reference_doci_energy)) < 1.0e-9);
 }
 
+BOOST_AUTO_TEST_CASE ( DOCI_h2o_631g_klaas_Davidson_single_precision ) {
+
+    // Check if storing the Davidson subspace in single precision has no accuracy penalty with respect to the double-precision subspace
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_631g_klaas.FCIDUMP");
+
+    GQCP::FockSpace fock_space (ham_par.get_K(), 5);  // dim = 1287
+    GQCP::DOCI doci (fock_space);
+    GQCP::CISolver ci_solver (doci, ham_par);
+    GQCP::VectorX<double> initial_g = fock_space.HartreeFockExpansion();
+
+    // Solve with a double-precision subspace
+    GQCP::DavidsonSolverOptions double_solver_options (initial_g);
+    ci_solver.solve(double_solver_options);
+    auto double_eigenpair = ci_solver.get_eigenpair();
+
+    // Solve with a single-precision subspace
+    GQCP::DavidsonSolverOptions single_solver_options (initial_g);
+    single_solver_options.subspace_precision = GQCP::SubspacePrecision::SINGLE;
+    ci_solver.solve(single_solver_options);
+    auto single_eigenpair = ci_solver.get_eigenpair();
+
+
+    BOOST_CHECK(std::abs(single_eigenpair.get_eigenvalue() - double_eigenpair.get_eigenvalue()) < 1.0e-10);
+    BOOST_CHECK(single_eigenpair.isEqual(double_eigenpair, 1.0e-07));
+}
+
+
+BOOST_AUTO_TEST_CASE ( DOCI_li2_321g_klaas_Davidson_single_precision ) {
+
+    // Klaas' reference DOCI energy for Li2
+    double reference_doci_energy = -15.1153976060;
+
+
+    // Solve the Davidson DOCI eigenvalue problem with a single-precision subspace that is forced to collapse
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/li2_321g_klaas.FCIDUMP");
+
+    GQCP::FockSpace fock_space (ham_par.get_K(), 3);  // dim = 816
+    GQCP::DOCI doci (fock_space);
+    GQCP::CISolver ci_solver (doci, ham_par);
+
+    GQCP::VectorX<double> initial_g = fock_space.HartreeFockExpansion();
+    GQCP::DavidsonSolverOptions solver_options (initial_g);
+    solver_options.subspace_precision = GQCP::SubspacePrecision::SINGLE;
+    solver_options.maximum_subspace_dimension = 5;
+    ci_solver.solve(solver_options);
+
+    // Calculate the total energy
+    double internuclear_repulsion_energy =  3.0036546888874875e+00;  // this comes straight out of the FCIDUMP file
+    double test_doci_energy = ci_solver.get_eigenpair().get_eigenvalue() + internuclear_repulsion_energy;
+
+    BOOST_CHECK(std::abs(test_doci_energy - (reference_doci_energy)) < 1.0e-9);
+}
+
+
 /*
 BOOST_AUTO_TEST_CASE ( DOCI_lif_631g_klaas_Davidson ) {
 
@@ -22,6 +22,7 @@
 
 #include "CISolver/CISolver.hpp"
 #include "HamiltonianBuilder/DOCI.hpp"
+#include "HamiltonianBuilder/FCI.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 
 
@@ -42,3 +43,65 @@ BOOST_AUTO_TEST_CASE ( Solver_constructor ) {
     GQCP::DOCI random_doci_invalid (fock_space_invalid);
     BOOST_CHECK_THROW(GQCP::CISolver ci_solver (random_doci_invalid, random_hamiltonian_parameters), std::invalid_argument);
 }
+
+
+BOOST_AUTO_TEST_CASE ( diagonal_guess_throws ) {
+
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::FockSpace fock_space (ham_par.get_K(), 5);  // dim = 21
+    GQCP::DOCI doci (fock_space);
+    auto diagonal = doci.calculateDiagonal(ham_par);
+
+    BOOST_CHECK_THROW(GQCP::CISolver::calculateDiagonalGuess(doci, ham_par, diagonal, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::CISolver::calculateDiagonalGuess(doci, ham_par, diagonal, 22), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::CISolver::calculateDiagonalGuess(doci, ham_par, diagonal.head(20), 1), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( diagonal_guess_spin_pairing ) {
+
+    // Check if the guesses for an Ms=0 FCI calculation are orthonormal and symmetric under the interchange of alpha and beta
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace fock_space (ham_par.get_K(), 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+    auto diagonal = fci.calculateDiagonal(ham_par);
+
+    auto X_0 = GQCP::CISolver::calculateDiagonalGuess(fci, ham_par, diagonal, 3, 10);
+    BOOST_CHECK(X_0.cols() == 3);
+    BOOST_CHECK((X_0.transpose() * X_0).isApprox(GQCP::MatrixX<double>::Identity(3, 3), 1.0e-12));
+
+    // The ground state guess is a singlet
+    size_t dim_beta = fock_space.get_fock_space_beta().get_dimension();
+    for (size_t I_alpha = 0; I_alpha < dim_beta; I_alpha++) {
+        for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {
+            BOOST_CHECK(std::abs(X_0(I_alpha * dim_beta + I_beta, 0) - X_0(I_beta * dim_beta + I_alpha, 0)) < 1.0e-12);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( diagonal_guess_Davidson_excited_states ) {
+
+    // Check if a Davidson calculation without given initial guesses finds the same eigenvalues as the dense solver
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace fock_space (ham_par.get_K(), 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+    GQCP::CISolver ci_solver (fci, ham_par);
+
+    size_t number_of_requested_eigenpairs = 3;
+
+    GQCP::DenseSolverOptions dense_solver_options;
+    dense_solver_options.number_of_requested_eigenpairs = number_of_requested_eigenpairs;
+    ci_solver.solve(dense_solver_options);
+    auto dense_eigenpairs = ci_solver.get_eigenpairs();
+
+    GQCP::DavidsonSolverOptions davidson_solver_options;
+    davidson_solver_options.number_of_requested_eigenpairs = number_of_requested_eigenpairs;
+    davidson_solver_options.collapsed_subspace_dimension = number_of_requested_eigenpairs;
+    ci_solver.solve(davidson_solver_options);
+    auto davidson_eigenpairs = ci_solver.get_eigenpairs();
+
+    for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+        BOOST_CHECK(std::abs(dense_eigenpairs[i].get_eigenvalue() - davidson_eigenpairs[i].get_eigenvalue()) < 1.0e-08);
+    }
+}
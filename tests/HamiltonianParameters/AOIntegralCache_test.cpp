@@ -0,0 +1,141 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "AOIntegralCache"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+#include "HamiltonianParameters/AOIntegralCache.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+
+/**
+ *  @return the name of a new, empty directory in /tmp
+ */
+std::string createTemporaryDirectory() {
+    char directory_template[] = "/tmp/gqcp_aointegralcache_XXXXXX";
+    return std::string(mkdtemp(directory_template));
+}
+
+
+BOOST_AUTO_TEST_CASE ( constructor_throws ) {
+
+    BOOST_CHECK_THROW(GQCP::AOIntegralCache ("/this/directory/does/not/exist"), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::AOIntegralCache ("/tmp", 0.0), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( key ) {
+
+    GQCP::AOIntegralCache cache ("/tmp", 1.0e-06);
+
+    GQCP::Molecule h2 ({GQCP::Atom(1, 0.0, 0.0, 0.0), GQCP::Atom(1, 0.0, 0.0, 1.4)});
+    GQCP::Molecule h2_noise ({GQCP::Atom(1, 0.0, 0.0, 1.0e-10), GQCP::Atom(1, 0.0, 0.0, 1.4 - 1.0e-10)});
+    GQCP::Molecule h2_cation ({GQCP::Atom(1, 0.0, 0.0, 0.0), GQCP::Atom(1, 0.0, 0.0, 1.4)}, +1);
+    GQCP::Molecule h2_stretched ({GQCP::Atom(1, 0.0, 0.0, 0.0), GQCP::Atom(1, 0.0, 0.0, 1.5)});
+
+    // Numerical noise, the charge and the case of the basis set name shouldn't change the key
+    BOOST_CHECK_EQUAL(cache.key(h2, "STO-3G"), cache.key(h2_noise, "STO-3G"));
+    BOOST_CHECK_EQUAL(cache.key(h2, "STO-3G"), cache.key(h2_cation, "sto-3g"));
+
+    // The geometry, basis set and integral options should
+    BOOST_CHECK(cache.key(h2, "STO-3G") != cache.key(h2_stretched, "STO-3G"));
+    BOOST_CHECK(cache.key(h2, "STO-3G") != cache.key(h2, "6-31G"));
+    BOOST_CHECK(cache.key(h2, "STO-3G") != cache.key(h2, "STO-3G", 1.0e-10));
+    BOOST_CHECK_EQUAL(cache.key(h2, "STO-3G"), cache.key(h2, "STO-3G", 0.0));  // the integrals aren't screened by default
+    BOOST_CHECK(cache.filename(cache.key(h2, "STO-3G")) != cache.filename(cache.key(h2, "6-31G")));
+}
+
+
+BOOST_AUTO_TEST_CASE ( write_read ) {
+
+    GQCP::AOIntegralCache cache (createTemporaryDirectory());
+
+    size_t K = 4;
+    GQCP::AOIntegrals integrals;
+    integrals.S = GQCP::OneElectronOperator<double>::Random(K, K);
+    integrals.T = GQCP::OneElectronOperator<double>::Random(K, K);
+    integrals.V = GQCP::OneElectronOperator<double>::Random(K, K);
+    integrals.g = GQCP::PackedTwoElectronOperator(K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    integrals.g(p,q,r,s) = 1.0 + p + 2*q + 3*r + 5*s;  // the last write of symmetry-related integrals wins
+                }
+            }
+        }
+    }
+
+
+    // Keys of different lengths check the alignment of the stored integrals
+    for (const std::string key : {"a", "a key of a different length"}) {
+        BOOST_CHECK(!cache.contains(key));
+        BOOST_CHECK_THROW(cache.read(key), std::runtime_error);
+
+        cache.write(key, integrals);
+        BOOST_CHECK(cache.contains(key));
+
+        auto read_integrals = cache.read(key);
+        BOOST_CHECK(read_integrals.S.isApprox(integrals.S));
+        BOOST_CHECK(read_integrals.T.isApprox(integrals.T));
+        BOOST_CHECK(read_integrals.V.isApprox(integrals.V));
+        BOOST_CHECK(read_integrals.g.get_data() == integrals.g.get_data());
+
+        std::remove(cache.filename(key).c_str());
+    }
+
+
+    // A corrupt file shouldn't be read
+    std::ofstream corrupt_file (cache.filename("corrupt"), std::ios::binary);
+    corrupt_file << "GQCPAOI1 this is not a valid file";
+    corrupt_file.close();
+    BOOST_CHECK(!cache.contains("corrupt"));
+    BOOST_CHECK_THROW(cache.read("corrupt"), std::runtime_error);
+    std::remove(cache.filename("corrupt").c_str());
+    rmdir(cache.get_directory().c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE ( molecularHamiltonianParameters_h2o ) {
+
+    // The cached Hamiltonian parameters should be equal to the calculated ones, both on the first (calculating) and the second (reading) run
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    auto ref_ham_par = GQCP::HamiltonianParameters<double>::Molecular(water, "STO-3G");
+
+    GQCP::AOIntegralCache cache (createTemporaryDirectory());
+    BOOST_CHECK(!cache.contains(cache.key(water, "STO-3G")));
+
+    for (size_t run = 0; run < 2; run++) {
+        auto ham_par = cache.molecularHamiltonianParameters(water, "STO-3G");
+        BOOST_CHECK(cache.contains(cache.key(water, "STO-3G")));
+
+        BOOST_CHECK(ham_par.get_S().isApprox(ref_ham_par.get_S(), 1.0e-12));
+        BOOST_CHECK(ham_par.get_h().isApprox(ref_ham_par.get_h(), 1.0e-12));
+        BOOST_CHECK(ham_par.get_g().isApprox(ref_ham_par.get_g(), 1.0e-12));
+        BOOST_CHECK(std::abs(ham_par.get_scalar() - ref_ham_par.get_scalar()) < 1.0e-12);
+    }
+
+    std::remove(cache.filename(cache.key(water, "STO-3G")).c_str());
+    rmdir(cache.get_directory().c_str());
+}
@@ -0,0 +1,139 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "FCIDUMP"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+#include "HamiltonianParameters/FCIDUMP.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+
+BOOST_AUTO_TEST_CASE ( parseFCIDUMPDouble ) {
+
+    // Check C and Fortran notations against std::strtod
+    std::vector<std::string> numbers {"2.2799043576763789e+00", "-1.2345678901234567E-05", "0.6589928924251115E+00", "-5.53204D-16", "  +3.25d2", "42", "-0.0", "1.5e-300", "1.0000000000000000000001", ".5"};
+    for (const auto& number : numbers) {
+        const char* position = number.data();
+        double value;
+        BOOST_REQUIRE(GQCP::parseFCIDUMPDouble(position, number.data() + number.size(), value));
+        BOOST_CHECK(position == number.data() + number.size());
+
+        std::string c_number = number;
+        std::replace(c_number.begin(), c_number.end(), 'D', 'e');
+        std::replace(c_number.begin(), c_number.end(), 'd', 'e');
+        double ref_value = std::strtod(c_number.c_str(), nullptr);
+        BOOST_CHECK(std::abs(value - ref_value) <= 2.0e-16 * std::abs(ref_value));
+    }
+
+    // A letter that doesn't start an exponent should be left alone
+    std::string number_and_word = "1.5 e";
+    const char* position = number_and_word.data();
+    double value;
+    BOOST_CHECK(GQCP::parseFCIDUMPDouble(position, number_and_word.data() + number_and_word.size(), value));
+    BOOST_CHECK(std::abs(value - 1.5) < 1.0e-16);
+    BOOST_CHECK(*position == ' ');
+
+    std::string word = "  x";
+    position = word.data();
+    BOOST_CHECK(!GQCP::parseFCIDUMPDouble(position, word.data() + word.size(), value));
+    BOOST_CHECK(position == word.data());
+}
+
+
+BOOST_AUTO_TEST_CASE ( readFCIDUMP_threads ) {
+
+    // The parallel blocks should give exactly the same integrals as one block
+    for (const std::string filename : {"data/beh_cation_631g_caitlin.FCIDUMP", "data/h2o_631g_klaas.FCIDUMP"}) {
+        auto ref_integrals = GQCP::readFCIDUMP(filename, 1);
+
+        for (size_t number_of_threads : {2, 7, 64}) {
+            auto integrals = GQCP::readFCIDUMP(filename, number_of_threads);
+            BOOST_CHECK(integrals.h.isApprox(ref_integrals.h, 0.0));
+            BOOST_CHECK(integrals.g.get_data() == ref_integrals.g.get_data());
+            BOOST_CHECK_EQUAL(integrals.scalar, ref_integrals.scalar);
+        }
+    }
+
+    BOOST_CHECK_THROW(GQCP::readFCIDUMP("this_file_does_not_exist.FCIDUMP"), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_CASE ( readFCIDUMP_duplicates ) {
+
+    // Write an FCIDUMP file with a $END header that lists symmetry-equivalent integrals more than once, in enough lines to be split over several blocks
+    std::string filename = "/tmp/gqcp_duplicates_test.FCIDUMP";
+    std::ofstream file (filename);
+    file << " $FCI NORB=2,NELEC=2,MS2=0,\n  ORBSYM=1,1,\n  ISYM=1,\n $END\n";
+    for (size_t repetition = 0; repetition < 1000; repetition++) {
+        file << "  0.1 2 1 1 1\n  0.1 1 1 2 1\n  0.1 1 2 1 1\n";
+    }
+    file << "  0.5 1 1 1 1\n  0.3 2 1 2 1\n  0.4 2 2 1 1\n  0.7 2 2 2 2\n";
+    file << "  0.2 1 1 2 1\n";  // the last listed value is the one that is kept
+    file << " -1.0 1 1 0 0\n -0.2 2 1 0 0\n -0.8 2 2 0 0\n  1.5 0 0 0 0\n";
+    file.close();
+
+
+    auto ref_integrals = GQCP::readFCIDUMP(filename, 1);
+    BOOST_CHECK_EQUAL(ref_integrals.g(1,0,0,0), 0.2);
+    BOOST_CHECK_EQUAL(ref_integrals.g(0,0,0,1), 0.2);
+    BOOST_CHECK_EQUAL(ref_integrals.g(1,1,0,0), 0.4);
+    BOOST_CHECK_EQUAL(ref_integrals.h(0,1), -0.2);
+    BOOST_CHECK_EQUAL(ref_integrals.scalar, 1.5);
+
+    for (size_t number_of_threads : {2, 7, 64}) {
+        auto integrals = GQCP::readFCIDUMP(filename, number_of_threads);
+        BOOST_CHECK(integrals.h.isApprox(ref_integrals.h, 0.0));
+        BOOST_CHECK(integrals.g.get_data() == ref_integrals.g.get_data());
+        BOOST_CHECK_EQUAL(integrals.scalar, ref_integrals.scalar);
+    }
+
+    std::remove(filename.c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE ( binary_FCIDUMP ) {
+
+    // A binary FCIDUMP file should reproduce the Hamiltonian parameters exactly
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_631g_klaas.FCIDUMP");
+    std::string filename = "/tmp/gqcp_binary_fcidump_test.bin";
+    ham_par.writeBinaryFCIDUMP(filename);
+
+    auto binary_ham_par = GQCP::HamiltonianParameters<double>::ReadBinaryFCIDUMP(filename);
+    BOOST_CHECK(binary_ham_par.get_h().isApprox(ham_par.get_h(), 0.0));
+    BOOST_CHECK(binary_ham_par.get_g().isApprox(ham_par.get_g(), 0.0));
+    BOOST_CHECK_EQUAL(binary_ham_par.get_scalar(), ham_par.get_scalar());
+    std::remove(filename.c_str());
+
+
+    // A text FCIDUMP file isn't a valid binary FCIDUMP file
+    BOOST_CHECK_THROW(GQCP::readBinaryFCIDUMP("data/h2o_631g_klaas.FCIDUMP"), std::invalid_argument);
+
+
+    // Hamiltonian parameters in a non-orthonormal basis can't be written
+    auto non_orthonormal_ham_par = GQCP::HamiltonianParameters<double>::Random(3);
+    GQCP::SquareMatrix<double> T = GQCP::SquareMatrix<double>::Random(3, 3);
+    non_orthonormal_ham_par.transform(T);
+    BOOST_CHECK_THROW(non_orthonormal_ham_par.writeBinaryFCIDUMP(filename), std::invalid_argument);
+}
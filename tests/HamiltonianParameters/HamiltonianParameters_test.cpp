@@ -192,6 +192,32 @@ BOOST_AUTO_TEST_CASE ( rotate_overlap_matrix ) {
 }
 
 
+BOOST_AUTO_TEST_CASE ( rotate_JacobiRotationParameters ) {
+
+    // Check if the in-place Jacobi rotation gives the same Hamiltonian parameters as the rotation with the corresponding Jacobi rotation matrix
+    size_t K = 5;
+    GQCP::OneElectronOperator<double> S = GQCP::OneElectronOperator<double>::Random(K, K);
+    GQCP::OneElectronOperator<double> H = GQCP::OneElectronOperator<double>::Random(K, K);
+    GQCP::TwoElectronOperator<double> g (K);
+    g.setRandom();
+    GQCP::SquareMatrix<double> T = GQCP::SquareMatrix<double>::Random(K, K);
+
+    GQCP::JacobiRotationParameters jacobi_rotation_parameters (3, 1, 0.73);
+    auto J = GQCP::SquareMatrix<double>::FromJacobi(jacobi_rotation_parameters, K);
+
+    GQCP::HamiltonianParameters<double> ham_par_jacobi (nullptr, S, H, g, T);
+    ham_par_jacobi.rotate(jacobi_rotation_parameters);
+
+    GQCP::HamiltonianParameters<double> ham_par (nullptr, S, H, g, T);
+    ham_par.rotate(GQCP::SquareMatrix<double>(J));
+
+    BOOST_CHECK(ham_par_jacobi.get_S().isApprox(ham_par.get_S(), 1.0e-12));
+    BOOST_CHECK(ham_par_jacobi.get_h().isApprox(ham_par.get_h(), 1.0e-12));
+    BOOST_CHECK(ham_par_jacobi.get_g().isApprox(ham_par.get_g(), 1.0e-12));
+    BOOST_CHECK(ham_par_jacobi.get_T_total().isApprox(ham_par.get_T_total(), 1.0e-12));
+}
+
+
 BOOST_AUTO_TEST_CASE ( constructor_C ) {
 
     // Create dummy Hamiltonian parameters
@@ -493,3 +519,145 @@ BOOST_AUTO_TEST_CASE ( areOrbitalsOrthonormal ) {
     auto mol_ham_par = GQCP::HamiltonianParameters<double>(ao_ham_par, rhf.get_C());
     BOOST_CHECK(mol_ham_par.areOrbitalsOrthonormal());
 }
+
+
+BOOST_AUTO_TEST_CASE ( copy_on_write_two_electron_integrals ) {
+
+    auto ham_par = GQCP::HamiltonianParameters<double>::Random(4);
+    const auto number_of_deep_copies = GQCP::BaseHamiltonianParameters::get_number_of_deep_copies();
+
+
+    // Copying Hamiltonian parameters or constraining their one-electron part should share the two-electron integrals
+    auto ham_par_copy = ham_par;
+    auto ham_par_constrained = ham_par.constrain(GQCP::OneElectronOperator<double>::Identity(4, 4), 1.0);
+    BOOST_CHECK(GQCP::BaseHamiltonianParameters::get_number_of_deep_copies() == number_of_deep_copies);
+    BOOST_CHECK(&ham_par_copy.get_g() == &ham_par.get_g());
+    BOOST_CHECK(&ham_par_constrained.get_g() == &ham_par.get_g());
+
+
+    // Transforming a copy should deep-copy the shared two-electron integrals exactly once, and leave the original ones unchanged
+    GQCP::TwoElectronOperator<double> g_ref = ham_par.get_g();
+    GQCP::SquareMatrix<double> U = GQCP::SquareMatrix<double>::Random(4, 4);
+    ham_par_copy.transform(U);
+    BOOST_CHECK(GQCP::BaseHamiltonianParameters::get_number_of_deep_copies() == number_of_deep_copies + 1);
+    BOOST_CHECK(ham_par.get_g().isApprox(g_ref, 1.0e-12));
+
+
+    // Transforming Hamiltonian parameters whose two-electron integrals aren't shared anymore shouldn't deep-copy
+    ham_par_copy.transform(U);
+    BOOST_CHECK(GQCP::BaseHamiltonianParameters::get_number_of_deep_copies() == number_of_deep_copies + 1);
+}
+
+
+BOOST_AUTO_TEST_CASE ( constrain_scalar ) {
+
+    // All constrained Hamiltonian parameters should be built in the same way, i.e. without the scalar term
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    auto K = ham_par.get_K();
+    BOOST_REQUIRE(std::abs(ham_par.get_scalar()) > 1.0);
+
+    GQCP::OneElectronOperator<double> one_op = GQCP::OneElectronOperator<double>::Identity(K, K);
+    GQCP::TwoElectronOperator<double> two_op (K);
+    two_op.setZero();
+
+    BOOST_CHECK_EQUAL(ham_par.constrain(one_op, 1.0).get_scalar(), 0.0);
+    BOOST_CHECK_EQUAL(ham_par.constrain(two_op, 1.0).get_scalar(), 0.0);
+    BOOST_CHECK_EQUAL(ham_par.constrain(one_op, two_op, 1.0).get_scalar(), 0.0);
+}
+
+
+BOOST_AUTO_TEST_CASE ( memoized_derived_quantities ) {
+
+    const size_t K = 5;
+    auto ham_par = GQCP::HamiltonianParameters<double>::Random(K);
+    const auto& g = ham_par.get_g();
+
+
+    // Check the memoized quantities against a manual calculation, before and after a transformation that invalidates them
+    for (size_t iteration = 0; iteration < 2; iteration++) {
+
+        GQCP::OneElectronOperator<double> k_ref = ham_par.get_h();
+        GQCP::SquareMatrix<double> J_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+        GQCP::SquareMatrix<double> K_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+        for (size_t p = 0; p < K; p++) {
+            for (size_t q = 0; q < K; q++) {
+                J_ref(p,q) = g(p,p,q,q);
+                K_ref(p,q) = g(p,q,q,p);
+                for (size_t r = 0; r < K; r++) {
+                    k_ref(p,q) -= 0.5 * g(p,r,r,q);
+                }
+            }
+        }
+
+        for (size_t call = 0; call < 2; call++) {  // the second call uses the memoized quantities
+            BOOST_CHECK(k_ref.isApprox(ham_par.calculateEffectiveOneElectronIntegrals(), 1.0e-12));
+            BOOST_CHECK(J_ref.isApprox(ham_par.calculateCoulombDiagonal(), 1.0e-12));
+            BOOST_CHECK(K_ref.isApprox(ham_par.calculateExchangeDiagonal(), 1.0e-12));
+            BOOST_CHECK(std::abs(ham_par.calculateEdmistonRuedenbergLocalizationIndex(2) - (g(0,0,0,0) + g(1,1,1,1))) < 1.0e-12);
+        }
+
+        ham_par.randomRotate();
+    }
+
+
+    // A copy with constrained one-electron integrals shouldn't use the memoized quantities of the original ones
+    auto k = ham_par.calculateEffectiveOneElectronIntegrals();
+    auto ham_par_constrained = ham_par.constrain(GQCP::OneElectronOperator<double>::Identity(K, K), 1.0);
+    BOOST_CHECK(ham_par_constrained.calculateEffectiveOneElectronIntegrals().isApprox(k - GQCP::OneElectronOperator<double>::Identity(K, K), 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( calculate_generalized_Fock_matrix_and_super_random ) {
+
+    // Check the matrix-matrix product implementations against the defining formulas, for integrals and RDMs without any symmetry
+    const size_t K = 5;
+    auto ham_par = GQCP::HamiltonianParameters<double>::Random(K);
+    const auto& h = ham_par.get_h();
+    const auto& g = ham_par.get_g();
+
+    GQCP::OneRDM<double> D = GQCP::OneRDM<double>::Random(K, K);
+    GQCP::TwoRDM<double> d (K);
+    d.setRandom();
+
+
+    GQCP::OneElectronOperator<double> F_ref = GQCP::OneElectronOperator<double>::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                F_ref(p,q) += h(q,r) * D(p,r);
+                for (size_t s = 0; s < K; s++) {
+                    for (size_t t = 0; t < K; t++) {
+                        F_ref(p,q) += g(q,r,s,t) * d(p,r,s,t);
+                    }
+                }
+            }
+        }
+    }
+
+    GQCP::TwoElectronOperator<double> W_ref (K);
+    W_ref.setZero();
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    if (r == q) {
+                        W_ref(p,q,r,s) += F_ref(p,s);
+                    }
+                    W_ref(p,q,r,s) -= h(s,p) * D(r,q);
+
+                    for (size_t t = 0; t < K; t++) {
+                        for (size_t u = 0; u < K; u++) {
+                            W_ref(p,q,r,s) += g(s,t,q,u) * d(r,t,p,u) - g(s,t,u,p) * d(r,t,u,q) - g(s,p,t,u) * d(r,q,t,u);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+    for (size_t number_of_threads : {1, 3}) {
+        BOOST_CHECK(F_ref.isApprox(ham_par.calculateGeneralizedFockMatrix(D, d, number_of_threads), 1.0e-12));
+        BOOST_CHECK(W_ref.isApprox(ham_par.calculateSuperGeneralizedFockMatrix(D, d, number_of_threads), 1.0e-12));
+    }
+}
@@ -27,8 +27,59 @@
 #include "HamiltonianBuilder/DOCI.hpp"
 #include "RHF/PlainRHFSCFSolver.hpp"
 #include "RDM/FCIRDMBuilder.hpp"
+#include "RDM/RDMCalculator.hpp"
 #include "CISolver/CISolver.hpp"
 
+
+/**
+ *  The DOCI RDMs for H2O//STO-3G, together with the corresponding generalized Fock matrix and the dense orbital Hessian
+ */
+struct OrbitalHessianH2OSTO3G {
+    GQCP::OneRDM<double> D;
+    GQCP::TwoRDM<double> d;
+    GQCP::OneElectronOperator<double> F;
+    GQCP::SquareMatrix<double> hessian_matrix;  // with only the free parameters
+};
+
+
+/**
+ *  @param ham_par      the Hamiltonian parameters for H2O//STO-3G
+ *
+ *  @return the DOCI RDMs, the generalized Fock matrix and the dense orbital Hessian that is built from the super-generalized Fock matrix
+ */
+OrbitalHessianH2OSTO3G calculateOrbitalHessianH2OSTO3G(const GQCP::HamiltonianParameters<double>& ham_par) {
+
+    auto K = ham_par.get_K();
+
+    GQCP::FockSpace fock_space (K, 5);  // dim = 21
+    GQCP::DOCI doci (fock_space);
+    GQCP::CISolver doci_solver (doci, ham_par);
+    GQCP::DenseSolverOptions solver_options;
+    doci_solver.solve(solver_options);
+
+    GQCP::RDMCalculator rdm_calculator (fock_space);
+    rdm_calculator.set_coefficients(doci_solver.get_eigenpair().get_eigenvector());
+    auto D = rdm_calculator.calculate1RDMs().one_rdm;
+    auto d = rdm_calculator.calculate2RDMs().two_rdm;
+    auto F = ham_par.calculateGeneralizedFockMatrix(D, d);
+
+
+    auto W = ham_par.calculateSuperGeneralizedFockMatrix(D, d);
+    GQCP::SquareRankFourTensor<double> hessian_tensor (K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    hessian_tensor(p,q,r,s) = W(p,q,r,s) - W(p,q,s,r) + W(q,p,s,r) - W(q,p,r,s) + W(r,s,p,q) - W(r,s,q,p) + W(s,r,q,p) - W(s,r,p,q);
+                }
+            }
+        }
+    }
+
+    return OrbitalHessianH2OSTO3G {D, d, F, hessian_tensor.pairWiseStrictReduce()};
+}
+
+
 // dim = 2 for DOCI
 BOOST_AUTO_TEST_CASE ( OO_DOCI_h2_sto_3g ) {
 
@@ -221,3 +272,78 @@ BOOST_AUTO_TEST_CASE ( OO_DOCI_h2_6_31gxx_Davidson ) {
     double OO_DOCI_energy = OO_DOCI_eigenvalue + internuclear_repulsion_energy;
     BOOST_CHECK(std::abs(OO_DOCI_energy - reference_fci_energy) < 1.0e-08);
 }
+
+
+BOOST_AUTO_TEST_CASE ( orbital_Hessian_vector_product_h2o_sto3g ) {
+
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    auto K = ham_par.get_K();
+    auto h2o = calculateOrbitalHessianH2OSTO3G(ham_par);
+
+
+    // Check the matrix-free Hessian-vector product
+    GQCP::VectorX<double> kappa_vector = GQCP::VectorX<double>::Random(K*(K-1)/2);
+    auto kappa_matrix = GQCP::SquareMatrix<double>::FromStrictTriangle(kappa_vector);
+    GQCP::SquareMatrix<double> kappa_matrix_transpose = kappa_matrix.transpose();
+    kappa_matrix -= kappa_matrix_transpose;
+
+    GQCP::VectorX<double> sigma = ham_par.calculateOrbitalHessianVectorProduct(h2o.D, h2o.d, h2o.F, kappa_matrix).strictLowerTriangle();
+    BOOST_CHECK(sigma.isApprox(h2o.hessian_matrix * kappa_vector, 1.0e-10));
+}
+
+
+BOOST_AUTO_TEST_CASE ( OO_DOCI_h2o_sto3g_trust_region ) {
+
+    // Check if the trust-region Newton steps lead to the same OO-DOCI energy as the dense Newton steps
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    auto K = ham_par.get_K();
+
+    GQCP::FockSpace fock_space (K, 5);  // dim = 21
+    GQCP::DOCI doci (fock_space);
+    GQCP::DenseSolverOptions solver_options;
+
+    GQCP::DOCINewtonOrbitalOptimizer newton_optimizer (doci, ham_par);
+    newton_optimizer.solve(solver_options);
+
+    GQCP::OrbitalOptimizationOptions oo_options;
+    oo_options.step_type = GQCP::OrbitalOptimizationStep::TRUST_REGION_NEWTON;
+    GQCP::DOCINewtonOrbitalOptimizer trust_region_optimizer (doci, ham_par);
+    trust_region_optimizer.solve(solver_options, oo_options);
+
+    BOOST_CHECK(std::abs(trust_region_optimizer.get_eigenpair().get_eigenvalue() - newton_optimizer.get_eigenpair().get_eigenvalue()) < 1.0e-08);
+}
+
+
+BOOST_AUTO_TEST_CASE ( orbital_Hessian_diagonal_h2o_sto3g ) {
+
+    // Check the diagonal with the one of the dense orbital Hessian
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    auto h2o = calculateOrbitalHessianH2OSTO3G(ham_par);
+
+    GQCP::VectorX<double> ref_diagonal = h2o.hessian_matrix.diagonal();
+    BOOST_CHECK(ham_par.calculateOrbitalHessianDiagonal(h2o.D, h2o.d, h2o.F).isApprox(ref_diagonal, 1.0e-10));
+}
+
+
+BOOST_AUTO_TEST_CASE ( OO_DOCI_h2o_sto3g_quasi_newton ) {
+
+    // Check if the diagonal-Hessian and L-BFGS steps lead to the same OO-DOCI energy as the dense Newton steps
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_sto3g_klaas.FCIDUMP");
+    auto K = ham_par.get_K();
+
+    GQCP::FockSpace fock_space (K, 5);  // dim = 21
+    GQCP::DOCI doci (fock_space);
+    GQCP::DenseSolverOptions solver_options;
+
+    GQCP::DOCINewtonOrbitalOptimizer newton_optimizer (doci, ham_par);
+    newton_optimizer.solve(solver_options);
+
+    for (const auto& step_type : {GQCP::OrbitalOptimizationStep::DIAGONAL_HESSIAN, GQCP::OrbitalOptimizationStep::L_BFGS}) {
+        GQCP::OrbitalOptimizationOptions oo_options;
+        oo_options.step_type = step_type;
+        GQCP::DOCINewtonOrbitalOptimizer quasi_newton_optimizer (doci, ham_par);
+        quasi_newton_optimizer.solve(solver_options, oo_options);
+
+        BOOST_CHECK(std::abs(quasi_newton_optimizer.get_eigenpair().get_eigenvalue() - newton_optimizer.get_eigenpair().get_eigenvalue()) < 1.0e-08);
+    }
+}
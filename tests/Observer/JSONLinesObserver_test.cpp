@@ -0,0 +1,84 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "JSONLinesObserver"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+#include "Observer/JSONLinesObserver.hpp"
+
+#include <limits>
+#include <sstream>
+
+
+
+BOOST_AUTO_TEST_CASE ( toJSON ) {
+
+    GQCP::IterationRecord record;
+    record.solver = "DavidsonSolver";
+    record.iteration = 3;
+    record.residual_norms = {0.5, 0.25};
+    record.eigenvalues = {-1.0, std::numeric_limits<double>::quiet_NaN()};
+    record.subspace_dimension = 7;
+    record.collapsed = true;
+    record.number_of_matvecs = 2;
+    record.matvec_time = 1.5;
+    record.subspace_time = 0.25;
+    record.allocated_bytes = 1024;
+    record.number_of_computed_quartets = 10;
+    record.number_of_skipped_quartets = 5;
+
+    std::string ref_json = "{\"solver\":\"DavidsonSolver\",\"iteration\":3,\"residual_norms\":[0.5,0.25],\"eigenvalues\":[-1,null],\"subspace_dimension\":7,\"collapsed\":true,\"number_of_matvecs\":2,\"matvec_time\":1.5,\"subspace_time\":0.25,\"allocated_bytes\":1024,\"number_of_computed_quartets\":10,\"number_of_skipped_quartets\":5}";
+    BOOST_CHECK_EQUAL(GQCP::JSONLinesObserver::toJSON(record), ref_json);
+
+
+    // Special characters in the solver name should be escaped
+    record.solver = "a\"b\\c\n";
+    BOOST_CHECK(GQCP::JSONLinesObserver::toJSON(record).find("\"solver\":\"a\\\"b\\\\c\\u000a\"") != std::string::npos);
+}
+
+
+BOOST_AUTO_TEST_CASE ( update ) {
+
+    std::ostringstream output;
+    GQCP::JSONLinesObserver observer (output);
+
+    GQCP::IterationRecord record;
+    record.solver = "RHFSCFSolver";
+    observer.update(record);
+    record.iteration = 1;
+    observer.update(record);
+
+    // Every record should be written on its own line
+    std::istringstream lines (output.str());
+    std::string line;
+    size_t number_of_lines = 0;
+    while (std::getline(lines, line)) {
+        BOOST_CHECK(line.front() == '{');
+        BOOST_CHECK(line.back() == '}');
+        number_of_lines++;
+    }
+    BOOST_CHECK_EQUAL(number_of_lines, 2);
+}
+
+
+BOOST_AUTO_TEST_CASE ( constructor_throws ) {
+
+    BOOST_CHECK_THROW(GQCP::JSONLinesObserver ("/this/directory/does/not/exist/log.jsonl"), std::runtime_error);
+}
@@ -0,0 +1,220 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "FactorizedTwoElectronOperator"
+
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+#include "Operator/FactorizedTwoElectronOperator.hpp"
+
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+
+
+/**
+ *  @param K            the number of orbitals
+ *  @param N            the number of factor matrices
+ *
+ *  @return a factorized operator with random symmetric factor matrices
+ */
+GQCP::FactorizedTwoElectronOperator randomFactorizedOperator(size_t K, size_t N) {
+
+    GQCP::MatrixX<double> B (K*K, N);
+    for (size_t P = 0; P < N; P++) {
+        GQCP::SquareMatrix<double> B_P = GQCP::SquareMatrix<double>::Random(K, K);
+        B_P = B_P + B_P.transpose().eval();
+        B.col(P) = Eigen::Map<Eigen::VectorXd>(B_P.data(), K*K);
+    }
+
+    return GQCP::FactorizedTwoElectronOperator(K, B);
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_constructor ) {
+
+    GQCP::MatrixX<double> B = GQCP::MatrixX<double>::Random(9, 4);
+    GQCP::FactorizedTwoElectronOperator g (3, B);
+    BOOST_CHECK_EQUAL(g.get_number_of_vectors(), 4);
+
+    BOOST_CHECK_THROW(GQCP::FactorizedTwoElectronOperator g_faulty (4, B), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_elements ) {
+
+    size_t K = 4;
+    auto g = randomFactorizedOperator(K, 7);
+    auto g_dense = g.toDense();
+
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    double reference = 0.0;
+                    for (size_t P = 0; P < g.get_number_of_vectors(); P++) {
+                        reference += g.factor(P)(p, q) * g.factor(P)(r, s);
+                    }
+
+                    BOOST_CHECK(std::abs(g(p, q, r, s) - reference) < 1.0e-12);
+                    BOOST_CHECK(std::abs(g_dense(p, q, r, s) - reference) < 1.0e-12);
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_DensityFitted ) {
+
+    // If the orbital products lie in the span of the auxiliary functions, density fitting is exact: take (pq|Q) = sum_R C(pq,R) (R|Q)
+    size_t K = 3;
+    size_t N_aux = 12;
+
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Random(N_aux, N_aux);
+    GQCP::SquareMatrix<double> V = A * A.transpose() + N_aux * GQCP::SquareMatrix<double>::Identity(N_aux, N_aux);  // positive definite
+
+    GQCP::MatrixX<double> C = randomFactorizedOperator(K, N_aux).get_B();
+    GQCP::MatrixX<double> three_center_integrals = C * V;
+
+    auto g = GQCP::FactorizedTwoElectronOperator::DensityFitted(three_center_integrals, V);
+    Eigen::MatrixXd G_ref = C * V * C.transpose();  // (pq|rs) = (pq|R) (R|Q)^-1 (Q|rs)
+
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    BOOST_CHECK(std::abs(g(p, q, r, s) - G_ref(p + K*q, r + K*s)) < 1.0e-10);
+                }
+            }
+        }
+    }
+
+
+    // Linearly dependent auxiliary functions are discarded
+    GQCP::SquareMatrix<double> V_singular = GQCP::SquareMatrix<double>::Zero(N_aux, N_aux);
+    V_singular.topLeftCorner(N_aux-2, N_aux-2) = V.topLeftCorner(N_aux-2, N_aux-2);
+    auto g_reduced = GQCP::FactorizedTwoElectronOperator::DensityFitted(three_center_integrals, V_singular);
+    BOOST_CHECK_EQUAL(g_reduced.get_number_of_vectors(), N_aux-2);
+
+    BOOST_CHECK_THROW(GQCP::FactorizedTwoElectronOperator::DensityFitted(three_center_integrals, GQCP::SquareMatrix<double>::Identity(N_aux+1, N_aux+1)), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_transform ) {
+
+    size_t K = 4;
+    auto g = randomFactorizedOperator(K, 5);
+    auto g_dense = g.toDense();
+
+    GQCP::SquareMatrix<double> T = GQCP::SquareMatrix<double>::Random(K, K);
+    g.transform(T);
+    g_dense.transform(T);
+    BOOST_CHECK(g.toDense().isApprox(g_dense, 1.0e-12));
+
+
+    // A Jacobi rotation should be equal to the transformation with the corresponding Jacobi rotation matrix
+    GQCP::JacobiRotationParameters jacobi_rotation_parameters (3, 1, 0.7);
+    g.rotate(jacobi_rotation_parameters);
+    g_dense.rotate(jacobi_rotation_parameters);
+    BOOST_CHECK(g.toDense().isApprox(g_dense, 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_slices_Coulomb_exchange ) {
+
+    size_t K = 5;
+    auto g = randomFactorizedOperator(K, 6);
+    auto g_dense = g.toDense();
+    GQCP::SquareMatrix<double> D = GQCP::SquareMatrix<double>::Random(K, K);
+
+    GQCP::SquareMatrix<double> J_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+    GQCP::SquareMatrix<double> K_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    J_ref(p, q) += g_dense(p, q, r, s) * D(s, r);
+                    K_ref(p, q) += g_dense(p, r, s, q) * D(r, s);
+                }
+            }
+        }
+    }
+    BOOST_CHECK(g.calculateCoulomb(D).isApprox(J_ref, 1.0e-12));
+    BOOST_CHECK(g.calculateExchange(D).isApprox(K_ref, 1.0e-12));
+
+    auto J_slice = g.coulombSlice(1, 3);
+    auto K_slice = g.exchangeSlice(1, 3);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            BOOST_CHECK(std::abs(J_slice(p, q) - g_dense(p, q, 1, 3)) < 1.0e-12);
+            BOOST_CHECK(std::abs(K_slice(p, q) - g_dense(p, 1, q, 3)) < 1.0e-12);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_PivotedCholesky ) {
+
+    // A decomposition of low-rank integrals should recover the rank and only need one column per Cholesky vector
+    size_t K = 5;
+    size_t rank = 7;
+    auto g_low_rank = randomFactorizedOperator(K, rank);
+    Eigen::MatrixXd G = g_low_rank.get_B() * g_low_rank.get_B().transpose();
+
+    size_t number_of_columns = 0;
+    auto calculateColumn = [&G, &number_of_columns] (size_t pq) {
+        number_of_columns++;
+        return GQCP::VectorX<double>(G.col(pq));
+    };
+
+    auto g = GQCP::FactorizedTwoElectronOperator::PivotedCholesky(G.diagonal(), calculateColumn, 1.0e-10);
+    BOOST_CHECK_EQUAL(g.get_number_of_vectors(), rank);
+    BOOST_CHECK_EQUAL(number_of_columns, rank);
+    BOOST_CHECK(g.toDense().isApprox(g_low_rank.toDense(), 1.0e-08));
+
+
+    // For a full-rank positive definite supermatrix, the error on every element is bounded by the tolerance
+    auto g_full_rank = randomFactorizedOperator(K, 40);
+    Eigen::MatrixXd G_full = g_full_rank.get_B() * g_full_rank.get_B().transpose();
+    double tolerance = 1.0e-03;
+    auto g_truncated = GQCP::FactorizedTwoElectronOperator::PivotedCholesky(G_full.diagonal(), [&G_full] (size_t pq) { return GQCP::VectorX<double>(G_full.col(pq)); }, tolerance);
+    BOOST_CHECK(g_truncated.get_number_of_vectors() <= K*(K+1)/2);  // the supermatrix of symmetric factor matrices has at most K(K+1)/2 nonzero eigenvalues
+
+    Eigen::MatrixXd error = G_full - g_truncated.get_B() * g_truncated.get_B().transpose();
+    BOOST_CHECK(error.cwiseAbs().maxCoeff() <= tolerance);
+
+
+    BOOST_CHECK_THROW(GQCP::FactorizedTwoElectronOperator::PivotedCholesky(GQCP::VectorX<double>::Ones(5), calculateColumn), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( FactorizedTwoElectronOperator_writeFCIDUMP ) {
+
+    // Check if the written FCIDUMP file can be read in again
+    size_t K = 4;
+    auto g = randomFactorizedOperator(K, 6);
+    GQCP::OneElectronOperator<double> h = GQCP::OneElectronOperator<double>::Random(K, K);
+    h = (h + h.transpose()).eval();
+
+    g.writeFCIDUMP("factorized_test.FCIDUMP", h, 1.5, 2);
+    auto ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("factorized_test.FCIDUMP");
+
+    BOOST_CHECK(ham_par.get_h().isApprox(h, 1.0e-12));
+    BOOST_CHECK(ham_par.get_g().isApprox(g.toDense(), 1.0e-12));
+    BOOST_CHECK(std::abs(ham_par.get_scalar() - 1.5) < 1.0e-12);
+}
@@ -0,0 +1,178 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "PackedTwoElectronOperator"
+
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+#include "Operator/PackedTwoElectronOperator.hpp"
+
+
+/**
+ *  @param K            the number of orbitals
+ *
+ *  @return random two-electron integrals with the eight-fold permutational symmetry of real orbitals
+ */
+GQCP::TwoElectronOperator<double> randomSymmetricIntegrals(size_t K) {
+
+    GQCP::TwoElectronOperator<double> g (K);
+    g.setRandom();
+
+    return GQCP::PackedTwoElectronOperator::FromDense(g).toDense();
+}
+
+
+BOOST_AUTO_TEST_CASE ( PackedTwoElectronOperator_constructor ) {
+
+    size_t K = 5;
+    size_t number_of_pairs = K * (K + 1) / 2;
+
+    GQCP::PackedTwoElectronOperator g8 (K);
+    BOOST_CHECK_EQUAL(g8.size(), number_of_pairs * (number_of_pairs + 1) / 2);
+    BOOST_CHECK_EQUAL(g8.get_K(), K);
+
+    GQCP::PackedTwoElectronOperator g4 (K, GQCP::PackedSymmetry::FOURFOLD);
+    BOOST_CHECK_EQUAL(g4.size(), number_of_pairs * number_of_pairs);
+
+    for (const auto& value : g8.get_data()) {
+        BOOST_CHECK(value == 0.0);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( PackedTwoElectronOperator_symmetric_access ) {
+
+    GQCP::PackedTwoElectronOperator g (4);
+    g(3,1,0,2) = 1.5;
+
+    // All eight symmetry-related integrals share the same storage
+    BOOST_CHECK(g(3,1,0,2) == 1.5);
+    BOOST_CHECK(g(1,3,0,2) == 1.5);
+    BOOST_CHECK(g(3,1,2,0) == 1.5);
+    BOOST_CHECK(g(1,3,2,0) == 1.5);
+    BOOST_CHECK(g(0,2,3,1) == 1.5);
+    BOOST_CHECK(g(2,0,3,1) == 1.5);
+    BOOST_CHECK(g(0,2,1,3) == 1.5);
+    BOOST_CHECK(g(2,0,1,3) == 1.5);
+
+    BOOST_CHECK(g(3,0,1,2) == 0.0);
+
+
+    // For four-fold symmetry, the bra and ket pairs can't be interchanged
+    GQCP::PackedTwoElectronOperator g4 (4, GQCP::PackedSymmetry::FOURFOLD);
+    g4(3,1,0,2) = 1.5;
+    BOOST_CHECK(g4(1,3,2,0) == 1.5);
+    BOOST_CHECK(g4(0,2,3,1) == 0.0);
+}
+
+
+BOOST_AUTO_TEST_CASE ( PackedTwoElectronOperator_dense_conversion ) {
+
+    size_t K = 5;
+
+    // Symmetric integrals should survive a round trip through the packed storage
+    auto g = randomSymmetricIntegrals(K);
+    auto packed_g = GQCP::PackedTwoElectronOperator::FromDense(g);
+    BOOST_CHECK(packed_g.toDense().isApprox(g, 1.0e-12));
+
+
+    // Four-fold packing should keep integrals that are only symmetric within the bra and ket pairs
+    GQCP::TwoElectronOperator<double> g4 (K);
+    g4.setRandom();
+    g4 = GQCP::PackedTwoElectronOperator::FromDense(g4, GQCP::PackedSymmetry::FOURFOLD).toDense();
+    auto packed_g4 = GQCP::PackedTwoElectronOperator::FromDense(g4, GQCP::PackedSymmetry::FOURFOLD);
+    BOOST_CHECK(packed_g4.toDense().isApprox(g4, 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( PackedTwoElectronOperator_slices_and_diagonals ) {
+
+    size_t K = 4;
+    auto g = randomSymmetricIntegrals(K);
+    auto packed_g = GQCP::PackedTwoElectronOperator::FromDense(g);
+
+    for (size_t a = 0; a < K; a++) {
+        for (size_t b = 0; b < K; b++) {
+
+            auto J_slice = packed_g.coulombSlice(a, b);
+            auto K_slice = packed_g.exchangeSlice(a, b);
+
+            for (size_t p = 0; p < K; p++) {
+                for (size_t q = 0; q < K; q++) {
+                    BOOST_CHECK(std::abs(J_slice(p, q) - g(p, q, a, b)) < 1.0e-12);
+                    BOOST_CHECK(std::abs(K_slice(p, q) - g(p, a, q, b)) < 1.0e-12);
+                }
+            }
+        }
+    }
+
+    auto J_diagonal = packed_g.coulombDiagonal();
+    auto K_diagonal = packed_g.exchangeDiagonal();
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            BOOST_CHECK(std::abs(J_diagonal(p, q) - g(p, p, q, q)) < 1.0e-12);
+            BOOST_CHECK(std::abs(K_diagonal(p, q) - g(p, q, q, p)) < 1.0e-12);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( PackedTwoElectronOperator_Coulomb_exchange ) {
+
+    size_t K = 6;
+    auto g = randomSymmetricIntegrals(K);
+    GQCP::SquareMatrix<double> D = GQCP::SquareMatrix<double>::Random(K, K);  // the contractions shouldn't rely on a symmetric density matrix
+
+
+    // Calculate the reference Coulomb and exchange matrices from the dense integrals
+    GQCP::SquareMatrix<double> J_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+    GQCP::SquareMatrix<double> K_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    J_ref(p, q) += g(p, q, r, s) * D(s, r);
+                    K_ref(p, q) += g(p, r, s, q) * D(r, s);
+                }
+            }
+        }
+    }
+
+    auto packed_g = GQCP::PackedTwoElectronOperator::FromDense(g);
+    BOOST_CHECK(packed_g.calculateCoulomb(D).isApprox(J_ref, 1.0e-12));
+    BOOST_CHECK(packed_g.calculateExchange(D).isApprox(K_ref, 1.0e-12));
+
+    auto packed_g4 = GQCP::PackedTwoElectronOperator::FromDense(g, GQCP::PackedSymmetry::FOURFOLD);
+    BOOST_CHECK(packed_g4.calculateCoulomb(D).isApprox(J_ref, 1.0e-12));
+    BOOST_CHECK(packed_g4.calculateExchange(D).isApprox(K_ref, 1.0e-12));
+
+    // Check that the result doesn't depend on the number of threads
+    for (size_t number_of_threads : {1, 2, 5}) {
+        BOOST_CHECK(packed_g.calculateCoulomb(D, number_of_threads).isApprox(J_ref, 1.0e-12));
+        BOOST_CHECK(packed_g.calculateExchange(D, number_of_threads).isApprox(K_ref, 1.0e-12));
+        BOOST_CHECK(packed_g4.calculateCoulomb(D, number_of_threads).isApprox(J_ref, 1.0e-12));
+        BOOST_CHECK(packed_g4.calculateExchange(D, number_of_threads).isApprox(K_ref, 1.0e-12));
+    }
+
+
+    // Check that incompatible matrices are rejected
+    GQCP::SquareMatrix<double> D_faulty = GQCP::SquareMatrix<double>::Zero(K+1, K+1);
+    BOOST_CHECK_THROW(packed_g.calculateCoulomb(D_faulty), std::invalid_argument);
+    BOOST_CHECK_THROW(packed_g.calculateExchange(D_faulty), std::invalid_argument);
+}
@@ -82,6 +82,110 @@ BOOST_AUTO_TEST_CASE ( TwoElectronOperator_transform_olsens ) {
 }
 
 
+BOOST_AUTO_TEST_CASE ( TwoElectronOperator_transform_symmetric ) {
+
+    // Check the transformation of two-electron integrals with and without permutational symmetry against the naive transformation formula
+    size_t K = 5;
+    GQCP::SquareMatrix<double> T = GQCP::SquareMatrix<double>::Random(K, K);
+
+    GQCP::TwoElectronOperator<double> g_general (K);
+    g_general.setRandom();
+
+    // The symmetric path is only taken for integrals that are exactly symmetric, so every permutation gets the same value
+    GQCP::TwoElectronOperator<double> g_symmetric (K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s <= r; s++) {
+                    double value = g_general(p,q,r,s) + g_general(q,p,r,s) + g_general(p,q,s,r) + g_general(q,p,s,r);
+
+                    g_symmetric(p,q,r,s) = value;
+                    g_symmetric(q,p,r,s) = value;
+                    g_symmetric(p,q,s,r) = value;
+                    g_symmetric(q,p,s,r) = value;
+                }
+            }
+        }
+    }
+
+    for (const auto& g : {g_general, g_symmetric}) {
+        GQCP::TwoElectronOperator<double> g_transformed_ref (K);
+        g_transformed_ref.setZero();
+        for (size_t P = 0; P < K; P++) {
+            for (size_t Q = 0; Q < K; Q++) {
+                for (size_t R = 0; R < K; R++) {
+                    for (size_t S = 0; S < K; S++) {
+                        for (size_t p = 0; p < K; p++) {
+                            for (size_t q = 0; q < K; q++) {
+                                for (size_t r = 0; r < K; r++) {
+                                    for (size_t s = 0; s < K; s++) {
+                                        g_transformed_ref(P,Q,R,S) += T(p,P) * T(q,Q) * T(r,R) * T(s,S) * g(p,q,r,s);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        auto g_transformed = g;
+        g_transformed.transform(T);
+        BOOST_CHECK(g_transformed.isApprox(g_transformed_ref, 1.0e-12));
+    }
+
+
+    // Check if a non-compatible transformation matrix throws
+    GQCP::SquareMatrix<double> T_faulty = GQCP::SquareMatrix<double>::Identity(K+1, K+1);
+    BOOST_CHECK_THROW(g_general.transform(T_faulty), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( TwoElectronOperator_calculateTransformedBlock ) {
+
+    // Check if the transformed blocks are equal to the corresponding blocks of the fully transformed integrals
+    size_t K = 6;
+    GQCP::SquareMatrix<double> T = GQCP::SquareMatrix<double>::Random(K, K);
+
+    GQCP::TwoElectronOperator<double> g (K);
+    g.setRandom();
+
+    auto g_transformed = g;
+    g_transformed.transform(T);
+
+
+    // Check both a block whose first index is the smallest and one whose fourth index is the smallest
+    std::vector<std::array<size_t, 8>> blocks {{0, 2, 1, 3, 2, 4, 0, 5},  // start and size of every index block
+                                               {1, 5, 0, 6, 3, 2, 4, 1}};
+    for (const auto& b : blocks) {
+        GQCP::MatrixX<double> C1 = T.middleCols(b[0], b[1]);
+        GQCP::MatrixX<double> C2 = T.middleCols(b[2], b[3]);
+        GQCP::MatrixX<double> C3 = T.middleCols(b[4], b[5]);
+        GQCP::MatrixX<double> C4 = T.middleCols(b[6], b[7]);
+
+        auto block = g.calculateTransformedBlock(C1, C2, C3, C4, 2);
+        BOOST_REQUIRE(block.dimension(0) == b[1] && block.dimension(1) == b[3] && block.dimension(2) == b[5] && block.dimension(3) == b[7]);
+
+        double maximum_deviation = 0.0;
+        for (size_t p = 0; p < b[1]; p++) {
+            for (size_t q = 0; q < b[3]; q++) {
+                for (size_t r = 0; r < b[5]; r++) {
+                    for (size_t s = 0; s < b[7]; s++) {
+                        maximum_deviation = std::max(maximum_deviation, std::abs(block(p,q,r,s) - g_transformed(b[0]+p, b[2]+q, b[4]+r, b[6]+s)));
+                    }
+                }
+            }
+        }
+        BOOST_CHECK(maximum_deviation < 1.0e-12);
+    }
+
+
+    // Check if non-compatible coefficient matrices throw
+    GQCP::MatrixX<double> C_faulty = GQCP::MatrixX<double>::Random(K+1, 2);
+    BOOST_CHECK_THROW(g.calculateTransformedBlock(T, T, C_faulty, T), std::invalid_argument);
+}
+
+
 BOOST_AUTO_TEST_CASE ( TwoElectronOperator_rotate_throws ) {
 
     // Create a random TwoElectronOperator
@@ -125,3 +229,45 @@ BOOST_AUTO_TEST_CASE ( TwoElectronOperator_rotate_JacobiRotationParameters ) {
 
     BOOST_CHECK(G1.isApprox(G2, 1.0e-12));
 }
+
+
+BOOST_AUTO_TEST_CASE ( TwoElectronOperator_Coulomb_exchange ) {
+
+    // Compare the matrix-product Coulomb and exchange matrices of several densities with explicit contractions
+    size_t K = 5;
+    GQCP::TwoElectronOperator<double> g (K);
+    g.setRandom();
+
+    std::vector<GQCP::SquareMatrix<double>> D {GQCP::SquareMatrix<double>::Random(K, K), GQCP::SquareMatrix<double>::Random(K, K)};
+
+    for (size_t number_of_threads : {1, 3}) {
+        auto J = g.calculateCoulomb(D, number_of_threads);
+        auto K_matrices = g.calculateExchange(D, number_of_threads);
+
+        for (size_t i = 0; i < D.size(); i++) {
+            GQCP::SquareMatrix<double> J_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+            GQCP::SquareMatrix<double> K_ref = GQCP::SquareMatrix<double>::Zero(K, K);
+            for (size_t p = 0; p < K; p++) {
+                for (size_t q = 0; q < K; q++) {
+                    for (size_t r = 0; r < K; r++) {
+                        for (size_t s = 0; s < K; s++) {
+                            J_ref(p,q) += g(p,q,r,s) * D[i](s,r);
+                            K_ref(p,q) += g(p,r,s,q) * D[i](r,s);
+                        }
+                    }
+                }
+            }
+
+            BOOST_CHECK(J[i].isApprox(J_ref, 1.0e-12));
+            BOOST_CHECK(K_matrices[i].isApprox(K_ref, 1.0e-12));
+        }
+    }
+
+    BOOST_CHECK(g.calculateCoulomb(D[0]).isApprox(g.calculateCoulomb(D, 2)[0], 1.0e-12));
+    BOOST_CHECK(g.calculateExchange(D[1]).isApprox(g.calculateExchange(D, 2)[1], 1.0e-12));
+
+
+    // Incompatible matrices should throw
+    BOOST_CHECK_THROW(g.calculateCoulomb(GQCP::SquareMatrix<double>::Zero(K+1, K+1)), std::invalid_argument);
+    BOOST_CHECK_THROW(g.calculateExchange(GQCP::SquareMatrix<double>::Zero(K+1, K+1)), std::invalid_argument);
+}
@@ -21,6 +21,8 @@
 #include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
 
 #include "RHF/DIISRHFSCFSolver.hpp"
+#include "RHF/PlainRHFSCFSolver.hpp"
+#include "Observer/IterationHistory.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
 
 #include "utilities/linalg.hpp"
@@ -163,3 +165,49 @@ BOOST_AUTO_TEST_CASE ( h2_631gdp_DIIS ) {
     // Check the electronic energy
     BOOST_CHECK(std::abs(rhf.get_electronic_energy() - ref_electronic_energy) < 1.0e-06);
 }
+
+
+BOOST_AUTO_TEST_CASE ( h2o_sto3g_direct_DIIS ) {
+
+    // Check if an integral-direct calculation (which never stores the AO two-electron integrals) reproduces the in-core energy
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    auto mol_ham_par = GQCP::HamiltonianParameters<double>::Molecular(water, "STO-3G");
+
+    GQCP::DIISRHFSCFSolver diis_scf_solver (mol_ham_par, water);
+    diis_scf_solver.solve();
+    double ref_electronic_energy = diis_scf_solver.get_solution().get_electronic_energy();
+
+    auto ao_basis = std::make_shared<GQCP::AOBasis>(water, "STO-3G");
+    GQCP::DIISRHFSCFSolver direct_diis_scf_solver (ao_basis, water);
+    direct_diis_scf_solver.solve();
+    BOOST_CHECK(std::abs(direct_diis_scf_solver.get_solution().get_electronic_energy() - ref_electronic_energy) < 1.0e-08);
+
+    GQCP::PlainRHFSCFSolver direct_plain_scf_solver (ao_basis, water, 1.0e-08, 128, 1.0e-12, 2);
+    direct_plain_scf_solver.solve();
+    BOOST_CHECK(std::abs(direct_plain_scf_solver.get_solution().get_electronic_energy() - ref_electronic_energy) < 1.0e-08);
+}
+
+
+BOOST_AUTO_TEST_CASE ( h2o_631gdp_incremental_direct_DIIS ) {
+
+    // Check if incremental (difference-density) Fock matrix builds reproduce the energy of full builds, while skipping more shell quartets in the last iterations
+    auto water = GQCP::Molecule::Readxyz("data/h2o.xyz");
+    auto ao_basis = std::make_shared<GQCP::AOBasis>(water, "6-31G**");
+
+    GQCP::DIISRHFSCFSolver full_scf_solver (ao_basis, water, 6, 6, 1.0e-08, 128, 1.0e-12, 0, 0);
+    auto full_history = std::make_shared<GQCP::IterationHistory>();
+    full_scf_solver.attach(full_history);
+    full_scf_solver.solve();
+
+    GQCP::DIISRHFSCFSolver incremental_scf_solver (ao_basis, water, 6, 6, 1.0e-08, 128, 1.0e-12, 0, 8);
+    auto incremental_history = std::make_shared<GQCP::IterationHistory>();
+    incremental_scf_solver.attach(incremental_history);
+    incremental_scf_solver.solve();
+
+    BOOST_CHECK(std::abs(incremental_scf_solver.get_solution().get_electronic_energy() - full_scf_solver.get_solution().get_electronic_energy()) < 1.0e-08);
+
+    const auto& first_record = incremental_history->get_records().front();
+    const auto& last_record = incremental_history->get_records().back();
+    BOOST_CHECK(last_record.number_of_computed_quartets < first_record.number_of_computed_quartets);
+    BOOST_CHECK(last_record.number_of_computed_quartets < full_history->get_records().back().number_of_computed_quartets);
+}
@@ -64,3 +64,22 @@ BOOST_AUTO_TEST_CASE ( HOMO_LUMO_index ) {
     BOOST_CHECK_THROW(GQCP::RHFHOMOIndex(N+1), std::invalid_argument);
     BOOST_CHECK_THROW(GQCP::RHFLUMOIndex(K, N+1), std::invalid_argument);
 }
+
+
+BOOST_AUTO_TEST_CASE ( RHF_AO_Fock_matrix_factorized ) {
+
+    // The Fock matrix from factorized two-electron integrals should be equal to the one from their dense representation
+    size_t K = 5;
+    GQCP::MatrixX<double> B = GQCP::MatrixX<double>::Random(K*K, 8);
+    GQCP::FactorizedTwoElectronOperator g (K, B);
+
+    GQCP::OneElectronOperator<double> S = GQCP::OneElectronOperator<double>::Identity(K, K);
+    GQCP::OneElectronOperator<double> H = GQCP::OneElectronOperator<double>::Random(K, K);
+    GQCP::SquareMatrix<double> C = GQCP::SquareMatrix<double>::Identity(K, K);
+    GQCP::HamiltonianParameters<double> ham_par (nullptr, S, H, g.toDense(), C);
+
+    GQCP::SquareMatrix<double> C_random = GQCP::SquareMatrix<double>::Random(K, K);
+    auto D_AO = GQCP::calculateRHFAO1RDM(C_random, 4);
+
+    BOOST_CHECK(GQCP::calculateRHFAOFockMatrix(D_AO, H, g).isApprox(GQCP::calculateRHFAOFockMatrix(D_AO, ham_par), 1.0e-12));
+}
@@ -66,3 +66,20 @@ BOOST_AUTO_TEST_CASE ( crawdad_sto3g_methane ) {
     double energy_correction = GQCP::calculateRMP2EnergyCorrection(mol_ham_par, methane, rhf);
     BOOST_CHECK(std::abs(energy_correction - ref_energy_correction) < 1.0e-08);
 }
+
+
+BOOST_AUTO_TEST_CASE ( AO_integrals_h2o_631g ) {
+
+    // Check if the RMP2 correction from the partially transformed AO integrals is equal to the one from the fully transformed Hamiltonian parameters
+    auto ao_ham_par = GQCP::HamiltonianParameters<double>::ReadFCIDUMP("data/h2o_631g_klaas.FCIDUMP");
+    GQCP::Molecule water ({GQCP::Atom(8, 0, 0, 0), GQCP::Atom(1, 0, 0, 1), GQCP::Atom(1, 0, 1, 0)});  // only the number of electrons matters
+
+    GQCP::PlainRHFSCFSolver plain_scf_solver (ao_ham_par, water);
+    plain_scf_solver.solve();
+    auto rhf = plain_scf_solver.get_solution();
+    auto mol_ham_par = GQCP::HamiltonianParameters<double>(ao_ham_par, rhf.get_C());
+
+    double energy_correction_ref = GQCP::calculateRMP2EnergyCorrection(mol_ham_par, water, rhf);
+    double energy_correction = GQCP::calculateRMP2EnergyCorrection(ao_ham_par.get_g(), water, rhf);
+    BOOST_CHECK(std::abs(energy_correction - energy_correction_ref) < 1.0e-10);
+}
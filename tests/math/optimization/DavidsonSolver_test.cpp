@@ -22,6 +22,8 @@
 
 #include "math/optimization/DavidsonSolver.hpp"
 
+#include "Observer/IterationHistory.hpp"
+
 #include "utilities/linalg.hpp"
 
 
@@ -387,3 +389,243 @@ BOOST_AUTO_TEST_CASE ( liu_1000_number_of_requested_eigenpairs ) {
         BOOST_CHECK(std::abs(eigenpairs[i].get_eigenvector().norm() - 1) < 1.0e-12);  // check if the found eigenpairs are normalized
     }
 }
+
+
+BOOST_AUTO_TEST_CASE ( liu_1000_single_precision ) {
+
+    size_t number_of_requested_eigenpairs = 3;
+
+    // Let's prepare the Liu reference test (liu1978)
+    size_t N = 1000;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Ones(N, N);
+    for (size_t i = 0; i < N; i++) {
+        if (i < 5) {
+            A(i, i) = 1 + 0.1 * i;
+        } else {
+            A(i, i) = 2 * (i + 1) - 1;
+        }
+    }
+
+
+    // Solve the eigenvalue problem with Eigen
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    GQCP::VectorX<double> ref_lowest_eigenvalues = eigensolver.eigenvalues().head(number_of_requested_eigenpairs);
+    GQCP::MatrixX<double> ref_lowest_eigenvectors = eigensolver.eigenvectors().topLeftCorner(N, number_of_requested_eigenpairs);
+
+    std::vector<GQCP::Eigenpair> ref_eigenpairs (number_of_requested_eigenpairs);
+    for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+        ref_eigenpairs[i] = GQCP::Eigenpair(ref_lowest_eigenvalues(i), ref_lowest_eigenvectors.col(i));
+    }
+
+
+    // Solve using the Davidson diagonalization with a single-precision subspace, forcing subspace collapses
+    GQCP::MatrixX<double> X_0 = GQCP::MatrixX<double>::Identity(N, N).topLeftCorner(N, number_of_requested_eigenpairs);
+    GQCP::DavidsonSolverOptions solver_options (X_0);
+    solver_options.number_of_requested_eigenpairs = number_of_requested_eigenpairs;
+    solver_options.collapsed_subspace_dimension = number_of_requested_eigenpairs;
+    solver_options.maximum_subspace_dimension = 8;
+    solver_options.subspace_precision = GQCP::SubspacePrecision::SINGLE;
+    GQCP::DavidsonSolver davidson_solver (A, solver_options);
+    davidson_solver.solve();
+
+    std::vector<GQCP::Eigenpair> eigenpairs = davidson_solver.get_eigenpairs();
+
+
+    // The double-precision refinement should recover the full accuracy
+    for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+        BOOST_CHECK(eigenpairs[i].isEqual(ref_eigenpairs[i]));
+        BOOST_CHECK(std::abs(eigenpairs[i].get_eigenvector().norm() - 1) < 1.0e-12);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_1000_single_precision_footprint ) {
+
+    size_t number_of_requested_eigenpairs = 3;
+
+    // Let's prepare the Liu reference test (liu1978)
+    size_t N = 1000;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Ones(N, N);
+    for (size_t i = 0; i < N; i++) {
+        if (i < 5) {
+            A(i, i) = 1 + 0.1 * i;
+        } else {
+            A(i, i) = 2 * (i + 1) - 1;
+        }
+    }
+
+
+    // Solve using the Davidson diagonalization with a single-precision subspace and a large maximum subspace dimension, recording every iteration
+    size_t maximum_subspace_dimension = 200;
+    GQCP::MatrixX<double> X_0 = GQCP::MatrixX<double>::Identity(N, N).topLeftCorner(N, number_of_requested_eigenpairs);
+    auto history = std::make_shared<GQCP::IterationHistory>();
+
+    GQCP::DavidsonSolverOptions solver_options (X_0);
+    solver_options.number_of_requested_eigenpairs = number_of_requested_eigenpairs;
+    solver_options.collapsed_subspace_dimension = number_of_requested_eigenpairs;
+    solver_options.maximum_subspace_dimension = maximum_subspace_dimension;
+    solver_options.subspace_precision = GQCP::SubspacePrecision::SINGLE;
+    solver_options.observers.push_back(history);
+    GQCP::DavidsonSolver davidson_solver (A, solver_options);
+    davidson_solver.solve();
+
+
+    // Neither the single-precision iterations nor the double-precision refinement should allocate the subspace at its full capacity, but only the columns that are used
+    size_t peak_bytes = 0;
+    size_t peak_subspace_dimension = 0;
+    for (const auto& record : history->get_records()) {
+        peak_bytes = std::max(peak_bytes, record.allocated_bytes);
+        peak_subspace_dimension = std::max(peak_subspace_dimension, record.subspace_dimension);
+    }
+
+    BOOST_CHECK(peak_subspace_dimension < maximum_subspace_dimension);
+    BOOST_CHECK(peak_bytes <= (2 * peak_subspace_dimension + 3 * number_of_requested_eigenpairs) * N * sizeof(double));
+    BOOST_CHECK(peak_bytes < 2 * maximum_subspace_dimension * N * sizeof(double) / 4);
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_1000_memory_mapped ) {
+
+    size_t number_of_requested_eigenpairs = 3;
+
+    // Let's prepare the Liu reference test (liu1978)
+    size_t N = 1000;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Ones(N, N);
+    for (size_t i = 0; i < N; i++) {
+        if (i < 5) {
+            A(i, i) = 1 + 0.1 * i;
+        } else {
+            A(i, i) = 2 * (i + 1) - 1;
+        }
+    }
+
+
+    // Solve the eigenvalue problem with Eigen
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    GQCP::VectorX<double> ref_lowest_eigenvalues = eigensolver.eigenvalues().head(number_of_requested_eigenpairs);
+    GQCP::MatrixX<double> ref_lowest_eigenvectors = eigensolver.eigenvectors().topLeftCorner(N, number_of_requested_eigenpairs);
+
+    std::vector<GQCP::Eigenpair> ref_eigenpairs (number_of_requested_eigenpairs);
+    for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+        ref_eigenpairs[i] = GQCP::Eigenpair(ref_lowest_eigenvalues(i), ref_lowest_eigenvectors.col(i));
+    }
+
+
+    // Solve using the Davidson diagonalization with a memory-mapped subspace, forcing subspace collapses
+    GQCP::MatrixX<double> X_0 = GQCP::MatrixX<double>::Identity(N, N).topLeftCorner(N, number_of_requested_eigenpairs);
+    GQCP::DavidsonSolverOptions solver_options (X_0);
+    solver_options.number_of_requested_eigenpairs = number_of_requested_eigenpairs;
+    solver_options.collapsed_subspace_dimension = number_of_requested_eigenpairs;
+    solver_options.maximum_subspace_dimension = 8;
+    solver_options.subspace_storage = GQCP::SubspaceStorage::MEMORY_MAPPED;
+    GQCP::DavidsonSolver davidson_solver (A, solver_options);
+    davidson_solver.solve();
+
+    std::vector<GQCP::Eigenpair> eigenpairs = davidson_solver.get_eigenpairs();
+
+
+    // The memory-mapped subspace should give the same results as the in-core one
+    for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+        BOOST_CHECK(eigenpairs[i].isEqual(ref_eigenpairs[i]));
+        BOOST_CHECK(std::abs(eigenpairs[i].get_eigenvector().norm() - 1) < 1.0e-12);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_50_initial_guesses_below_collapsed_dimension ) {
+
+    size_t number_of_requested_eigenpairs = 4;
+
+    // Let's prepare the Liu reference test (liu1978)
+    size_t N = 50;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Ones(N, N);
+    for (size_t i = 0; i < N; i++) {
+        if (i < 5) {
+            A(i, i) = 1 + 0.1 * i;
+        } else {
+            A(i, i) = 2 * (i + 1) - 1;
+        }
+    }
+
+
+    // Solve the eigenvalue problem with Eigen
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    GQCP::VectorX<double> ref_lowest_eigenvalues = eigensolver.eigenvalues().head(number_of_requested_eigenpairs);
+    GQCP::MatrixX<double> ref_lowest_eigenvectors = eigensolver.eigenvectors().topLeftCorner(N, number_of_requested_eigenpairs);
+
+    std::vector<GQCP::Eigenpair> ref_eigenpairs (number_of_requested_eigenpairs);
+    for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+        ref_eigenpairs[i] = GQCP::Eigenpair(ref_lowest_eigenvalues(i), ref_lowest_eigenvectors.col(i));
+    }
+
+
+    // The 7 initial guesses and the 4 correction vectors exceed the maximum subspace dimension, while the subspace is still smaller than the collapsed dimension
+    GQCP::MatrixX<double> X_0 = GQCP::MatrixX<double>::Identity(N, N).topLeftCorner(N, 7);
+    for (const auto& precision : {GQCP::SubspacePrecision::DOUBLE, GQCP::SubspacePrecision::SINGLE}) {
+        GQCP::DavidsonSolverOptions solver_options (X_0);
+        solver_options.number_of_requested_eigenpairs = number_of_requested_eigenpairs;
+        solver_options.maximum_subspace_dimension = 10;
+        solver_options.collapsed_subspace_dimension = 8;
+        solver_options.subspace_precision = precision;
+        GQCP::DavidsonSolver davidson_solver (A, solver_options);
+        davidson_solver.solve();
+
+        std::vector<GQCP::Eigenpair> eigenpairs = davidson_solver.get_eigenpairs();
+        for (size_t i = 0; i < number_of_requested_eigenpairs; i++) {
+            BOOST_CHECK(eigenpairs[i].isEqual(ref_eigenpairs[i]));
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_50_observer ) {
+
+    // Let's prepare the Liu reference test (liu1978)
+    size_t N = 50;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Ones(N, N);
+    for (size_t i = 0; i < N; i++) {
+        if (i < 5) {
+            A(i, i) = 1 + 0.1 * i;
+        } else {
+            A(i, i) = 2 * (i + 1) - 1;
+        }
+    }
+
+
+    // Solve using the Davidson diagonalization, forcing subspace collapses and recording every iteration
+    GQCP::VectorX<double> x_0 = GQCP::VectorX<double>::Zero(N);
+    x_0(0) = 1;
+    auto history = std::make_shared<GQCP::IterationHistory>();
+
+    GQCP::DavidsonSolverOptions solver_options (x_0);
+    solver_options.maximum_subspace_dimension = 4;
+    solver_options.observers.push_back(history);
+    GQCP::DavidsonSolver davidson_solver (A, solver_options);
+    davidson_solver.solve();
+
+    const auto& records = history->get_records();
+    BOOST_CHECK_EQUAL(records.size(), davidson_solver.get_number_of_iterations() + 1);  // the converged iteration is also reported
+
+    size_t number_of_matvecs = 0;
+    bool collapsed = false;
+    for (size_t i = 0; i < records.size(); i++) {
+        BOOST_CHECK_EQUAL(records[i].iteration, i);
+        BOOST_CHECK_EQUAL(records[i].residual_norms.size(), 1);
+        BOOST_CHECK(records[i].subspace_dimension <= 4);
+        number_of_matvecs += records[i].number_of_matvecs;
+        collapsed = collapsed || records[i].collapsed;
+    }
+    BOOST_CHECK(collapsed);
+    BOOST_CHECK(number_of_matvecs >= records.size());
+    BOOST_CHECK(records.back().residual_norms[0] < 1.0e-08);
+    BOOST_CHECK(std::abs(records.back().eigenvalues[0] - davidson_solver.get_eigenvalue()) < 1.0e-12);
+
+
+    // The diagnostics should survive a solver that doesn't converge
+    auto failed_history = std::make_shared<GQCP::IterationHistory>();
+    solver_options.observers = {failed_history};
+    solver_options.maximum_number_of_iterations = 2;
+    GQCP::DavidsonSolver failing_solver (A, solver_options);
+    BOOST_CHECK_THROW(failing_solver.solve(), std::runtime_error);
+    BOOST_CHECK_EQUAL(failed_history->get_records().size(), 2);
+}
@@ -0,0 +1,122 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "DavidsonSubspace"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+#include "math/optimization/DavidsonSubspace.hpp"
+
+
+
+BOOST_AUTO_TEST_CASE ( append ) {
+
+    GQCP::DavidsonSubspace V (3, 2);
+    BOOST_CHECK(V.cols() == 0);
+    BOOST_CHECK(!V.is_memory_mapped());
+
+    GQCP::VectorX<double> v (3);
+    v << 1, 2, 3;
+    V.append(v);
+    BOOST_CHECK(V.cols() == 1);
+    BOOST_CHECK(V.column(0).isApprox(v));
+
+    BOOST_CHECK_THROW(V.column(1), std::invalid_argument);  // only one column is stored
+    BOOST_CHECK_THROW(V.append(GQCP::VectorX<double>::Zero(2)), std::invalid_argument);  // incompatible dimension
+
+    V.append(v, 2.0);
+    BOOST_CHECK(V.column(1).isApprox(2 * v));
+    BOOST_CHECK_THROW(V.append(v), std::invalid_argument);  // the capacity is 2
+}
+
+
+BOOST_AUTO_TEST_CASE ( allocated_bytes ) {
+
+    // Only the columns that have been stored should occupy memory, not the full capacity
+    for (const auto& storage : {GQCP::SubspaceStorage::IN_CORE, GQCP::SubspaceStorage::MEMORY_MAPPED}) {
+        GQCP::DavidsonSubspace V (1000, 100, storage);
+        BOOST_CHECK_EQUAL(V.allocated_bytes(), 0);
+
+        GQCP::VectorX<double> v = GQCP::VectorX<double>::Random(1000);
+        V.append(v);
+        V.append(v);
+        BOOST_CHECK_EQUAL(V.allocated_bytes(), 2 * 1000 * sizeof(double));
+
+        // Clearing keeps the storage, which is reused for new columns
+        V.clear();
+        V.append(v);
+        BOOST_CHECK_EQUAL(V.allocated_bytes(), 2 * 1000 * sizeof(double));
+        BOOST_CHECK(V.column(0).isApprox(v));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( memory_mapped_throws ) {
+
+    BOOST_CHECK_THROW(GQCP::DavidsonSubspace (3, 2, GQCP::SubspaceStorage::MEMORY_MAPPED, "/this/directory/does/not/exist"), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_CASE ( products_and_collapse ) {
+
+    // Use a dimension that isn't a multiple of the number of rows that is streamed at once
+    size_t dim = 100003;
+    size_t m = 5;
+    GQCP::MatrixX<double> A = GQCP::MatrixX<double>::Random(dim, m);
+    GQCP::VectorX<double> w = GQCP::VectorX<double>::Random(dim);
+    GQCP::MatrixX<double> Z = GQCP::MatrixX<double>::Random(m, 2);
+
+
+    // Check the kernels for both the in-core and the memory-mapped storage
+    for (const auto& storage : {GQCP::SubspaceStorage::IN_CORE, GQCP::SubspaceStorage::MEMORY_MAPPED}) {
+        GQCP::DavidsonSubspace V (dim, m, storage);
+        for (size_t j = 0; j < m; j++) {
+            V.append(A.col(j));
+        }
+
+        BOOST_CHECK(V.is_memory_mapped() == (storage == GQCP::SubspaceStorage::MEMORY_MAPPED));
+        BOOST_CHECK(V.matrix().isApprox(A, 1.0e-12));
+        BOOST_CHECK(V.transposeMultiply(w).isApprox(A.transpose() * w, 1.0e-12));
+        BOOST_CHECK(V.multiply(Z).isApprox(A * Z, 1.0e-12));
+
+
+        // Check the non-allocating kernels
+        GQCP::VectorX<double> v (dim);
+        V.column(2, v);
+        BOOST_CHECK(v.isApprox(A.col(2), 1.0e-12));
+
+        GQCP::VectorX<double> h (m);
+        V.transposeMultiply(w, h);
+        BOOST_CHECK(h.isApprox(A.transpose() * w, 1.0e-12));
+
+        V.multiply(h.head(3), v);  // only the first three columns
+        BOOST_CHECK(v.isApprox(A.leftCols(3) * h.head(3), 1.0e-12));
+
+        GQCP::VectorX<double> w_subtracted = w;
+        V.subtractProduct(h, w_subtracted);
+        BOOST_CHECK(w_subtracted.isApprox(w - A * h, 1.0e-12));
+
+        BOOST_CHECK_THROW(V.transposeMultiply(w, h.head(3)), std::invalid_argument);  // the result should hold one element per column
+        BOOST_CHECK_THROW(V.multiply(GQCP::VectorX<double>::Zero(m + 1), v), std::invalid_argument);  // too many coefficients
+
+        V.collapse(Z);
+        BOOST_CHECK(V.cols() == 2);
+        BOOST_CHECK(V.matrix().isApprox(A * Z, 1.0e-12));
+    }
+}
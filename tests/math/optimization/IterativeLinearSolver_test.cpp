@@ -0,0 +1,173 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "IterativeLinearSolver"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+#include "math/optimization/IterativeLinearSolver.hpp"
+
+#include "Observer/IterationHistory.hpp"
+
+
+/**
+ *  @param N        the dimension of the matrix
+ *
+ *  @return the symmetric, diagonally dominant matrix of the Liu reference test (liu1978)
+ */
+GQCP::SquareMatrix<double> liuMatrix(size_t N) {
+
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Ones(N, N);
+    for (size_t i = 0; i < N; i++) {
+        if (i < 5) {
+            A(i, i) = 1 + 0.1 * i;
+        } else {
+            A(i, i) = 2 * (i + 1) - 1;
+        }
+    }
+
+    return A;
+}
+
+
+BOOST_AUTO_TEST_CASE ( constructor ) {
+
+    GQCP::SquareMatrix<double> A = liuMatrix(10);
+
+    BOOST_CHECK_NO_THROW(GQCP::IterativeLinearSolver solver (A));
+    BOOST_CHECK_THROW(GQCP::IterativeLinearSolver solver (A, 0.0, GQCP::VectorX<double>::Ones(9)), std::invalid_argument);  // incompatible reference
+    BOOST_CHECK_THROW(GQCP::IterativeLinearSolver solver (A, 0.0, GQCP::VectorX<double>::Zero(10)), std::invalid_argument);  // zero reference
+    BOOST_CHECK_THROW(GQCP::IterativeLinearSolver solver (A, 0.0, GQCP::VectorX<double>(), GQCP::KrylovMethod::GMRES, 1.0e-08, 128, 0), std::invalid_argument);  // zero restart dimension
+
+    GQCP::IterativeLinearSolver solver (A);
+    BOOST_CHECK_THROW(solver.get_solutions(), std::logic_error);  // not solved yet
+    BOOST_CHECK_THROW(solver.solve(GQCP::VectorX<double>::Ones(9)), std::invalid_argument);  // incompatible right-hand side
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_200_multiple_right_hand_sides ) {
+
+    // Solve (A - shift) X = B for a positive definite A - shift and three right-hand sides with every Krylov method
+    size_t N = 200;
+    GQCP::SquareMatrix<double> A = liuMatrix(N);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    double shift = eigensolver.eigenvalues()(0) - 0.5;
+
+    GQCP::MatrixX<double> B = GQCP::MatrixX<double>::Random(N, 3);
+    GQCP::MatrixX<double> X_ref = (A - shift * GQCP::SquareMatrix<double>::Identity(N, N)).ldlt().solve(B);
+
+    for (const auto method : {GQCP::KrylovMethod::CG, GQCP::KrylovMethod::MINRES, GQCP::KrylovMethod::GMRES}) {
+        GQCP::IterativeLinearSolver solver (A, shift, GQCP::VectorX<double>(), method, 1.0e-10);
+        solver.solve(B);
+
+        BOOST_CHECK(solver.get_solutions().isApprox(X_ref, 1.0e-08));
+        BOOST_CHECK_EQUAL(solver.get_number_of_iterations().size(), 3);
+        BOOST_CHECK(solver.get_solution(2).isApprox(X_ref.col(2), 1.0e-08));
+        BOOST_CHECK_THROW(solver.get_solution(3), std::invalid_argument);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_200_indefinite ) {
+
+    // Solve (A - shift) x = b for a shift between the eigenvalues of A, which requires MINRES or GMRES
+    size_t N = 200;
+    GQCP::SquareMatrix<double> A = liuMatrix(N);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    double shift = 0.5 * (eigensolver.eigenvalues()(2) + eigensolver.eigenvalues()(3));
+
+    GQCP::VectorX<double> b = GQCP::VectorX<double>::Random(N);
+    GQCP::VectorX<double> x_ref = (A - shift * GQCP::SquareMatrix<double>::Identity(N, N)).lu().solve(b);
+
+    for (const auto method : {GQCP::KrylovMethod::MINRES, GQCP::KrylovMethod::GMRES}) {
+        GQCP::IterativeLinearSolver solver (A, shift, GQCP::VectorX<double>(), method, 1.0e-10, 256);
+        solver.solve(b);
+
+        BOOST_CHECK(solver.get_solution().isApprox(x_ref, 1.0e-08));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_200_reference_projection ) {
+
+    // Solve (A - E_0) x = b in the orthogonal complement of the lowest eigenvector c, and compare with the spectral solution
+    size_t N = 200;
+    GQCP::SquareMatrix<double> A = liuMatrix(N);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    double E_0 = eigensolver.eigenvalues()(0);
+    GQCP::VectorX<double> c = eigensolver.eigenvectors().col(0);
+
+    GQCP::VectorX<double> b = GQCP::VectorX<double>::Random(N);
+    GQCP::VectorX<double> x_ref = GQCP::VectorX<double>::Zero(N);
+    for (size_t k = 1; k < N; k++) {
+        const auto& u = eigensolver.eigenvectors().col(k);
+        x_ref += (u.dot(b) / (eigensolver.eigenvalues()(k) - E_0)) * u;
+    }
+
+    for (const auto method : {GQCP::KrylovMethod::CG, GQCP::KrylovMethod::MINRES, GQCP::KrylovMethod::GMRES}) {
+        GQCP::IterativeLinearSolver solver (A, E_0, c, method, 1.0e-10);
+        solver.solve(b);
+
+        BOOST_CHECK(solver.get_solution().isApprox(x_ref, 1.0e-08));
+        BOOST_CHECK(std::abs(solver.get_solution().dot(c)) < 1.0e-10);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( liu_200_GMRES_restart_memory_mapped ) {
+
+    // Force restarts of GMRES with a small restart dimension, with the Krylov vectors in a memory-mapped scratch file (restarted GMRES may stagnate for indefinite systems, so we use a positive definite one)
+    size_t N = 200;
+    GQCP::SquareMatrix<double> A = liuMatrix(N);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (A);
+    double shift = eigensolver.eigenvalues()(0) - 0.5;
+
+    GQCP::VectorX<double> b = GQCP::VectorX<double>::Random(N);
+    GQCP::VectorX<double> x_ref = (A - shift * GQCP::SquareMatrix<double>::Identity(N, N)).lu().solve(b);
+
+    auto history = std::make_shared<GQCP::IterationHistory>();
+    GQCP::IterativeLinearSolver solver (A, shift, GQCP::VectorX<double>(), GQCP::KrylovMethod::GMRES, 1.0e-10, 256, 4, GQCP::SubspaceStorage::MEMORY_MAPPED);
+    solver.attach(history);
+    solver.solve(b);
+
+    BOOST_CHECK(solver.get_solution().isApprox(x_ref, 1.0e-08));
+
+    const auto& records = history->get_records();
+    BOOST_CHECK_EQUAL(records.size(), solver.get_number_of_iterations()[0]);
+    BOOST_CHECK(records.size() > 4);  // at least one restart was needed
+    for (size_t i = 0; i < records.size(); i++) {
+        BOOST_CHECK_EQUAL(records[i].solver, "IterativeLinearSolver::GMRES");
+        BOOST_CHECK_EQUAL(records[i].iteration, i);
+        BOOST_CHECK(records[i].subspace_dimension <= 4);
+        BOOST_CHECK(records[i].number_of_matvecs >= 1);
+    }
+    BOOST_CHECK(records.back().residual_norms[0] < 1.0e-10);
+}
+
+
+BOOST_AUTO_TEST_CASE ( not_converged ) {
+
+    size_t N = 200;
+    GQCP::SquareMatrix<double> A = liuMatrix(N);
+    GQCP::VectorX<double> b = GQCP::VectorX<double>::Random(N);
+
+    for (const auto method : {GQCP::KrylovMethod::CG, GQCP::KrylovMethod::MINRES, GQCP::KrylovMethod::GMRES}) {
+        GQCP::IterativeLinearSolver solver (A, 0.0, GQCP::VectorX<double>(), method, 1.0e-10, 2);
+        BOOST_CHECK_THROW(solver.solve(b), std::runtime_error);
+    }
+}
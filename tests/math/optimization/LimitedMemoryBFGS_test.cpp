@@ -0,0 +1,134 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "LimitedMemoryBFGS"
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+#include "math/optimization/LimitedMemoryBFGS.hpp"
+#include "math/SquareMatrix.hpp"
+
+
+
+/*
+ *  BOOST UNIT TESTS
+ */
+
+BOOST_AUTO_TEST_CASE ( constructor ) {
+
+    BOOST_CHECK_NO_THROW(GQCP::LimitedMemoryBFGS (1));
+    BOOST_CHECK_THROW(GQCP::LimitedMemoryBFGS (0), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( update ) {
+
+    GQCP::LimitedMemoryBFGS lbfgs (2);
+
+    GQCP::VectorX<double> s (2);
+    s << 1.0, 0.0;
+    GQCP::VectorX<double> y (2);
+    y << 2.0, 1.0;
+
+
+    // Pairs with a non-positive curvature are skipped
+    BOOST_CHECK(!lbfgs.update(s, -y));
+    BOOST_CHECK_EQUAL(lbfgs.size(), 0);
+
+
+    // When the history is full, the oldest pair is discarded
+    BOOST_CHECK(lbfgs.update(s, y));
+    BOOST_CHECK(lbfgs.update(s, y));
+    BOOST_CHECK(lbfgs.update(s, y));
+    BOOST_CHECK_EQUAL(lbfgs.size(), 2);
+
+    BOOST_CHECK_THROW(lbfgs.update(s, GQCP::VectorX<double>::Ones(3)), std::invalid_argument);
+
+    lbfgs.clear();
+    BOOST_CHECK_EQUAL(lbfgs.size(), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE ( inverseHessianProduct ) {
+
+    GQCP::LimitedMemoryBFGS lbfgs (4);
+    GQCP::VectorX<double> v (3);
+    v << 1.0, -2.0, 0.5;
+    GQCP::VectorX<double> diagonal (3);
+    diagonal << 2.0, 4.0, 1.0;
+
+
+    // Without any pairs, the initial Hessian is inverted
+    BOOST_CHECK(lbfgs.inverseHessianProduct(v, diagonal).isApprox(v.cwiseQuotient(diagonal), 1.0e-12));
+    BOOST_CHECK(lbfgs.inverseHessianProduct(v).isApprox(v, 1.0e-12));
+
+
+    // The approximate inverse Hessian satisfies the secant equation H y = s for the most recent pair, and stays positive definite
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Zero(3, 3);
+    A << 4.0, 1.0, 0.0,
+         1.0, 3.0, 0.5,
+         0.0, 0.5, 2.0;
+
+    GQCP::VectorX<double> s1 (3);
+    s1 << 1.0, 0.0, 1.0;
+    GQCP::VectorX<double> s2 (3);
+    s2 << 0.0, 1.0, -1.0;
+    lbfgs.update(s1, A * s1);
+    lbfgs.update(s2, A * s2);
+
+    BOOST_CHECK(lbfgs.inverseHessianProduct(A * s2, diagonal).isApprox(s2, 1.0e-12));
+    BOOST_CHECK(lbfgs.inverseHessianProduct(A * s2).isApprox(s2, 1.0e-12));
+    BOOST_CHECK(v.dot(lbfgs.inverseHessianProduct(v, diagonal)) > 0.0);
+
+    BOOST_CHECK_THROW(lbfgs.inverseHessianProduct(GQCP::VectorX<double>::Ones(2), GQCP::VectorX<double>::Ones(2)), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( minimize_quadratic ) {
+
+    // Minimize f(x) = 1/2 x^T A x + b^T x with unit L-BFGS steps, starting from the diagonal of A
+    size_t dim = 10;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Zero(dim, dim);
+    for (size_t i = 0; i < dim; i++) {
+        A(i,i) = 2.0 + i;
+        if (i > 0) {
+            A(i,i-1) = 0.5;
+            A(i-1,i) = 0.5;
+        }
+    }
+    GQCP::VectorX<double> b = GQCP::VectorX<double>::Ones(dim);
+    GQCP::VectorX<double> diagonal = A.diagonal();
+
+    GQCP::LimitedMemoryBFGS lbfgs (5);
+    GQCP::VectorX<double> x = GQCP::VectorX<double>::Zero(dim);
+    GQCP::VectorX<double> gradient = A * x + b;
+
+    size_t iterations = 0;
+    while ((gradient.norm() > 1.0e-10) && (iterations < 50)) {
+        GQCP::VectorX<double> step = -lbfgs.inverseHessianProduct(gradient, diagonal);
+        x += step;
+
+        GQCP::VectorX<double> new_gradient = A * x + b;
+        lbfgs.update(step, new_gradient - gradient);
+        gradient = new_gradient;
+        iterations++;
+    }
+
+    BOOST_CHECK(iterations < 50);
+    BOOST_CHECK(x.isApprox(A.ldlt().solve(-b), 1.0e-08));
+}
@@ -0,0 +1,98 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2019  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "step"
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+#include "math/optimization/step.hpp"
+#include "math/SquareMatrix.hpp"
+
+#include <Eigen/Eigenvalues>
+
+
+
+/*
+ *  BOOST UNIT TESTS
+ */
+
+BOOST_AUTO_TEST_CASE ( trustRegionNewtonStep_positive_definite ) {
+
+    // Set up a positive definite quadratic model
+    GQCP::SquareMatrix<double> H = GQCP::SquareMatrix<double>::Zero(3, 3);
+    H << 4.0, 1.0, 0.0,
+         1.0, 3.0, 0.5,
+         0.0, 0.5, 2.0;
+    GQCP::VectorX<double> g (3);
+    g << 1.0, -2.0, 0.5;
+
+    GQCP::VectorFunction hessian_vector_product = [&H] (const GQCP::VectorX<double>& x) { return GQCP::VectorX<double>(H * x); };
+    GQCP::VectorX<double> newton_step = H.ldlt().solve(-g);
+
+
+    // Inside a large trust region, the step is the Newton step
+    double predicted_change;
+    auto p = GQCP::trustRegionNewtonStep(g, hessian_vector_product, 10.0, predicted_change, 1.0e-12);
+    BOOST_CHECK(p.isApprox(newton_step, 1.0e-10));
+    BOOST_CHECK(std::abs(predicted_change - (g.dot(p) + 0.5 * p.dot(H * p))) < 1.0e-12);
+
+
+    // Inside a small trust region, the step ends on the boundary and still decreases the model
+    double radius = 0.1 * newton_step.norm();
+    p = GQCP::trustRegionNewtonStep(g, hessian_vector_product, radius, predicted_change);
+    BOOST_CHECK(std::abs(p.norm() - radius) < 1.0e-12);
+    BOOST_CHECK(predicted_change < 0.0);
+}
+
+
+BOOST_AUTO_TEST_CASE ( trustRegionNewtonStep_negative_curvature ) {
+
+    // For an indefinite quadratic model, the step should go to the boundary of the trust region
+    GQCP::SquareMatrix<double> H = GQCP::SquareMatrix<double>::Zero(2, 2);
+    H << -1.0, 0.0,
+          0.0, 2.0;
+    GQCP::VectorX<double> g (2);
+    g << 0.5, 0.5;
+
+    GQCP::VectorFunction hessian_vector_product = [&H] (const GQCP::VectorX<double>& x) { return GQCP::VectorX<double>(H * x); };
+
+    double predicted_change;
+    auto p = GQCP::trustRegionNewtonStep(g, hessian_vector_product, 1.0, predicted_change);
+    BOOST_CHECK(std::abs(p.norm() - 1.0) < 1.0e-12);
+    BOOST_CHECK(predicted_change < 0.0);
+
+    BOOST_CHECK_THROW(GQCP::trustRegionNewtonStep(g, hessian_vector_product, 0.0, predicted_change), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( lanczosLowestEigenpair ) {
+
+    // Check the Lanczos estimate for the lowest eigenpair of a random symmetric matrix
+    const size_t dim = 50;
+    GQCP::SquareMatrix<double> A = GQCP::SquareMatrix<double>::Random(dim, dim);
+    GQCP::SquareMatrix<double> A_symmetric = A + A.transpose();
+
+    GQCP::VectorFunction matrix_vector_product = [&A_symmetric] (const GQCP::VectorX<double>& x) { return GQCP::VectorX<double>(A_symmetric * x); };
+    auto eigenpair = GQCP::lanczosLowestEigenpair(matrix_vector_product, GQCP::VectorX<double>::Ones(dim), 1.0e-10, dim);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver (A_symmetric);
+    BOOST_CHECK(std::abs(eigenpair.get_eigenvalue() - solver.eigenvalues()(0)) < 1.0e-08);
+    BOOST_CHECK((A_symmetric * eigenpair.get_eigenvector() - eigenpair.get_eigenvalue() * eigenpair.get_eigenvector()).norm() < 1.0e-08);
+
+    BOOST_CHECK_THROW(GQCP::lanczosLowestEigenpair(matrix_vector_product, GQCP::VectorX<double>::Zero(dim)), std::invalid_argument);
+}
@@ -22,6 +22,10 @@
 
 #include "utilities/miscellaneous.hpp"
 
+#include <array>
+#include <atomic>
+#include <stdexcept>
+
 
 BOOST_AUTO_TEST_CASE ( gray_code ) {
 
@@ -104,3 +108,29 @@ BOOST_AUTO_TEST_CASE ( sandbox ) {
                                                         {1, 1, 1, 1, 1}};
     BOOST_CHECK(GQCP::uniquePartitions<5>(5) == ref_partitions4);
 }
+
+
+BOOST_AUTO_TEST_CASE ( parallelFor ) {
+
+    // Every element of the range should be visited exactly once, for any number of threads
+    for (size_t number_of_threads : {0, 1, 3, 20}) {
+        std::vector<std::atomic<size_t>> visits (17);
+        for (auto& visit : visits) {
+            visit = 0;
+        }
+
+        GQCP::parallelFor(visits.size(), number_of_threads, [&visits] (size_t start, size_t end) {
+            for (size_t i = start; i < end; i++) {
+                visits[i]++;
+            }
+        });
+
+        for (const auto& visit : visits) {
+            BOOST_CHECK_EQUAL(visit, 1);
+        }
+    }
+
+
+    // An exception in one of the blocks should be rethrown in the calling thread
+    BOOST_CHECK_THROW(GQCP::parallelFor(10, 4, [] (size_t start, size_t end) { if (start == 0) { throw std::runtime_error("first block"); } }), std::runtime_error);
+}